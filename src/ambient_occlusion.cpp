@@ -0,0 +1,175 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: No occlusion if all radii are 0.
+ * @date 2026/10/18: Occlusion runs on the shared thread pool.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "ambient_occlusion.h"
+#include "thread_pool.h"
+#include "tools.h"
+
+#include <math.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+/// upper limit of grid cells per dimension
+#define AO_MAX_GRID_DIM 256
+
+/**
+ * Uniform grid over sphere centers (counting sort of sphere indices by cell).
+ */
+struct AOGrid
+{
+  float origin[3];
+  float cell_size;
+  int dim[3];
+  std::vector<unsigned> cell_start; // dim^3+1 entries
+  std::vector<unsigned> indices;    // sphere indices sorted by cell
+
+  int cellCoord(float v, int axis) const
+  {
+    int c = (int) ((v - origin[axis]) / cell_size);
+    return std::min(std::max(c, 0), dim[axis] - 1);
+  }
+  unsigned cellIndex(int x, int y, int z) const
+  {
+    return (unsigned) ((z * dim[1] + y) * dim[0] + x);
+  }
+};
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+static void buildGrid(AOGrid* grid, const float* positions, unsigned pos_stride,
+                      unsigned count, float cell_size)
+{
+  float bmin[3] = { positions[0], positions[1], positions[2] };
+  float bmax[3] = { positions[0], positions[1], positions[2] };
+  for (unsigned i = 1; i < count; ++i)
+  {
+    const float* p = positions + i * pos_stride;
+    for (int k = 0; k < 3; ++k)
+    {
+      bmin[k] = std::min(bmin[k], p[k]);
+      bmax[k] = std::max(bmax[k], p[k]);
+    }
+  }
+  // enlarge cells if the grid would become too large
+  for (int k = 0; k < 3; ++k)
+    cell_size = std::max(cell_size, (bmax[k] - bmin[k]) / AO_MAX_GRID_DIM);
+
+  grid->cell_size = cell_size;
+  for (int k = 0; k < 3; ++k)
+  {
+    grid->origin[k] = bmin[k];
+    grid->dim[k] = std::max(1, (int) ceil((bmax[k] - bmin[k]) / cell_size));
+  }
+  unsigned ncells = grid->dim[0] * grid->dim[1] * grid->dim[2];
+
+  std::vector<unsigned> cell_of(count);
+  grid->cell_start.assign(ncells + 1, 0);
+  for (unsigned i = 0; i < count; ++i)
+  {
+    const float* p = positions + i * pos_stride;
+    cell_of[i] = grid->cellIndex(grid->cellCoord(p[0], 0),
+                                 grid->cellCoord(p[1], 1),
+                                 grid->cellCoord(p[2], 2));
+    ++grid->cell_start[cell_of[i] + 1];
+  }
+  for (unsigned c = 0; c < ncells; ++c)
+    grid->cell_start[c + 1] += grid->cell_start[c];
+
+  std::vector<unsigned> fill(grid->cell_start.begin(), grid->cell_start.end() - 1);
+  grid->indices.resize(count);
+  for (unsigned i = 0; i < count; ++i)
+    grid->indices[fill[cell_of[i]]++] = i;
+}
+//-----------------------------------------------------------------------------
+// occlusion of spheres [first,last)
+//-----------------------------------------------------------------------------
+static void occludeRange(const AOGrid& grid,
+                         const float* positions, unsigned pos_stride,
+                         const float* radii, unsigned radius_stride,
+                         float* ao, unsigned ao_stride,
+                         float search, unsigned first, unsigned last)
+{
+  const float search2 = search * search;
+  for (unsigned i = first; i < last; ++i)
+  {
+    const float* p = positions + i * pos_stride;
+    const int cx = grid.cellCoord(p[0], 0);
+    const int cy = grid.cellCoord(p[1], 1);
+    const int cz = grid.cellCoord(p[2], 2);
+    float occlusion = 0.0f;
+
+    for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, grid.dim[2] - 1); ++z)
+    for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, grid.dim[1] - 1); ++y)
+    for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, grid.dim[0] - 1); ++x)
+    {
+      unsigned c = grid.cellIndex(x, y, z);
+      for (unsigned n = grid.cell_start[c]; n < grid.cell_start[c + 1]; ++n)
+      {
+        unsigned j = grid.indices[n];
+        if (j == i)
+          continue;
+        const float* q = positions + j * pos_stride;
+        float dx = q[0] - p[0], dy = q[1] - p[1], dz = q[2] - p[2];
+        float d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 >= search2)
+          continue;
+        float rj = radii[j * radius_stride];
+        // fraction of the full sphere of directions covered by neighbour j
+        float s2 = d2 > rj * rj ? rj * rj / d2 : 1.0f;
+        float solid_angle = 0.5f * (1.0f - sqrtf(1.0f - s2));
+        occlusion += solid_angle * (1.0f - sqrtf(d2) / search);
+      }
+    }
+    float v = 1.0f - AO_STRENGTH * occlusion;
+    ao[i * ao_stride] = std::min(std::max(v, AO_MINIMUM), 1.0f);
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void computeAmbientOcclusion(const float* positions, unsigned pos_stride,
+                             const float* radii, unsigned radius_stride,
+                             float* ao, unsigned ao_stride,
+                             unsigned count)
+{
+#ifdef NO_AMBIENT_OCCLUSION
+  for (unsigned i = 0; i < count; ++i)
+    ao[i * ao_stride] = 1.0f;
+#else
+  if (count == 0)
+    return;
+
+  float max_radius = 0.0f;
+  for (unsigned i = 0; i < count; ++i)
+    max_radius = std::max(max_radius, radii[i * radius_stride]);
+  // points occlude nothing, and the grid needs cells of positive size
+  if (!(max_radius > 0.0f))
+  {
+    for (unsigned i = 0; i < count; ++i)
+      ao[i * ao_stride] = 1.0f;
+    return;
+  }
+  timerStart();
+
+  // cells are at least as large as the search radius
+  const float search = AO_INFLUENCE_SCALE * max_radius;
+  AOGrid grid;
+  buildGrid(&grid, positions, pos_stride, count, search);
+
+  // the cost per sphere varies with the local density, small chunks
+  // balance dense and sparse regions
+  ThreadPool& pool = ThreadPool::global();
+  pool.parallelFor(0, count, 0, [&](unsigned first, unsigned last) {
+    occludeRange(grid, positions, pos_stride, radii, radius_stride,
+                 ao, ao_stride, search, first, last);
+  });
+
+  printf("Ambient occlusion: %u spheres, %u threads, %.1lf ms.\n",
+         count, pool.size(), timerStop());
+#endif
+}
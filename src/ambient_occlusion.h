@@ -0,0 +1,42 @@
+/*****************************************************************************/
+/**
+ * @file ambient_occlusion.h
+ * @brief Precomputed per-sphere ambient occlusion from neighbour density.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef AMBIENT_OCCLUSION_H_
+#define AMBIENT_OCCLUSION_H_
+
+/// neighbours farther away than this multiple of the largest radius are ignored
+#define AO_INFLUENCE_SCALE 2.0f
+/// scales accumulated occlusion before it is mapped to [AO_MINIMUM,1]
+#define AO_STRENGTH 0.1f
+#define AO_MINIMUM 0.2f
+
+/**
+ * Computes an ambient occlusion term for each sphere on the CPU (one-shot).
+ *
+ * Sphere centers are sorted into a uniform grid whose cell size equals the
+ * search radius, so only the 27 surrounding cells have to be visited.
+ * Each neighbour contributes the solid angle it subtends (weighted with a
+ * linear falloff), the result is 1 for an unoccluded sphere and goes down
+ * to AO_MINIMUM in dense regions. Work is split across all cores.
+ * All arrays are accessed with a stride given in floats, so interleaved
+ * and separated buffer layouts can be used directly.
+ * Define NO_AMBIENT_OCCLUSION to skip the computation (ao is set to 1).
+ *
+ * @param[in] positions sphere centers (x,y,z), pos_stride floats apart
+ * @param[in] pos_stride stride of positions in floats
+ * @param[in] radii sphere radii, radius_stride floats apart
+ * @param[in] radius_stride stride of radii in floats
+ * @param[out] ao occlusion terms in [AO_MINIMUM,1], ao_stride floats apart
+ * @param[in] ao_stride stride of ao in floats
+ * @param[in] count number of spheres
+ */
+void computeAmbientOcclusion(const float* positions, unsigned pos_stride,
+                             const float* radii, unsigned radius_stride,
+                             float* ao, unsigned ao_stride,
+                             unsigned count);
+
+#endif /* AMBIENT_OCCLUSION_H_ */
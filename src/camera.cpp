@@ -130,6 +130,19 @@ void Camera::applyProjection(float fov, int w, int h, float zNear, float zFar)
   _mvpmatrix = _projection * _modelview;
 }
 //-----------------------------------------------------------------------------
+// unprojects the pixel center on the near and the far plane
+//-----------------------------------------------------------------------------
+void Camera::pickRay(int x, int y, glm::vec3* origin, glm::vec3* direction) const
+{
+  glm::vec4 viewport(0.0f, 0.0f, (float) _screen.x, (float) _screen.y);
+  glm::vec3 window(x + 0.5f, _screen.y - y - 0.5f, 0.0f);
+  glm::vec3 near_point = glm::unProject(window, _modelview, _projection, viewport);
+  window.z = 1.0f;
+  glm::vec3 far_point = glm::unProject(window, _modelview, _projection, viewport);
+  *origin = near_point;
+  *direction = glm::normalize(far_point - near_point);
+}
+//-----------------------------------------------------------------------------
 // applyProjection
 //-----------------------------------------------------------------------------
 /*void Camera::applyProjection(float fov, float aspect, float zNear, float zFar)
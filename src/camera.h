@@ -3,6 +3,8 @@
  * @brief Camera class with OpenGL representation as transformation matrices.
  * @author Matthias Werner
  * @sa http://11235813tdd.blogspot.de/
+ * @date 2026/10/18: setScreen() added.
+ * @date 2026/10/18: pickRay() added.
  * @date 2016/03/12: Removed overloaded applyProjection().
  * Due to newer glm version, FOV internally is converted in radians.
  * @date 2013/04/26: Release.
@@ -67,10 +69,23 @@ class Camera
      * @param zFar z-value of far plane of view frustum
      */
     void applyProjection(float fov, int w, int h, float zNear=0.01f, float zFar=100.f);
+    /**
+     * Changes the screen size only, e.g. for a scaled render target of the
+     * same aspect ratio. The projection is kept.
+     */
+    void setScreen(int w, int h);
     /**
      * Computes modelview and modelview-projection matrix.
      */
     void apply();
+    /**
+     * World space ray through a pixel for picking.
+     * @param x window x (from the left)
+     * @param y window y (from the top, as delivered by GLUT)
+     * @param[out] origin point on the near plane
+     * @param[out] direction normalized direction into the scene
+     */
+    void pickRay(int x, int y, glm::vec3* origin, glm::vec3* direction) const;
 
   private:
     glm::ivec2 _screen;
@@ -137,4 +152,9 @@ inline void Camera::advancePositionZ(float z)
 inline const glm::ivec2& Camera::screen() const{
   return _screen;
 }
+inline void Camera::setScreen(int w, int h)
+{
+  _screen.x = w;
+  _screen.y = h;
+}
 #endif // CAMERA_H
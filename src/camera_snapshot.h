@@ -0,0 +1,71 @@
+/*****************************************************************************/
+/**
+ * @file camera_snapshot.h
+ * @brief Lock-free handoff of the camera from input to rendering.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef CAMERA_SNAPSHOT_H_
+#define CAMERA_SNAPSHOT_H_
+
+#include "camera.h"
+
+#include <atomic>
+
+/**
+ * Triple buffer for one writer and one reader. The writer fills back() and
+ * publishes it, the reader takes the newest published value with update().
+ * Both only swap an index with the shared middle slot, so neither side
+ * ever waits for the other, and intermediate values may be skipped.
+ */
+template<typename T>
+class TripleBuffer
+{
+  public:
+    TripleBuffer() : _front(0), _back(2), _middle(1) {}
+
+    /// writer: slot to fill before publish()
+    T& back() { return _slots[_back]; }
+    /// writer: makes back() the newest value
+    void publish()
+    {
+      _back = _middle.exchange(_back | DIRTY, std::memory_order_acq_rel) & INDEX;
+    }
+
+    /// reader: takes the newest value if there is one, true if it changed
+    bool update()
+    {
+      if (!(_middle.load(std::memory_order_relaxed) & DIRTY))
+        return false;
+      _front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX;
+      return true;
+    }
+    /// reader: value taken by the last update()
+    const T& front() const { return _slots[_front]; }
+
+  private:
+    enum { INDEX = 3, DIRTY = 4 };
+    T _slots[3];
+    unsigned _front; ///< reader only
+    unsigned _back;  ///< writer only
+    /// index of the middle slot, DIRTY if not read yet
+    std::atomic<unsigned> _middle;
+};
+
+/**
+ * State seen by a rendered frame. The input thread owns the Camera and
+ * publishes a copy after every change, so apply() never touches matrices
+ * which are in use by the renderer.
+ */
+struct CameraSnapshot
+{
+  CameraSnapshot() : width(0), height(0), input_time(0) {}
+
+  /// camera with applied modelview and projection
+  Camera camera;
+  int width, height;
+  /// LatencyMonitor::now() of the input event reflected by the camera, 0 if none
+  long long input_time;
+};
+
+#endif /* CAMERA_SNAPSHOT_H_ */
@@ -0,0 +1,323 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "chunk_file.h"
+
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <utility>
+
+#define CHUNK_FILE_VERSION 1
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+#define fseek64 _fseeki64
+#define ftell64 _ftelli64
+#else
+#define fseek64 fseeko
+#define ftell64 ftello
+#endif
+
+//-----------------------------------------------------------------------------
+// inserts two zero bits after each of the lower 10 bits
+//-----------------------------------------------------------------------------
+static inline unsigned expandBits(unsigned v)
+{
+  v = (v * 0x00010001u) & 0xFF0000FFu;
+  v = (v * 0x00000101u) & 0x0F00F00Fu;
+  v = (v * 0x00000011u) & 0xC30C30C3u;
+  v = (v * 0x00000005u) & 0x49249249u;
+  return v;
+}
+//-----------------------------------------------------------------------------
+// 30 bit Morton code of a point in [0,1]^3
+//-----------------------------------------------------------------------------
+static inline unsigned morton(float x, float y, float z)
+{
+  unsigned ix = (unsigned) std::min(std::max(x * 1024.0f, 0.0f), 1023.0f);
+  unsigned iy = (unsigned) std::min(std::max(y * 1024.0f, 0.0f), 1023.0f);
+  unsigned iz = (unsigned) std::min(std::max(z * 1024.0f, 0.0f), 1023.0f);
+  return (expandBits(ix) << 2) | (expandBits(iy) << 1) | expandBits(iz);
+}
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ChunkWriter::ChunkWriter()
+  : _file(NULL), _spill(NULL), _grid(0)
+{
+  memset(&_header, 0, sizeof(_header));
+}
+ChunkWriter::~ChunkWriter()
+{
+  close();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ChunkWriter::open(const char* filename, const float lower[3], const float upper[3],
+                      unsigned grid)
+{
+  close();
+  _file = fopen(filename, "wb");
+  if (_file == NULL)
+  {
+    printf("Cannot open '%s' for writing.\n", filename);
+    return 1;
+  }
+  _spillName = std::string(filename) + ".tmp";
+  _spill = fopen(_spillName.c_str(), "w+b");
+  if (_spill == NULL)
+  {
+    printf("Cannot open '%s' for writing.\n", _spillName.c_str());
+    fclose(_file);
+    _file = NULL;
+    return 1;
+  }
+  _grid = std::max(1u, grid);
+  for (int k = 0; k < 3; ++k)
+  {
+    _lower[k] = lower[k];
+    float extent = upper[k] - lower[k];
+    _scale[k] = extent > 0.0f ? _grid / extent : 0.0f;
+  }
+  _cells.assign(_grid * _grid * _grid, std::vector<ChunkSphere>());
+  _blocks.assign(_cells.size(), std::vector<unsigned long long>());
+  _chunks.clear();
+
+  memset(&_header, 0, sizeof(_header));
+  memcpy(_header.magic, "SPCH", 4);
+  _header.version = CHUNK_FILE_VERSION;
+  _header.chunk_spheres = CHUNK_SPHERES;
+  // header is completed by close()
+  if (fwrite(&_header, sizeof(_header), 1, _file) != 1)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ChunkWriter::append(const ChunkSphere& sphere)
+{
+  const float p[3] = { sphere.x, sphere.y, sphere.z };
+  unsigned c[3];
+  for (int k = 0; k < 3; ++k)
+    c[k] = (unsigned) std::min(std::max((p[k] - _lower[k]) * _scale[k], 0.0f),
+                               (float) (_grid - 1));
+  unsigned cell = (c[2] * _grid + c[1]) * _grid + c[0];
+  _cells[cell].push_back(sphere);
+  ++_header.num_spheres;
+  if (_cells[cell].size() == CHUNK_SPILL_SPHERES)
+    return spill(cell);
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ChunkWriter::spill(unsigned cell)
+{
+  std::vector<ChunkSphere>& spheres = _cells[cell];
+  if (fseek64(_spill, 0, SEEK_END) != 0)
+    return 1;
+  _blocks[cell].push_back((unsigned long long) ftell64(_spill));
+  if (fwrite(&spheres[0], sizeof(ChunkSphere), spheres.size(), _spill) != spheres.size())
+  {
+    printf("Error writing '%s'.\n", _spillName.c_str());
+    return 1;
+  }
+  spheres.clear();
+  return 0;
+}
+//-----------------------------------------------------------------------------
+// splits a cell along its Morton order into shuffled chunks
+//-----------------------------------------------------------------------------
+int ChunkWriter::writeCell(unsigned cell)
+{
+  std::vector<ChunkSphere> spheres;
+  spheres.resize(_blocks[cell].size() * CHUNK_SPILL_SPHERES);
+  for (size_t b = 0; b < _blocks[cell].size(); ++b)
+  {
+    if (fseek64(_spill, (long long) _blocks[cell][b], SEEK_SET) != 0
+        || fread(&spheres[b * CHUNK_SPILL_SPHERES], sizeof(ChunkSphere),
+                 CHUNK_SPILL_SPHERES, _spill) != CHUNK_SPILL_SPHERES)
+    {
+      printf("Error reading '%s'.\n", _spillName.c_str());
+      return 1;
+    }
+  }
+  spheres.insert(spheres.end(), _cells[cell].begin(), _cells[cell].end());
+  std::vector<ChunkSphere>().swap(_cells[cell]);
+  std::vector<unsigned long long>().swap(_blocks[cell]);
+  if (spheres.empty())
+    return 0;
+
+  float lower[3], upper[3];
+  for (int k = 0; k < 3; ++k)
+  {
+    lower[k] = (&spheres[0].x)[k];
+    upper[k] = lower[k];
+  }
+  for (size_t i = 1; i < spheres.size(); ++i)
+  {
+    for (int k = 0; k < 3; ++k)
+    {
+      lower[k] = std::min(lower[k], (&spheres[i].x)[k]);
+      upper[k] = std::max(upper[k], (&spheres[i].x)[k]);
+    }
+  }
+  std::vector<std::pair<unsigned, unsigned> > order(spheres.size());
+  for (size_t i = 0; i < spheres.size(); ++i)
+  {
+    float q[3];
+    for (int k = 0; k < 3; ++k)
+    {
+      float extent = upper[k] - lower[k];
+      q[k] = extent > 0.0f ? ((&spheres[i].x)[k] - lower[k]) / extent : 0.0f;
+    }
+    order[i] = std::make_pair(morton(q[0], q[1], q[2]), (unsigned) i);
+  }
+  std::sort(order.begin(), order.end());
+
+  // equal sizes, so neighbouring chunks have a similar density
+  unsigned total = (unsigned) spheres.size();
+  unsigned num_chunks = (total + CHUNK_SPHERES - 1) / CHUNK_SPHERES;
+  std::vector<ChunkSphere> chunk;
+  for (unsigned c = 0; c < num_chunks; ++c)
+  {
+    unsigned first = (unsigned) ((unsigned long long) total * c / num_chunks);
+    unsigned last = (unsigned) ((unsigned long long) total * (c + 1) / num_chunks);
+    chunk.resize(last - first);
+    for (unsigned i = first; i < last; ++i)
+      chunk[i - first] = spheres[order[i].second];
+    // deterministic, any prefix is a random subsample of the chunk
+    std::mt19937 random((unsigned) _chunks.size());
+    std::shuffle(chunk.begin(), chunk.end(), random);
+
+    ChunkInfo info;
+    memset(&info, 0, sizeof(info));
+    for (int k = 0; k < 3; ++k)
+    {
+      info.lower[k] = (&chunk[0].x)[k] - chunk[0].radius;
+      info.upper[k] = (&chunk[0].x)[k] + chunk[0].radius;
+    }
+    for (size_t i = 1; i < chunk.size(); ++i)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        info.lower[k] = std::min(info.lower[k], (&chunk[i].x)[k] - chunk[i].radius);
+        info.upper[k] = std::max(info.upper[k], (&chunk[i].x)[k] + chunk[i].radius);
+      }
+    }
+    info.count = (unsigned) chunk.size();
+    info.offset = (unsigned long long) ftell64(_file);
+    if (fwrite(&chunk[0], sizeof(ChunkSphere), chunk.size(), _file) != chunk.size())
+    {
+      printf("Error writing chunk file.\n");
+      return 1;
+    }
+    _chunks.push_back(info);
+  }
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ChunkWriter::close()
+{
+  if (_file == NULL)
+    return 0;
+  int err = 0;
+  for (unsigned cell = 0; cell < _cells.size() && !err; ++cell)
+    err = writeCell(cell);
+  _header.num_chunks = (unsigned) _chunks.size();
+  _header.table_offset = (unsigned long long) ftell64(_file);
+  if (!err && !_chunks.empty()
+      && fwrite(&_chunks[0], sizeof(ChunkInfo), _chunks.size(), _file) != _chunks.size())
+    err = 1;
+  if (fseek64(_file, 0, SEEK_SET) != 0
+      || fwrite(&_header, sizeof(_header), 1, _file) != 1)
+    err = 1;
+  fclose(_file);
+  _file = NULL;
+  fclose(_spill);
+  _spill = NULL;
+  remove(_spillName.c_str());
+  _cells.clear();
+  _blocks.clear();
+  if (err)
+    printf("Error writing chunk file.\n");
+  return err;
+}
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ChunkReader::ChunkReader()
+  : _file(NULL)
+{
+  memset(&_header, 0, sizeof(_header));
+}
+ChunkReader::~ChunkReader()
+{
+  close();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ChunkReader::open(const char* filename)
+{
+  close();
+  _file = fopen(filename, "rb");
+  if (_file == NULL)
+  {
+    printf("Cannot open chunk file '%s'.\n", filename);
+    return 1;
+  }
+  if (fread(&_header, sizeof(_header), 1, _file) != 1
+      || memcmp(_header.magic, "SPCH", 4) != 0
+      || _header.version != CHUNK_FILE_VERSION
+      || _header.num_chunks == 0 || _header.chunk_spheres == 0)
+  {
+    printf("'%s' is not a valid chunk file.\n", filename);
+    close();
+    return 1;
+  }
+  _chunks.resize(_header.num_chunks);
+  if (fseek64(_file, (long long) _header.table_offset, SEEK_SET) != 0
+      || fread(&_chunks[0], sizeof(ChunkInfo), _chunks.size(), _file) != _chunks.size())
+  {
+    printf("'%s': chunk table is truncated.\n", filename);
+    close();
+    return 1;
+  }
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ChunkReader::close()
+{
+  if (_file)
+    fclose(_file);
+  _file = NULL;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ChunkReader::read(unsigned chunk, unsigned first, unsigned count, ChunkSphere* spheres)
+{
+  const ChunkInfo& info = _chunks[chunk];
+  if (first + count > info.count)
+    return 1;
+  if (count == 0)
+    return 0;
+  if (fseek64(_file, (long long) (info.offset + (unsigned long long) first * sizeof(ChunkSphere)),
+              SEEK_SET) != 0
+      || fread(spheres, sizeof(ChunkSphere), count, _file) != count)
+  {
+    printf("Error reading chunk %u.\n", chunk);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+/*****************************************************************************/
+/**
+ * @file chunk_file.h
+ * @brief Spatially partitioned sphere file for out-of-core rendering.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef CHUNK_FILE_H_
+#define CHUNK_FILE_H_
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/// maximum spheres per chunk, one chunk fits a GPU page
+#define CHUNK_SPHERES 65536
+/// spheres buffered per grid cell before they are spilled to disk
+#define CHUNK_SPILL_SPHERES 512
+
+/// interleaved record as drawn by the impostor shaders (32 bytes)
+struct ChunkSphere
+{
+  float x, y, z;
+  float radius;
+  float r, g, b;
+  float ao;
+};
+
+/**
+ * File layout:
+ *   header | chunk 0 | chunk 1 | ... | ChunkInfo table (num_chunks)
+ * All values are little-endian as written by the host.
+ */
+struct ChunkFileHeader
+{
+  char magic[4]; ///< "SPCH"
+  unsigned version;
+  unsigned chunk_spheres; ///< maximum spheres per chunk
+  unsigned num_chunks;
+  unsigned long long num_spheres;
+  unsigned long long table_offset;
+};
+
+struct ChunkInfo
+{
+  float lower[3], upper[3]; ///< bounds of the spheres including radii
+  unsigned count;
+  unsigned reserved;
+  unsigned long long offset; ///< file offset of the first sphere
+};
+
+/**
+ * Partitions a stream of spheres of any size into chunks with bounded
+ * memory. Spheres are binned into a uniform grid, full cell buffers are
+ * spilled to a temporary file. close() loads one cell at a time, splits it
+ * along its Morton order into chunks of at most CHUNK_SPHERES and shuffles
+ * every chunk, so that any prefix of a chunk is a random subsample of it
+ * (the level of detail used while a chunk is streamed in).
+ */
+class ChunkWriter
+{
+  public:
+    ChunkWriter();
+    ~ChunkWriter();
+    /**
+     * @param lower, upper bounds of all sphere centers
+     * @param grid cells per axis
+     * @retval 0 on success
+     */
+    int open(const char* filename, const float lower[3], const float upper[3],
+             unsigned grid);
+    int append(const ChunkSphere& sphere);
+    /// writes the chunks and the table, removes the temporary file
+    int close();
+
+  private:
+    int spill(unsigned cell);
+    int writeCell(unsigned cell);
+
+  private:
+    FILE* _file;
+    FILE* _spill;
+    std::string _spillName;
+    ChunkFileHeader _header;
+    float _lower[3], _scale[3];
+    unsigned _grid;
+    std::vector<std::vector<ChunkSphere> > _cells;
+    /// offsets of the spilled blocks per cell (CHUNK_SPILL_SPHERES each)
+    std::vector<std::vector<unsigned long long> > _blocks;
+    std::vector<ChunkInfo> _chunks;
+};
+
+/**
+ * Random access to the chunks of a chunk file. Not thread-safe, the
+ * out-of-core renderer reads from its loader thread only.
+ */
+class ChunkReader
+{
+  public:
+    ChunkReader();
+    ~ChunkReader();
+    int open(const char* filename);
+    void close();
+    bool isOpen() const { return _file != NULL; }
+    unsigned numChunks() const { return _header.num_chunks; }
+    unsigned long long numSpheres() const { return _header.num_spheres; }
+    unsigned chunkSpheres() const { return _header.chunk_spheres; }
+    const ChunkInfo& chunk(unsigned i) const { return _chunks[i]; }
+    /**
+     * Reads spheres [first, first + count) of a chunk.
+     * @retval 0 on success
+     */
+    int read(unsigned chunk, unsigned first, unsigned count, ChunkSphere* spheres);
+
+  private:
+    FILE* _file;
+    ChunkFileHeader _header;
+    std::vector<ChunkInfo> _chunks;
+};
+
+#endif /* CHUNK_FILE_H_ */
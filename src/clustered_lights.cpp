@@ -0,0 +1,271 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "clustered_lights.h"
+#include "thread_pool.h"
+
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ClusteredLights::ClusteredLights()
+  : _count(0), _uniforms(0), _buildMs(0.0)
+{
+  _buffers[0] = _buffers[1] = _buffers[2] = 0;
+  _textures[0] = _textures[1] = _textures[2] = 0;
+  _sliceScale = LIGHT_GRID_Z / logf(LIGHT_GRID_FAR / LIGHT_GRID_NEAR);
+  _sliceBias = -logf(LIGHT_GRID_NEAR) * _sliceScale;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ClusteredLights::create()
+{
+  // own generator, the sphere sequences of rand() stay the same
+  std::minstd_rand random(1024);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  _lights.resize(LIGHTS_MAX);
+  for (unsigned i = 0; i < LIGHTS_MAX; ++i)
+  {
+    Light& light = _lights[i];
+    light.center = glm::vec3(unit(random), unit(random), unit(random)) * 2.0f - 1.0f;
+    light.orbit = glm::vec3(unit(random), unit(random), unit(random)) * 0.25f;
+    light.color = glm::vec3(unit(random), unit(random), unit(random));
+    light.phase = unit(random) * 6.2831853f;
+  }
+  _clusterLights.resize(LIGHT_GRID_X * LIGHT_GRID_Y * LIGHT_GRID_Z);
+
+  glGenBuffers(1, &_uniforms);
+  glBindBuffer(GL_UNIFORM_BUFFER, _uniforms);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(LightData), NULL, GL_STREAM_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_UNIFORM_BINDING, _uniforms);
+
+  const GLenum formats[3] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+  glGenBuffers(3, _buffers);
+  glGenTextures(3, _textures);
+  for (int k = 0; k < 3; ++k)
+  {
+    // a texel each until the first update
+    const GLuint zero[4] = { 0, 0, 0, 0 };
+    glBindBuffer(GL_TEXTURE_BUFFER, _buffers[k]);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(zero), zero, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, _textures[k]);
+    glTexBuffer(GL_TEXTURE_BUFFER, formats[k], _buffers[k]);
+  }
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ClusteredLights::setBindings(ShaderManager& shader)
+{
+  shader.setUniformBlockBinding(LIGHT_UNIFORM_BLOCK, LIGHT_UNIFORM_BINDING);
+  shader.setSamplerUnit("LightParams", LIGHT_TEXTURE_UNIT);
+  shader.setSamplerUnit("LightClusters", LIGHT_TEXTURE_UNIT + 1);
+  shader.setSamplerUnit("LightIndices", LIGHT_TEXTURE_UNIT + 2);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ClusteredLights::setCount(unsigned count)
+{
+  _count = std::min(count, (unsigned) _lights.size());
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ClusteredLights::slice(float distance) const
+{
+  if (distance <= LIGHT_GRID_NEAR)
+    return 0;
+  int s = (int) floorf(logf(distance) * _sliceScale + _sliceBias);
+  return std::min(std::max(s, 0), LIGHT_GRID_Z - 1);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ClusteredLights::update(const Camera& camera, float time)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  const glm::mat4 modelview = camera.modelview_glm();
+  const glm::mat4 projection = camera.projection_glm();
+  const glm::ivec2 screen = camera.screen();
+  const unsigned count = _count;
+  _params.resize(2 * std::max(count, 1u));
+  _ranges.resize(count);
+  _slices.resize(count);
+
+  ThreadPool& pool = ThreadPool::global();
+  // eye space bounds of each light
+  pool.parallelFor(0, count, 0, [&](unsigned first, unsigned last) {
+    for (unsigned i = first; i < last; ++i)
+    {
+      const Light& light = _lights[i];
+      const float a = 0.5f * time + light.phase;
+      glm::vec3 p = light.center + light.orbit * glm::vec3(cosf(a), sinf(a), sinf(1.3f * a));
+      glm::vec4 e = modelview * glm::vec4(p, 1.0f);
+      _params[2*i] = glm::vec4(e.x, e.y, e.z, LIGHT_RADIUS);
+      _params[2*i+1] = glm::vec4(light.color, 1.0f);
+      // no clusters if behind the camera
+      _slices[i] = glm::ivec2(1, 0);
+      if (e.z - LIGHT_RADIUS >= 0.0f)
+        continue;
+      if (e.z + LIGHT_RADIUS > -LIGHT_GRID_NEAR)
+      {
+        // reaches into the first slice, bounds of the projection are unbounded
+        _ranges[i] = glm::ivec4(0, LIGHT_GRID_X - 1, 0, LIGHT_GRID_Y - 1);
+      }
+      else
+      {
+        // projected corners of the bounding box
+        glm::vec2 lo(1e30f), hi(-1e30f);
+        for (int c = 0; c < 8; ++c)
+        {
+          glm::vec4 corner(e.x + ((c & 1) ? LIGHT_RADIUS : -LIGHT_RADIUS),
+                           e.y + ((c & 2) ? LIGHT_RADIUS : -LIGHT_RADIUS),
+                           e.z + ((c & 4) ? LIGHT_RADIUS : -LIGHT_RADIUS), 1.0f);
+          glm::vec4 clip = projection * corner;
+          glm::vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+          lo = glm::min(lo, ndc);
+          hi = glm::max(hi, ndc);
+        }
+        if (hi.x < -1.0f || hi.y < -1.0f || lo.x > 1.0f || lo.y > 1.0f)
+          continue;
+        _ranges[i] = glm::ivec4(
+            std::max((int) floorf((lo.x * 0.5f + 0.5f) * LIGHT_GRID_X), 0),
+            std::min((int) floorf((hi.x * 0.5f + 0.5f) * LIGHT_GRID_X), LIGHT_GRID_X - 1),
+            std::max((int) floorf((lo.y * 0.5f + 0.5f) * LIGHT_GRID_Y), 0),
+            std::min((int) floorf((hi.y * 0.5f + 0.5f) * LIGHT_GRID_Y), LIGHT_GRID_Y - 1));
+      }
+      _slices[i] = glm::ivec2(slice(-(e.z + LIGHT_RADIUS)), slice(-(e.z - LIGHT_RADIUS)));
+    }
+  });
+  // each depth slice owns its clusters, the lights are kept in order
+  pool.parallelFor(0, LIGHT_GRID_Z, 1, [&](unsigned first, unsigned last) {
+    for (unsigned z = first; z < last; ++z)
+    {
+      std::vector<unsigned>* lists = &_clusterLights[z * LIGHT_GRID_X * LIGHT_GRID_Y];
+      for (int c = 0; c < LIGHT_GRID_X * LIGHT_GRID_Y; ++c)
+        lists[c].clear();
+      for (unsigned i = 0; i < count; ++i)
+      {
+        if ((int) z < _slices[i].x || (int) z > _slices[i].y)
+          continue;
+        const glm::ivec4& r = _ranges[i];
+        for (int y = r.z; y <= r.w; ++y)
+          for (int x = r.x; x <= r.y; ++x)
+            lists[y * LIGHT_GRID_X + x].push_back(i);
+      }
+    }
+  });
+  _clusters.resize(2 * _clusterLights.size());
+  _indices.clear();
+  for (size_t c = 0; c < _clusterLights.size(); ++c)
+  {
+    _clusters[2*c] = (GLuint) _indices.size();
+    _clusters[2*c+1] = (GLuint) _clusterLights[c].size();
+    _indices.insert(_indices.end(), _clusterLights[c].begin(), _clusterLights[c].end());
+  }
+  if (_indices.empty())
+    _indices.push_back(0);
+  _buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  _data.gridScale = glm::vec4((float) LIGHT_GRID_X / screen.x, (float) LIGHT_GRID_Y / screen.y,
+                              _sliceScale, _sliceBias);
+  _data.gridSize = glm::ivec4(LIGHT_GRID_X, LIGHT_GRID_Y, LIGHT_GRID_Z, count);
+  glBindBuffer(GL_UNIFORM_BUFFER, _uniforms);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightData), &_data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  // orphaned, the previous frame may still read them
+  upload_buffer(_buffers[0], &_params[0], (GLuint) _params.size(), GL_TEXTURE_BUFFER, GL_STREAM_DRAW);
+  upload_buffer(_buffers[1], &_clusters[0], (GLuint) _clusters.size(), GL_TEXTURE_BUFFER, GL_STREAM_DRAW);
+  upload_buffer(_buffers[2], &_indices[0], (GLuint) _indices.size(), GL_TEXTURE_BUFFER, GL_STREAM_DRAW);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ClusteredLights::bind()
+{
+  for (int k = 0; k < 3; ++k)
+  {
+    glActiveTexture(GL_TEXTURE0 + LIGHT_TEXTURE_UNIT + k);
+    glBindTexture(GL_TEXTURE_BUFFER, _textures[k]);
+  }
+  glActiveTexture(GL_TEXTURE0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ClusteredLights::unbind()
+{
+  for (int k = 0; k < 3; ++k)
+  {
+    glActiveTexture(GL_TEXTURE0 + LIGHT_TEXTURE_UNIT + k);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+  }
+  glActiveTexture(GL_TEXTURE0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ClusteredLights::record(unsigned count, double frame_ms)
+{
+  if (frame_ms < 0.0)
+    return;
+  std::map<unsigned, Timing>::iterator it = _timings.find(count);
+  if (it == _timings.end())
+  {
+    Timing timing = { 0, 0, 0.0, 0.0 };
+    it = _timings.insert(std::make_pair(count, timing)).first;
+  }
+  ++it->second.frames;
+  it->second.sum += frame_ms;
+  if (count > 0)
+  {
+    ++it->second.builds;
+    it->second.build += _buildMs;
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ClusteredLights::report()
+{
+  // nothing to compare until a frame with lights has been rendered
+  if (_timings.empty() || (_timings.size() == 1 && _timings.begin()->first == 0))
+    return;
+  printf("Lights\tFrames\tAvg\t\tGrid (CPU)\n");
+  std::map<unsigned, Timing>::const_iterator it;
+  for (it = _timings.begin(); it != _timings.end(); ++it)
+  {
+    const Timing& timing = it->second;
+    if (timing.builds > 0)
+      printf("%u\t%u\t%-8.3lf\t%-8.3lf\n", it->first, timing.frames,
+             timing.sum / timing.frames, timing.build / timing.builds);
+    else
+      printf("%u\t%u\t%-8.3lf\t-\n", it->first, timing.frames, timing.sum / timing.frames);
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ClusteredLights::cleanup()
+{
+  glDeleteTextures(3, _textures);
+  glDeleteBuffers(3, _buffers);
+  glDeleteBuffers(1, &_uniforms);
+  _textures[0] = _textures[1] = _textures[2] = 0;
+  _buffers[0] = _buffers[1] = _buffers[2] = 0;
+  _uniforms = 0;
+}
@@ -0,0 +1,113 @@
+/*****************************************************************************/
+/**
+ * @file clustered_lights.h
+ * @brief Point lights assigned to view space clusters for forward shading.
+ * @sa Olsson, Billeter, Assarsson: Clustered Deferred and Forward Shading, HPG 2012.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef CLUSTERED_LIGHTS_H_
+#define CLUSTERED_LIGHTS_H_
+
+#include "gl_globals.h"
+#include "camera.h"
+#include "shader.h"
+
+#include <glm/glm.hpp>
+#include <map>
+#include <vector>
+
+/// name of the uniform block in the shaders
+#define LIGHT_UNIFORM_BLOCK "LightData"
+/// uniform buffer binding point of the LightData block
+#define LIGHT_UNIFORM_BINDING 2
+/// texture units of the light, cluster and light index buffers
+#define LIGHT_TEXTURE_UNIT 4
+/// clusters in screen x, y and in depth
+#define LIGHT_GRID_X 16
+#define LIGHT_GRID_Y 9
+#define LIGHT_GRID_Z 24
+/// view depth range of the exponential depth slices
+#define LIGHT_GRID_NEAR 0.1f
+#define LIGHT_GRID_FAR 100.0f
+#define LIGHTS_MAX 1024
+/// radius of influence of the generated lights
+#define LIGHT_RADIUS 0.35f
+
+/// memory layout of the LightData uniform block (std140) in shader/common.glsl
+struct LightData
+{
+  glm::vec4 gridScale;
+  glm::ivec4 gridSize;
+};
+
+/**
+ * Clustered forward lighting. The view frustum is divided into
+ * LIGHT_GRID_X x LIGHT_GRID_Y screen tiles times LIGHT_GRID_Z exponential
+ * depth slices. Each frame, update() moves the lights, transforms them to
+ * eye space and assigns every light to the clusters its sphere of influence
+ * overlaps, on the CPU with the shared thread pool. Three texture buffers
+ * are uploaded:
+ *  - LightParams: eye position and radius, color (2 texels per light)
+ *  - LightClusters: offset and count into LightIndices per cluster
+ *  - LightIndices: light indices, grouped by cluster
+ *
+ * With the shader define LIGHTS=1, sphere.frag looks up the cluster of the
+ * sphere surface point and shades only the lights listed there.
+ *
+ * GPU frame and CPU build times are kept per light count for the benchmark.
+ */
+class ClusteredLights
+{
+  public:
+    ClusteredLights();
+    int create();
+    /// sets the texture units and the uniform block of an impostor shader
+    static void setBindings(ShaderManager& shader);
+    /// number of lights in [0, LIGHTS_MAX], the first lights are kept
+    void setCount(unsigned count);
+    unsigned count() const { return _count; }
+    /// moves the lights and rebuilds and uploads the light grid
+    void update(const Camera& camera, float time);
+    /// binds the buffers to LIGHT_TEXTURE_UNIT and the following units
+    void bind();
+    void unbind();
+    /// adds the GPU time of a frame with the current light count
+    void record(unsigned count, double frame_ms);
+    /// prints the frame and grid build times per light count
+    void report();
+    void cleanup();
+
+  private:
+    struct Light
+    {
+      glm::vec3 center, orbit;
+      glm::vec3 color;
+      float phase;
+    };
+    struct Timing
+    {
+      unsigned frames, builds;
+      double sum, build;
+    };
+    /// slice of a view distance, clamped to the grid
+    int slice(float distance) const;
+
+    std::vector<Light> _lights;
+    unsigned _count;
+    // per frame: eye space lights, cluster ranges, lists per cluster
+    std::vector<glm::vec4> _params;
+    std::vector<glm::ivec4> _ranges; // tile x0,x1,y0,y1 (inclusive)
+    std::vector<glm::ivec2> _slices;
+    std::vector< std::vector<unsigned> > _clusterLights;
+    std::vector<GLuint> _clusters;
+    std::vector<GLuint> _indices;
+    LightData _data;
+    GLuint _uniforms;
+    GLuint _buffers[3], _textures[3];
+    float _sliceScale, _sliceBias;
+    double _buildMs;
+    std::map<unsigned, Timing> _timings;
+};
+
+#endif /* CLUSTERED_LIGHTS_H_ */
@@ -0,0 +1,145 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "dynamic_resolution.h"
+#include "frame_uniforms.h"
+
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+DynamicResolution::DynamicResolution()
+  : _vertexArray(0), _scale(1.0f)
+{
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int DynamicResolution::create()
+{
+  // the full screen triangle is generated from gl_VertexID
+  glGenVertexArrays(1, &_vertexArray);
+  _shader.load("upscale.vert", "upscale.frag");
+  _shader.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+  _shader.setSamplerUnit("Color", 0);
+  _shader.setSamplerUnit("Depth", 1);
+  if (_shader.link())
+  {
+    printf("Error occurred.\n");
+    return 1;
+  }
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void DynamicResolution::setScale(float scale)
+{
+  _scale = std::min(std::max(scale, RESOLUTION_SCALE_MIN), 1.0f);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+glm::ivec2 DynamicResolution::targetSize(int width, int height) const
+{
+  return glm::ivec2(std::max((int) (width * _scale + 0.5f), 1),
+                    std::max((int) (height * _scale + 0.5f), 1));
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int DynamicResolution::bind(int width, int height)
+{
+  if (_target.id() == 0)
+  {
+    std::vector<GLenum> formats(1, GL_RGBA8);
+    if (_target.create(width, height, formats, true) != 0)
+      return 1;
+  }
+  else if (_target.resize(width, height) != 0)
+    return 1;
+  _target.bind();
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void DynamicResolution::upscale(int width, int height)
+{
+  _target.unbind();
+  glViewport(0, 0, width, height);
+  glDisable(GL_DEPTH_TEST);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, _target.texture(0));
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, _target.depthTexture());
+  _shader.bind();
+  float size[4] = { (float) _target.width(), (float) _target.height(),
+                    1.0f / _target.width(), 1.0f / _target.height() };
+  _shader.setUniformVar("SourceSize", size);
+  glBindVertexArray(_vertexArray);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+  glBindVertexArray(0);
+  _shader.unbind();
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glEnable(GL_DEPTH_TEST);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void DynamicResolution::record(float scale, double frame_ms)
+{
+  if (frame_ms < 0.0)
+    return;
+  std::map<float, Timing>::iterator it = _timings.find(scale);
+  if (it == _timings.end())
+  {
+    Timing timing;
+    timing.frames = 0;
+    timing.sum = 0.0;
+    timing.min = frame_ms;
+    it = _timings.insert(std::make_pair(scale, timing)).first;
+  }
+  Timing& timing = it->second;
+  ++timing.frames;
+  timing.sum += frame_ms;
+  timing.min = std::min(timing.min, frame_ms);
+  // of the latest frame, the window may have been resized
+  timing.size = glm::ivec2(_target.width(), _target.height());
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void DynamicResolution::report()
+{
+  // nothing to compare until a scaled frame has been rendered
+  if (_timings.empty() || (_timings.size() == 1 && _timings.begin()->first == 1.0f))
+    return;
+  printf("Scale\tFrames\tAvg\t\tMin\t\tTarget\n");
+  std::map<float, Timing>::reverse_iterator it;
+  for (it = _timings.rbegin(); it != _timings.rend(); ++it)
+  {
+    const Timing& timing = it->second;
+    if (it->first < 1.0f)
+      printf("%.3f\t%u\t%-8.3lf\t%-8.3lf\t%dx%d\n", it->first, timing.frames,
+             timing.sum / timing.frames, timing.min, timing.size.x, timing.size.y);
+    else
+      printf("%.3f\t%u\t%-8.3lf\t%-8.3lf\twindow\n", it->first, timing.frames,
+             timing.sum / timing.frames, timing.min);
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void DynamicResolution::cleanup()
+{
+  _target.cleanup();
+  glDeleteVertexArrays(1, &_vertexArray);
+  _vertexArray = 0;
+}
@@ -0,0 +1,72 @@
+/*****************************************************************************/
+/**
+ * @file dynamic_resolution.h
+ * @brief Scaled offscreen rendering with an edge-aware upscale pass.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef DYNAMIC_RESOLUTION_H_
+#define DYNAMIC_RESOLUTION_H_
+
+#include "gl_globals.h"
+#include "framebuffer.h"
+#include "shader.h"
+
+#include <glm/glm.hpp>
+#include <map>
+#include <string>
+
+/// smallest render resolution scale (per axis)
+#define RESOLUTION_SCALE_MIN 0.25f
+/// step of the keys '[' and ']'
+#define RESOLUTION_SCALE_STEP 0.125f
+
+/**
+ * Renders into a Framebuffer of scale * window size (color and depth) and
+ * upscales the result into the default framebuffer, so the fragment cost of
+ * the impostors drops with the square of the scale.
+ *
+ * The upscale takes the 2x2 texels around an output pixel with bilinear
+ * weights, damped by the difference of their linear depth to the texel
+ * nearest to the pixel. Sphere silhouettes stay sharp and the background
+ * does not bleed into them, while the interior of a sphere is filtered.
+ *
+ * Frame times are collected per scale for the benchmark output.
+ */
+class DynamicResolution
+{
+  public:
+    DynamicResolution();
+    /// loads the upscale shader, the target is created on first use
+    int create();
+    /// @param scale per axis, clamped to [RESOLUTION_SCALE_MIN, 1]
+    void setScale(float scale);
+    float scale() const { return _scale; }
+    /// size of the render target for a window
+    glm::ivec2 targetSize(int width, int height) const;
+    /// resizes and binds the render target
+    int bind(int width, int height);
+    /// edge-aware upscale of the render target into the default framebuffer
+    void upscale(int width, int height);
+    int recompile() { return _shader.reload(); }
+    /// adds the GPU time of a frame rendered at the given scale
+    void record(float scale, double frame_ms);
+    /// prints the frame times per scale since the start
+    void report();
+    void cleanup();
+
+  private:
+    struct Timing
+    {
+      unsigned frames;
+      double sum, min;
+      glm::ivec2 size;
+    };
+    Framebuffer _target;
+    ShaderManager _shader;
+    GLuint _vertexArray;
+    float _scale;
+    std::map<float, Timing> _timings;
+};
+
+#endif /* DYNAMIC_RESOLUTION_H_ */
@@ -0,0 +1,125 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "frame_controller.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+FrameController::FrameController()
+  : _target(0.0f), _average(0.0), _samples(0), _hold(FRAME_CONTROLLER_SETTLE),
+    _backoff(1), _sinceRaise(0), _raised(-1),
+    _frames(0), _overBudget(0), _changes(0)
+{
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void FrameController::setTarget(float target_ms)
+{
+  _target = std::max(target_ms, 0.0f);
+  _samples = 0;
+  _hold = FRAME_CONTROLLER_SETTLE;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+unsigned FrameController::addKnob(const char* name, unsigned levels)
+{
+  Knob knob = { name, 0, std::max(levels, 1u) };
+  _knobs.push_back(knob);
+  return (unsigned) _knobs.size() - 1;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void FrameController::change(unsigned knob, unsigned level, bool raise)
+{
+  printf("Frame budget: %.2f ms %s %.2f ms target, %s %u -> %u\n", _average,
+         raise ? "<" : ">", _target, _knobs[knob].name.c_str(), _knobs[knob].level, level);
+  _knobs[knob].level = level;
+  _samples = 0;
+  _hold = FRAME_CONTROLLER_SETTLE;
+  ++_changes;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+bool FrameController::update(double frame_ms)
+{
+  if (!enabled() || frame_ms < 0.0)
+    return false;
+  ++_frames;
+  if (frame_ms > _target)
+    ++_overBudget;
+  _average = _samples == 0 ? frame_ms
+      : (1.0 - FRAME_CONTROLLER_SMOOTHING) * _average + FRAME_CONTROLLER_SMOOTHING * frame_ms;
+  ++_samples;
+  ++_sinceRaise;
+  if (_hold > 0)
+  {
+    --_hold;
+    return false;
+  }
+  // the last raise has held
+  if (_raised >= 0 && _sinceRaise >= 2 * FRAME_CONTROLLER_SETTLE)
+  {
+    _raised = -1;
+    _backoff = 1;
+  }
+
+  if (_average > _target * (1.0 + FRAME_CONTROLLER_BAND))
+  {
+    // the last raise did not fit into the budget
+    if (_raised >= 0)
+    {
+      _backoff = std::min(2 * _backoff, (unsigned) FRAME_CONTROLLER_MAX_BACKOFF);
+      printf("Frame budget: raising %s did not hold, next raise after %u frames\n",
+             _knobs[_raised].name.c_str(), _backoff * FRAME_CONTROLLER_SETTLE);
+    }
+    _raised = -1;
+    for (unsigned k = 0; k < _knobs.size(); ++k)
+    {
+      if (_knobs[k].level + 1 >= _knobs[k].levels)
+        continue;
+      change(k, _knobs[k].level + 1, false);
+      return true;
+    }
+    return false;
+  }
+  if (_average < _target * (1.0 - 2.0 * FRAME_CONTROLLER_BAND))
+  {
+    // stable for long enough to try a raise
+    if (_samples < _backoff * FRAME_CONTROLLER_SETTLE)
+      return false;
+    for (unsigned k = (unsigned) _knobs.size(); k-- > 0; )
+    {
+      if (_knobs[k].level == 0)
+        continue;
+      change(k, _knobs[k].level - 1, true);
+      _raised = (int) k;
+      _sinceRaise = 0;
+      return true;
+    }
+    return false;
+  }
+  return false;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void FrameController::report()
+{
+  if (!enabled() || _frames == 0)
+    return;
+  printf("Frame budget: %.2f ms target, %.1f%% of frames over, %u changes, levels",
+         _target, 100.0 * _overBudget / _frames, _changes);
+  for (size_t k = 0; k < _knobs.size(); ++k)
+    printf(" %s=%u/%u", _knobs[k].name.c_str(), _knobs[k].level, _knobs[k].levels - 1);
+  printf("\n");
+  _frames = _overBudget = _changes = 0;
+}
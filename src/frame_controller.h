@@ -0,0 +1,78 @@
+/*****************************************************************************/
+/**
+ * @file frame_controller.h
+ * @brief Keeps the GPU frame time near a target by adjusting quality knobs.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef FRAME_CONTROLLER_H_
+#define FRAME_CONTROLLER_H_
+
+#include <string>
+#include <vector>
+
+/// weight of the newest frame time in the moving average
+#define FRAME_CONTROLLER_SMOOTHING 0.1f
+/// quality is reduced above target * (1 + band), raised below target * (1 - 2 * band)
+#define FRAME_CONTROLLER_BAND 0.1f
+/// frames after a change before the next decision (new frame times settle)
+#define FRAME_CONTROLLER_SETTLE 30
+/// hold time after a raise that had to be undone is doubled up to this factor
+#define FRAME_CONTROLLER_MAX_BACKOFF 16
+
+/**
+ * Frame time budget controller. Knobs are registered in the order they are
+ * reduced, each with levels from 0 (full quality) to levels-1 (cheapest).
+ * update() takes the measured GPU frame time and changes at most one level:
+ * above the upper band the first knob which is not at its cheapest level is
+ * reduced, below the lower band the last reduced knob is raised again.
+ *
+ * Oscillation is avoided by the gap between the bands, by waiting
+ * FRAME_CONTROLLER_SETTLE frames after every change (the average is
+ * restarted) and by backing off: if a raise is undone right away, the
+ * controller waits twice as long before it raises again.
+ * Decisions are logged to stdout, the caller applies the levels.
+ */
+class FrameController
+{
+  public:
+    FrameController();
+    /// @param target_ms frame time to keep, 0 disables the controller
+    void setTarget(float target_ms);
+    float target() const { return _target; }
+    bool enabled() const { return _target > 0.0f; }
+    /// @retval index of the knob
+    unsigned addKnob(const char* name, unsigned levels);
+    unsigned level(unsigned knob) const { return _knobs[knob].level; }
+    /**
+     * @param frame_ms measured GPU time of the last frame
+     * @retval true if a level has changed
+     */
+    bool update(double frame_ms);
+    /// prints and resets the statistics since the last report()
+    void report();
+
+  private:
+    struct Knob
+    {
+      std::string name;
+      unsigned level, levels;
+    };
+    void change(unsigned knob, unsigned level, bool raise);
+
+  private:
+    std::vector<Knob> _knobs;
+    float _target;
+    double _average;
+    unsigned _samples;
+    /// frames until the next decision
+    unsigned _hold;
+    unsigned _backoff;
+    /// frames since the last raise, to detect raises which are undone
+    unsigned _sinceRaise;
+    int _raised;
+    // statistics since the last report()
+    unsigned _frames, _overBudget, _changes;
+};
+
+#endif /* FRAME_CONTROLLER_H_ */
@@ -0,0 +1,115 @@
+/*****************************************************************************/
+/**
+ * @file frame_queue.h
+ * @brief Frame packets handed from the input thread to the render thread.
+ * @date 2026/10/18: Sphere filter added.
+ * @date 2026/10/18: Transfer function preset and range added.
+ * @date 2026/10/18: Light count added.
+ * @date 2026/10/18: Multi-view pass mode added.
+ * @date 2026/10/18: Resolution scale added.
+ * @date 2026/10/18: LOD error threshold added.
+ * @date 2026/10/18: Picking requests added.
+ * @date 2026/10/18: Camera moved to CameraSnapshot.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef FRAME_QUEUE_H_
+#define FRAME_QUEUE_H_
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// capacity of the packet queue between input and render thread
+#define FRAME_QUEUE_SIZE 16
+
+/**
+ * Updates from the input thread which the render thread applies in order
+ * (the camera is handed over by CameraSnapshot). A packet is not modified
+ * after it has been pushed.
+ */
+struct FramePacket
+{
+  FramePacket()
+    : recompile(false), lod_error(-1.0f), resolution_scale(-1.0f), single_pass(-1),
+      light_count(-1), colormap_preset(-1), colormap_max(-1.0f), filter(false),
+      filter_type(-1), filter_radius(0.0f), id_picking(-1), pick(false), pick_x(0), pick_y(0), pick_width(0),
+      pick_height(0), quit(false) {}
+  /// true if there is nothing to apply
+  bool empty() const
+  {
+    return defines.empty() && !recompile && lod_error < 0.0f && resolution_scale < 0.0f
+        && single_pass < 0 && light_count < 0 && colormap_preset < 0 && colormap_max < 0.0f
+        && !filter && id_picking < 0 && !pick && !quit;
+  }
+
+  /// shader defines (name, value) in the order they were changed
+  std::vector< std::pair<std::string, int> > defines;
+  bool recompile;
+  /// LOD error threshold in pixels, negative if unchanged
+  float lod_error;
+  /// render resolution scale, negative if unchanged
+  float resolution_scale;
+  /// multi-view in a single pass (1) or one pass per view (0), -1 unchanged
+  int single_pass;
+  /// number of point lights, -1 unchanged
+  int light_count;
+  /// transfer function preset, -1 unchanged
+  int colormap_preset;
+  /// scalar at the end of the transfer function, negative if unchanged
+  float colormap_max;
+  /// sphere filter changed: type (-1 all) and minimum radius
+  bool filter;
+  int filter_type;
+  float filter_radius;
+  /// ID buffer picking on (1) or off (0), -1 unchanged
+  int id_picking;
+  /// ID buffer pick at window coordinates
+  bool pick;
+  int pick_x, pick_y, pick_width, pick_height;
+  /// render thread releases the context and exits
+  bool quit;
+};
+
+/**
+ * Lock-free single producer, single consumer ring buffer.
+ * The producer only writes the tail, the consumer only the head, so a
+ * full or empty queue is detected without locks and neither side blocks.
+ */
+template<typename T, unsigned TCapacity>
+class FrameQueue
+{
+  public:
+    FrameQueue() : _head(0), _tail(0) {}
+
+    /// producer side, false if the queue is full
+    bool push(const T& item)
+    {
+      unsigned tail = _tail.load(std::memory_order_relaxed);
+      if (tail - _head.load(std::memory_order_acquire) == TCapacity)
+        return false;
+      _items[tail % TCapacity] = item;
+      _tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// consumer side, false if the queue is empty
+    bool pop(T* item)
+    {
+      unsigned head = _head.load(std::memory_order_relaxed);
+      if (head == _tail.load(std::memory_order_acquire))
+        return false;
+      *item = _items[head % TCapacity];
+      _head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+  private:
+    T _items[TCapacity];
+    // separate cache lines, producer and consumer do not share writes
+    alignas(64) std::atomic<unsigned> _head;
+    alignas(64) std::atomic<unsigned> _tail;
+};
+
+#endif /* FRAME_QUEUE_H_ */
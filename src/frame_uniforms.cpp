@@ -0,0 +1,55 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "frame_uniforms.h"
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+FrameUniforms::FrameUniforms()
+  : _buffer(0)
+{
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int FrameUniforms::create()
+{
+  if (!_buffer)
+    glGenBuffers(1, &_buffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), NULL, GL_STREAM_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, _buffer);
+
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void FrameUniforms::update(const Camera& camera, const glm::vec4& lightPos)
+{
+  _data.MVMatrix = camera.modelview_glm();
+  _data.PMatrix = camera.projection_glm();
+  _data.MVPMatrix = camera.mvpmatrix_glm();
+  _data.lightPos = lightPos;
+  _data.viewport = glm::vec4((float) camera.screen().x,
+                             (float) camera.screen().y,
+                             1.0f / camera.screen().x,
+                             1.0f / camera.screen().y);
+
+  glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &_data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void FrameUniforms::cleanup()
+{
+  glDeleteBuffers(1, &_buffer);
+  _buffer = 0;
+}
@@ -0,0 +1,53 @@
+/*****************************************************************************/
+/**
+ * @file frame_uniforms.h
+ * @brief Per-frame camera and light state shared by all shader programs.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef FRAME_UNIFORMS_H_
+#define FRAME_UNIFORMS_H_
+
+#include "gl_globals.h"
+#include "camera.h"
+#include <glm/glm.hpp>
+
+/// name of the uniform block in the shaders
+#define FRAME_UNIFORM_BLOCK "FrameData"
+/// uniform buffer binding point of the FrameData block
+#define FRAME_UNIFORM_BINDING 0
+
+/// memory layout of the FrameData uniform block (std140) in shader/common.glsl
+struct FrameData
+{
+  glm::mat4 MVMatrix;
+  glm::mat4 PMatrix;
+  glm::mat4 MVPMatrix;
+  glm::vec4 lightPos;
+  glm::vec4 viewport;
+};
+
+/**
+ * Uniform buffer object holding FrameData. It is uploaded once per frame
+ * and bound to FRAME_UNIFORM_BINDING, so all programs see the same state
+ * without per-program glUniform calls.
+ */
+class FrameUniforms
+{
+  public:
+    FrameUniforms();
+    int create();
+    /**
+     * Uploads camera matrices, light position (eye space) and viewport.
+     */
+    void update(const Camera& camera, const glm::vec4& lightPos);
+    void cleanup();
+
+    const FrameData& data() const { return _data; }
+
+  private:
+    GLuint _buffer;
+    FrameData _data;
+};
+
+#endif /* FRAME_UNIFORMS_H_ */
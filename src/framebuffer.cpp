@@ -0,0 +1,149 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "framebuffer.h"
+
+//-----------------------------------------------------------------------------
+// pixel transfer format matching an internal format (for allocation only)
+//-----------------------------------------------------------------------------
+static void transferFormat(GLenum internal_format, GLenum* format, GLenum* type)
+{
+  switch (internal_format)
+  {
+  case GL_R32UI:
+    *format = GL_RED_INTEGER;
+    *type = GL_UNSIGNED_INT;
+    break;
+  case GL_R8:
+  case GL_R16F:
+  case GL_R32F:
+    *format = GL_RED;
+    *type = GL_FLOAT;
+    break;
+  default:
+    *format = GL_RGBA;
+    *type = GL_FLOAT;
+  }
+}
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+Framebuffer::Framebuffer()
+  : _fbo(0), _depth(0), _hasDepth(false), _width(0), _height(0)
+{
+}
+Framebuffer::~Framebuffer()
+{
+  // GL objects are released by cleanup() while the context exists
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int Framebuffer::create(int width, int height, const std::vector<GLenum>& formats, bool depth)
+{
+  cleanup();
+  _formats = formats;
+  _hasDepth = depth;
+  _width = width > 0 ? width : 1;
+  _height = height > 0 ? height : 1;
+
+  glGenFramebuffers(1, &_fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+  _textures.assign(formats.size(), 0);
+  std::vector<GLenum> draw_buffers(formats.size());
+  for (size_t i = 0; i < formats.size(); ++i)
+  {
+    GLenum format, type;
+    transferFormat(formats[i], &format, &type);
+    glGenTextures(1, &_textures[i]);
+    glBindTexture(GL_TEXTURE_2D, _textures[i]);
+    glTexImage2D(GL_TEXTURE_2D, 0, formats[i], _width, _height, 0, format, type, NULL);
+    // integer textures cannot be filtered
+    GLint filter = format == GL_RED_INTEGER ? GL_NEAREST : GL_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, _textures[i], 0);
+    draw_buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+  }
+  if (depth)
+  {
+    glGenTextures(1, &_depth);
+    glBindTexture(GL_TEXTURE_2D, _depth);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, _width, _height, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, _depth, 0);
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+  if (!draw_buffers.empty())
+    glDrawBuffers((GLsizei) draw_buffers.size(), &draw_buffers[0]);
+
+  GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  if (status != GL_FRAMEBUFFER_COMPLETE)
+  {
+    fprintf(stderr, "Framebuffer incomplete (0x%x).\n", status);
+    return 1;
+  }
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int Framebuffer::resize(int width, int height)
+{
+  if (_fbo && width == _width && height == _height)
+    return 0;
+  std::vector<GLenum> formats = _formats;
+  return create(width, height, formats, _hasDepth);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Framebuffer::bind()
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+  glViewport(0, 0, _width, _height);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Framebuffer::unbind()
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Framebuffer::blit(unsigned attachment, int width, int height)
+{
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, _fbo);
+  glReadBuffer(GL_COLOR_ATTACHMENT0 + attachment);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  glViewport(0, 0, width, height);
+  glBlitFramebuffer(0, 0, _width, _height, 0, 0, width, height, GL_COLOR_BUFFER_BIT,
+                    width == _width && height == _height ? GL_NEAREST : GL_LINEAR);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Framebuffer::cleanup()
+{
+  if (!_textures.empty())
+    glDeleteTextures((GLsizei) _textures.size(), &_textures[0]);
+  _textures.clear();
+  if (_depth)
+    glDeleteTextures(1, &_depth);
+  _depth = 0;
+  if (_fbo)
+    glDeleteFramebuffers(1, &_fbo);
+  _fbo = 0;
+}
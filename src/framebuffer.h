@@ -0,0 +1,58 @@
+/*****************************************************************************/
+/**
+ * @file framebuffer.h
+ * @brief Offscreen render target with texture attachments.
+ * @date 2026/10/18: Depth texture accessor.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef FRAMEBUFFER_H_
+#define FRAMEBUFFER_H_
+
+#include "gl_globals.h"
+
+#include <vector>
+
+/**
+ * Framebuffer object whose color attachments are textures of the given
+ * internal formats (GL_COLOR_ATTACHMENT0 + i), with an optional depth
+ * texture. While bound, all attachments are draw buffers, so fragment
+ * shader output location i goes to attachment i.
+ */
+class Framebuffer
+{
+  public:
+    Framebuffer();
+    ~Framebuffer();
+    /**
+     * @param formats internal formats of the color attachments, e.g. GL_RGBA8, GL_R32UI
+     * @param depth adds a GL_DEPTH_COMPONENT24 attachment
+     * @retval 0 on success, 1 if the framebuffer is incomplete
+     */
+    int create(int width, int height, const std::vector<GLenum>& formats, bool depth);
+    /// recreates the attachments if the size has changed
+    int resize(int width, int height);
+    void bind();
+    /// binds the default framebuffer
+    void unbind();
+    /// copies a color attachment to the default framebuffer (scaled linearly)
+    void blit(unsigned attachment, int width, int height);
+
+    GLuint id() const { return _fbo; }
+    GLuint texture(unsigned attachment) const { return _textures[attachment]; }
+    /// 0 without depth attachment
+    GLuint depthTexture() const { return _depth; }
+    int width() const { return _width; }
+    int height() const { return _height; }
+    void cleanup();
+
+  private:
+    GLuint _fbo;
+    std::vector<GLuint> _textures;
+    std::vector<GLenum> _formats;
+    GLuint _depth;
+    bool _hasDepth;
+    int _width, _height;
+};
+
+#endif /* FRAMEBUFFER_H_ */
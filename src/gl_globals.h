@@ -37,7 +37,12 @@ typedef unsigned int uint;
 #include <stdio.h>
 
 
+// may be set by the build system (e.g. to the source tree for hot reload)
+#ifndef SHADER_LOCATION
 #define SHADER_LOCATION "shader/"
+#endif
+/// program binaries are stored here (define NO_SHADER_CACHE to disable it)
+#define SHADER_CACHE_LOCATION "shader_cache/"
 
 // define this to disable OpenGL error checking.
 #ifndef NO_CHECK_GLERROR
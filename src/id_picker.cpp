@@ -0,0 +1,140 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "id_picker.h"
+
+#include <algorithm>
+
+/// side length of the window read around the cursor
+#define ID_PICK_SIZE (2 * ID_PICK_RADIUS + 1)
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+IdPicker::IdPicker()
+  : _next(0), _frame(0), _pending(false), _x(0.0f), _y(0.0f)
+{
+  for (unsigned i = 0; i < ID_PICK_SLOTS; ++i)
+  {
+    _slots[i].pbo = 0;
+    _slots[i].fence = 0;
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int IdPicker::create()
+{
+  cleanup();
+  for (unsigned i = 0; i < ID_PICK_SLOTS; ++i)
+  {
+    glGenBuffers(1, &_slots[i].pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, _slots[i].pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, ID_PICK_SIZE * ID_PICK_SIZE * sizeof(GLuint),
+                 NULL, GL_STREAM_READ);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void IdPicker::request(int x, int y, int window_width, int window_height)
+{
+  _x = (x + 0.5f) / std::max(window_width, 1);
+  _y = (y + 0.5f) / std::max(window_height, 1);
+  _pending = true;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void IdPicker::readback(const Framebuffer& framebuffer, unsigned attachment)
+{
+  ++_frame;
+  Slot& slot = _slots[_next];
+  // all slots in flight: keep the request for the next frame
+  if (!_pending || slot.fence)
+    return;
+  const int fx = std::min((int) (_x * framebuffer.width()), framebuffer.width() - 1);
+  const int fy = std::min((int) ((1.0f - _y) * framebuffer.height()), framebuffer.height() - 1);
+  const int x0 = std::max(fx - ID_PICK_RADIUS, 0);
+  const int y0 = std::max(fy - ID_PICK_RADIUS, 0);
+  slot.width = std::min(fx + ID_PICK_RADIUS + 1, framebuffer.width()) - x0;
+  slot.height = std::min(fy + ID_PICK_RADIUS + 1, framebuffer.height()) - y0;
+  slot.x = fx - x0;
+  slot.y = fy - y0;
+  slot.frame = _frame;
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.id());
+  glReadBuffer(GL_COLOR_ATTACHMENT0 + attachment);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+  // into the buffer, returns immediately
+  glReadPixels(x0, y0, slot.width, slot.height, GL_RED_INTEGER, GL_UNSIGNED_INT, 0);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+  slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  _next = (_next + 1) % ID_PICK_SLOTS;
+  _pending = false;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+bool IdPicker::poll(int* sphere, unsigned* frames)
+{
+  // oldest readback first
+  for (unsigned k = 0; k < ID_PICK_SLOTS; ++k)
+  {
+    Slot& slot = _slots[(_next + k) % ID_PICK_SLOTS];
+    if (!slot.fence)
+      continue;
+    GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+      return false;
+    glDeleteSync(slot.fence);
+    slot.fence = 0;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    const GLuint* ids = (const GLuint*) glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+        slot.width * slot.height * sizeof(GLuint), GL_MAP_READ_BIT);
+    // nearest sphere to the cursor within the window
+    *sphere = -1;
+    int best = ID_PICK_SIZE * ID_PICK_SIZE;
+    for (int y = 0; ids && y < slot.height; ++y)
+      for (int x = 0; x < slot.width; ++x)
+      {
+        GLuint id = ids[y * slot.width + x];
+        int d2 = (x - slot.x) * (x - slot.x) + (y - slot.y) * (y - slot.y);
+        if (id != 0 && d2 < best)
+        {
+          best = d2;
+          *sphere = (int) id - 1;
+        }
+      }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    *frames = _frame - slot.frame;
+    return true;
+  }
+  return false;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void IdPicker::cleanup()
+{
+  for (unsigned i = 0; i < ID_PICK_SLOTS; ++i)
+  {
+    if (_slots[i].fence)
+      glDeleteSync(_slots[i].fence);
+    _slots[i].fence = 0;
+    if (_slots[i].pbo)
+      glDeleteBuffers(1, &_slots[i].pbo);
+    _slots[i].pbo = 0;
+  }
+  _next = 0;
+  _pending = false;
+}
@@ -0,0 +1,67 @@
+/*****************************************************************************/
+/**
+ * @file id_picker.h
+ * @brief Picking from a sphere ID render target with asynchronous readback.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef ID_PICKER_H_
+#define ID_PICKER_H_
+
+#include "gl_globals.h"
+#include "framebuffer.h"
+
+/// pixels read around the cursor in each direction
+#define ID_PICK_RADIUS 4
+/// readbacks which may be in flight
+#define ID_PICK_SLOTS 3
+
+/**
+ * Reads sphere IDs (index + 1, 0 for background, written by the SPHERE_ID
+ * shader variant into a GL_R32UI attachment) around the cursor.
+ * The small window is copied into a pixel pack buffer after the frame has
+ * been drawn and a fence is inserted. poll() maps the buffer only once the
+ * fence has signaled, so picking never synchronizes with the GPU; the
+ * result usually arrives one frame later.
+ */
+class IdPicker
+{
+  public:
+    IdPicker();
+    int create();
+    /**
+     * Picks at window coordinates (y from the top, as delivered by GLUT)
+     * in the next frame drawn into the ID framebuffer.
+     * @param window_width, window_height window size, the request is scaled
+     *        to the framebuffer size
+     */
+    void request(int x, int y, int window_width, int window_height);
+    /// after drawing a frame: starts the readback of a pending request
+    void readback(const Framebuffer& framebuffer, unsigned attachment);
+    /**
+     * Collects a finished readback without waiting.
+     * @param[out] sphere sphere nearest to the requested pixel, -1 if none
+     * @param[out] frames frames between readback and result
+     * @retval true if a result was collected
+     */
+    bool poll(int* sphere, unsigned* frames);
+    void cleanup();
+
+  private:
+    struct Slot
+    {
+      GLuint pbo;
+      GLsync fence;
+      int width, height;
+      /// requested pixel within the window read
+      int x, y;
+      unsigned frame;
+    };
+    Slot _slots[ID_PICK_SLOTS];
+    unsigned _next;
+    unsigned _frame;
+    bool _pending;
+    float _x, _y; ///< requested position in [0,1]^2, y from the top
+};
+
+#endif /* ID_PICKER_H_ */
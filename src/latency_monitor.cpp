@@ -0,0 +1,136 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "latency_monitor.h"
+
+#include <algorithm>
+#include <chrono>
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+LatencyMonitor::LatencyMonitor()
+  : _next(0), _lastInput(0), _offset(0), _frames(0),
+    _swapSum(0.0), _presentSum(0.0), _presentMin(1e30), _presentMax(0.0),
+    _count(0), _skipped(0)
+{
+  for (unsigned i = 0; i < LATENCY_QUERIES; ++i)
+  {
+    _queries[i] = 0;
+    _inputTime[i] = _swapTime[i] = 0;
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int LatencyMonitor::create()
+{
+  cleanup();
+  glGenQueries(LATENCY_QUERIES, _queries);
+  calibrate();
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+long long LatencyMonitor::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+//-----------------------------------------------------------------------------
+// the GL query returns when the previous commands have been issued, the
+// CPU time is taken as the middle of the call
+//-----------------------------------------------------------------------------
+void LatencyMonitor::calibrate()
+{
+  GLint64 gpu = 0;
+  long long before = now();
+  glGetInteger64v(GL_TIMESTAMP, &gpu);
+  long long after = now();
+  _offset = before + (after - before) / 2 - (long long) gpu;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void LatencyMonitor::presented(long long input_time)
+{
+  if (_queries[0] == 0)
+    return;
+  long long swapped = now();
+  if (++_frames % LATENCY_CALIBRATION_INTERVAL == 0)
+    calibrate();
+  poll();
+  if (input_time == 0 || input_time == _lastInput)
+    return;
+  _lastInput = input_time;
+
+  if (_inputTime[_next] != 0)
+  {
+    // all queries in flight, GPU is far behind
+    ++_skipped;
+    return;
+  }
+  glQueryCounter(_queries[_next], GL_TIMESTAMP);
+  _inputTime[_next] = input_time;
+  _swapTime[_next] = swapped;
+  _next = (_next + 1) % LATENCY_QUERIES;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void LatencyMonitor::poll()
+{
+  for (unsigned i = 0; i < LATENCY_QUERIES; ++i)
+  {
+    if (_inputTime[i] == 0)
+      continue;
+    GLint available = 0;
+    glGetQueryObjectiv(_queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      continue;
+    GLuint64 gpu = 0;
+    glGetQueryObjectui64v(_queries[i], GL_QUERY_RESULT, &gpu);
+    double present = ((long long) gpu + _offset - _inputTime[i]) * 1e-6;
+    _presentSum += present;
+    _presentMin = std::min(_presentMin, present);
+    _presentMax = std::max(_presentMax, present);
+    _swapSum += (_swapTime[i] - _inputTime[i]) * 1e-6;
+    ++_count;
+    _inputTime[i] = 0;
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void LatencyMonitor::report()
+{
+  if (_count == 0)
+    return;
+  printf("Input latency: swap %.2lf ms, presented %.2lf ms (min %.2lf, max %.2lf), "
+         "%u events", _swapSum / _count, _presentSum / _count,
+         _presentMin, _presentMax, _count);
+  if (_skipped)
+    printf(", %u not measured", _skipped);
+  printf("\n");
+  _swapSum = _presentSum = _presentMax = 0.0;
+  _presentMin = 1e30;
+  _count = _skipped = 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void LatencyMonitor::cleanup()
+{
+  if (_queries[0])
+    glDeleteQueries(LATENCY_QUERIES, _queries);
+  for (unsigned i = 0; i < LATENCY_QUERIES; ++i)
+  {
+    _queries[i] = 0;
+    _inputTime[i] = _swapTime[i] = 0;
+  }
+  _next = 0;
+}
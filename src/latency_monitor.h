@@ -0,0 +1,64 @@
+/*****************************************************************************/
+/**
+ * @file latency_monitor.h
+ * @brief Input-to-photon latency measurement.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef LATENCY_MONITOR_H_
+#define LATENCY_MONITOR_H_
+
+#include "gl_globals.h"
+
+/// frames with input whose timestamp queries may be in flight
+#define LATENCY_QUERIES 8
+/// the GPU clock is mapped to the CPU clock again after this many frames
+#define LATENCY_CALIBRATION_INTERVAL 600
+
+/**
+ * Measures the time from an input event to the presentation of the first
+ * frame that reflects it. After the swap a GL_TIMESTAMP query is issued;
+ * it completes when the GPU has executed the frame including the swap and
+ * is mapped to the CPU clock by a periodic calibration (glGetInteger64v
+ * of GL_TIMESTAMP against now()). Display scanout and compositor delays
+ * are not included. The time until the swap call returned is recorded as
+ * well. Results are read back without stalling, averaged until report().
+ */
+class LatencyMonitor
+{
+  public:
+    LatencyMonitor();
+    int create();
+    /// nanoseconds of a monotonic CPU clock, used to stamp input events
+    static long long now();
+    /**
+     * To be called right after the swap.
+     * @param input_time now() of the input shown by this frame, 0 if none.
+     * The same input time is only measured once.
+     */
+    void presented(long long input_time);
+    /// prints and resets the statistics if there were input events
+    void report();
+    void cleanup();
+
+  private:
+    void calibrate();
+    /// collects finished queries
+    void poll();
+
+  private:
+    GLuint _queries[LATENCY_QUERIES];
+    /// input and swap time of a query in flight, input 0 if free
+    long long _inputTime[LATENCY_QUERIES];
+    long long _swapTime[LATENCY_QUERIES];
+    unsigned _next;
+    long long _lastInput;
+    /// CPU minus GPU clock in ns
+    long long _offset;
+    unsigned _frames;
+    // ms, since the last report()
+    double _swapSum, _presentSum, _presentMin, _presentMax;
+    unsigned _count, _skipped;
+};
+
+#endif /* LATENCY_MONITOR_H_ */
@@ -0,0 +1,349 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Clustered point lights (LIGHTS).
+ * @date 2026/10/18: ViewData block binding for multi-view.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "lod_octree.h"
+#include "clustered_lights.h"
+#include "frame_uniforms.h"
+#include "multi_view.h"
+#include "thread_pool.h"
+
+#include <math.h>
+#include <algorithm>
+#include <utility>
+
+//-----------------------------------------------------------------------------
+// inserts two zero bits after each of the lower 10 bits
+//-----------------------------------------------------------------------------
+static inline unsigned expandBits(unsigned v)
+{
+  v = (v * 0x00010001u) & 0xFF0000FFu;
+  v = (v * 0x00000101u) & 0x0F00F00Fu;
+  v = (v * 0x00000011u) & 0xC30C30C3u;
+  v = (v * 0x00000005u) & 0x49249249u;
+  return v;
+}
+//-----------------------------------------------------------------------------
+// 30 bit Morton code of a point in [0,1]^3
+//-----------------------------------------------------------------------------
+static inline unsigned morton(const glm::vec3& p)
+{
+  unsigned x = (unsigned) std::min(std::max(p.x * 1024.0f, 0.0f), 1023.0f);
+  unsigned y = (unsigned) std::min(std::max(p.y * 1024.0f, 0.0f), 1023.0f);
+  unsigned z = (unsigned) std::min(std::max(p.z * 1024.0f, 0.0f), 1023.0f);
+  return (expandBits(x) << 2) | (expandBits(y) << 1) | expandBits(z);
+}
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+LodOctree::LodOctree()
+  : _count(0), _errorPixels(LOD_ERROR_PIXELS),
+    _vertexBuffer(0), _vertexArray(0),
+    _frames(0), _drawn(0), _proxies(0)
+{
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void LodOctree::build(const ChunkSphere* spheres, unsigned count)
+{
+  _count = count;
+  _nodes.clear();
+  _spheres.clear();
+  if (count == 0)
+    return;
+  ThreadPool& pool = ThreadPool::global();
+
+  glm::vec3 lower(spheres[0].x, spheres[0].y, spheres[0].z), upper = lower;
+  for (unsigned i = 1; i < count; ++i)
+  {
+    glm::vec3 p(spheres[i].x, spheres[i].y, spheres[i].z);
+    lower = glm::min(lower, p);
+    upper = glm::max(upper, p);
+  }
+  const glm::vec3 scale = 1.0f / glm::max(upper - lower, glm::vec3(1e-20f));
+  std::vector<std::pair<unsigned, unsigned> > order(count);
+  pool.parallelFor(0, count, 0, [&](unsigned first, unsigned last) {
+    for (unsigned i = first; i < last; ++i)
+    {
+      glm::vec3 p(spheres[i].x, spheres[i].y, spheres[i].z);
+      order[i] = std::make_pair(morton((p - lower) * scale), i);
+    }
+  });
+  std::sort(order.begin(), order.end());
+
+  std::vector<unsigned> codes(count);
+  _spheres.resize(count);
+  pool.parallelFor(0, count, 0, [&](unsigned first, unsigned last) {
+    for (unsigned i = first; i < last; ++i)
+    {
+      codes[i] = order[i].first;
+      _spheres[i] = spheres[order[i].second];
+    }
+  });
+  std::vector<std::pair<unsigned, unsigned> >().swap(order);
+
+  Node root = { glm::vec3(0.0f), 0.0f, 0.0f, 0, count, -1, 0 };
+  _nodes.push_back(root);
+  std::vector<ChunkSphere> proxies(1);
+  buildNode(0, codes, 0, &proxies);
+  _spheres.insert(_spheres.end(), proxies.begin(), proxies.end());
+}
+//-----------------------------------------------------------------------------
+// splits the node by the next 3 Morton bits, sets bounds and proxy
+//-----------------------------------------------------------------------------
+LodOctree::Aggregate LodOctree::buildNode(unsigned node, const std::vector<unsigned>& codes,
+                                          unsigned level, std::vector<ChunkSphere>* proxies)
+{
+  const unsigned first = _nodes[node].first;
+  const unsigned last = first + _nodes[node].count;
+  Aggregate sum;
+  sum.volume = sum.area = sum.ao = 0.0;
+  for (int k = 0; k < 3; ++k)
+    sum.position[k] = sum.color[k] = 0.0;
+  sum.lower = glm::vec3(1e30f);
+  sum.upper = glm::vec3(-1e30f);
+
+  if (last - first <= LOD_LEAF_SPHERES || level == LOD_MAX_DEPTH)
+  {
+    for (unsigned i = first; i < last; ++i)
+    {
+      const ChunkSphere& s = _spheres[i];
+      double r = s.radius;
+      double volume = r * r * r, area = r * r;
+      sum.volume += volume;
+      sum.area += area;
+      sum.position[0] += volume * s.x;
+      sum.position[1] += volume * s.y;
+      sum.position[2] += volume * s.z;
+      sum.color[0] += area * s.r;
+      sum.color[1] += area * s.g;
+      sum.color[2] += area * s.b;
+      sum.ao += area * s.ao;
+      glm::vec3 p(s.x, s.y, s.z);
+      sum.lower = glm::min(sum.lower, p - glm::vec3(s.radius));
+      sum.upper = glm::max(sum.upper, p + glm::vec3(s.radius));
+    }
+  }
+  else
+  {
+    // children are consecutive ranges of equal code prefix
+    const unsigned mask = (1u << (3 * (LOD_MAX_DEPTH - 1 - level))) - 1;
+    std::vector<std::pair<unsigned, unsigned> > ranges;
+    for (unsigned i = first; i < last;)
+    {
+      unsigned end = (unsigned) (std::upper_bound(codes.begin() + i, codes.begin() + last,
+                                                  codes[i] | mask) - codes.begin());
+      ranges.push_back(std::make_pair(i, end - i));
+      i = end;
+    }
+    unsigned child = (unsigned) _nodes.size();
+    _nodes[node].child = (int) child;
+    _nodes[node].children = (unsigned) ranges.size();
+    for (size_t c = 0; c < ranges.size(); ++c)
+    {
+      Node n = { glm::vec3(0.0f), 0.0f, 0.0f, ranges[c].first, ranges[c].second, -1, 0 };
+      _nodes.push_back(n);
+    }
+    proxies->resize(_nodes.size());
+    for (unsigned c = 0; c < ranges.size(); ++c)
+    {
+      Aggregate a = buildNode(child + c, codes, level + 1, proxies);
+      sum.volume += a.volume;
+      sum.area += a.area;
+      for (int k = 0; k < 3; ++k)
+      {
+        sum.position[k] += a.position[k];
+        sum.color[k] += a.color[k];
+      }
+      sum.ao += a.ao;
+      sum.lower = glm::min(sum.lower, a.lower);
+      sum.upper = glm::max(sum.upper, a.upper);
+    }
+  }
+
+  Node& n = _nodes[node];
+  n.center = 0.5f * (sum.lower + sum.upper);
+  n.radius = 0.5f * glm::length(sum.upper - sum.lower);
+  n.leafRadius = n.radius;
+  for (unsigned c = 0; c < n.children; ++c)
+    n.leafRadius = std::min(n.leafRadius, _nodes[n.child + c].leafRadius);
+  // projected area of the spheres (overlap ignored), at most the node
+  ChunkSphere& proxy = (*proxies)[node];
+  double volume = std::max(sum.volume, 1e-30), area = std::max(sum.area, 1e-30);
+  proxy.x = (float) (sum.position[0] / volume);
+  proxy.y = (float) (sum.position[1] / volume);
+  proxy.z = (float) (sum.position[2] / volume);
+  proxy.radius = std::min(n.radius, (float) sqrt(sum.area));
+  proxy.r = (float) (sum.color[0] / area);
+  proxy.g = (float) (sum.color[1] / area);
+  proxy.b = (float) (sum.color[2] / area);
+  proxy.ao = (float) (sum.ao / area);
+  return sum;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int LodOctree::create()
+{
+  if (_spheres.empty())
+  {
+    printf("LOD octree has not been built.\n");
+    return 1;
+  }
+  glGenBuffers(1, &_vertexBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+  glBufferData(GL_ARRAY_BUFFER, _spheres.size() * sizeof(ChunkSphere), &_spheres[0],
+               GL_STATIC_DRAW);
+
+  const GLsizei stride = sizeof(ChunkSphere);
+  glGenVertexArrays(1, &_vertexArray);
+  glBindVertexArray(_vertexArray);
+  glEnableVertexAttribArray(0); // pos
+  glEnableVertexAttribArray(1); // color
+  glEnableVertexAttribArray(2); // radius
+  glEnableVertexAttribArray(3); // ambient occlusion
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, 0);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)16);
+  glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)12);
+  glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)28);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+
+  _shader.load("sphere_geom.vert", "sphere.frag", "sphere_geom.geom");
+  _shader.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+  _shader.setUniformBlockBinding(VIEW_UNIFORM_BLOCK, VIEW_UNIFORM_BINDING);
+  ClusteredLights::setBindings(_shader);
+  if (_shader.link())
+  {
+    printf("Error occurred.\n");
+    return 1;
+  }
+  printf("LOD octree: %u spheres, %u nodes, %.1f MB.\n", _count, (unsigned) _nodes.size(),
+         _spheres.size() * sizeof(ChunkSphere) / 1048576.0);
+  return 0;
+}
+//-----------------------------------------------------------------------------
+// appends a range of the sphere buffer, merged with the previous one
+//-----------------------------------------------------------------------------
+void LodOctree::addRange(unsigned first, unsigned count)
+{
+  if (!_firsts.empty() && (unsigned) (_firsts.back() + _counts.back()) == first)
+  {
+    _counts.back() += (GLsizei) count;
+    return;
+  }
+  _firsts.push_back((GLint) first);
+  _counts.push_back((GLsizei) count);
+}
+//-----------------------------------------------------------------------------
+// cut of the tree by projected node size
+//-----------------------------------------------------------------------------
+void LodOctree::update(const Camera& camera)
+{
+  _firsts.clear();
+  _counts.clear();
+  if (_nodes.empty())
+    return;
+  const glm::mat4 mvp = camera.mvpmatrix_glm();
+  const glm::mat4 mv = camera.modelview_glm();
+  // pixels per unit of tan(angle) from the view axis
+  const float focal = 0.5f * camera.screen().y * camera.projection_glm()[1][1];
+  // frustum planes (Gribb/Hartmann), normalized
+  glm::vec4 planes[6];
+  for (int k = 0; k < 3; ++k)
+  {
+    glm::vec4 row(mvp[0][k], mvp[1][k], mvp[2][k], mvp[3][k]);
+    glm::vec4 w(mvp[0][3], mvp[1][3], mvp[2][3], mvp[3][3]);
+    planes[2 * k] = w + row;
+    planes[2 * k + 1] = w - row;
+  }
+  for (int k = 0; k < 6; ++k)
+    planes[k] = planes[k] / glm::length(glm::vec3(planes[k].x, planes[k].y, planes[k].z));
+
+  // node and the planes its parent is not completely inside of
+  std::vector<std::pair<unsigned, unsigned> > stack(1, std::make_pair(0u, 63u));
+  while (!stack.empty())
+  {
+    const Node& node = _nodes[stack.back().first];
+    unsigned index = stack.back().first;
+    unsigned planes_mask = stack.back().second;
+    stack.pop_back();
+    bool culled = false;
+    for (int k = 0; k < 6 && !culled; ++k)
+    {
+      if (!(planes_mask & (1u << k)))
+        continue;
+      float d = glm::dot(glm::vec3(planes[k].x, planes[k].y, planes[k].z), node.center)
+                + planes[k].w;
+      culled = d < -node.radius;
+      if (d > node.radius)
+        planes_mask &= ~(1u << k);
+    }
+    if (culled)
+      continue;
+    glm::vec4 eye = mv * glm::vec4(node.center, 1.0f);
+    float distance = glm::length(glm::vec3(eye.x, eye.y, eye.z));
+    // nodes around the camera are refined down to the leaves
+    if (distance > node.radius && 2.0f * focal * node.radius < _errorPixels * distance)
+    {
+      addRange(_count + index, 1);
+      ++_proxies;
+      ++_drawn;
+    }
+    else if (node.child < 0
+             || (planes_mask == 0
+                 && 2.0f * focal * node.leafRadius >= _errorPixels * (distance + node.radius)))
+    {
+      addRange(node.first, node.count);
+      _drawn += node.count;
+    }
+    else
+    {
+      for (unsigned c = node.children; c-- > 0;)
+        stack.push_back(std::make_pair(node.child + c, planes_mask));
+    }
+  }
+  ++_frames;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void LodOctree::draw()
+{
+  if (_firsts.empty())
+    return;
+  _shader.bind();
+  glBindVertexArray(_vertexArray);
+  glMultiDrawArrays(GL_POINTS, &_firsts[0], &_counts[0], (GLsizei) _firsts.size());
+  glBindVertexArray(0);
+  _shader.unbind();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void LodOctree::report()
+{
+  if (_frames == 0)
+    return;
+  printf("LOD octree: %.3fM of %.3fM spheres drawn (%.1f%% proxies), %u ranges, "
+         "error %.1f px\n", _drawn / (1e6 * _frames), _count / 1e6,
+         _drawn ? 100.0 * _proxies / _drawn : 0.0, (unsigned) _firsts.size(), _errorPixels);
+  _frames = 0;
+  _drawn = _proxies = 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void LodOctree::cleanup()
+{
+  glDeleteVertexArrays(1, &_vertexArray);
+  _vertexArray = 0;
+  glDeleteBuffers(1, &_vertexBuffer);
+  _vertexBuffer = 0;
+}
@@ -0,0 +1,106 @@
+/*****************************************************************************/
+/**
+ * @file lod_octree.h
+ * @brief Level of detail by an octree of aggregate proxy spheres.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef LOD_OCTREE_H_
+#define LOD_OCTREE_H_
+
+#include "gl_globals.h"
+#include "camera.h"
+#include "chunk_file.h"
+#include "shader.h"
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+/// nodes with at most this many spheres are not subdivided
+#define LOD_LEAF_SPHERES 64
+/// default projected node diameter in pixels below which the proxy is drawn
+#define LOD_ERROR_PIXELS 2.0f
+/// octree depth limit (10 bits per axis of the Morton codes)
+#define LOD_MAX_DEPTH 10
+
+/**
+ * Octree over a static set of spheres whose nodes carry an aggregate proxy
+ * sphere: volume weighted center, a radius which keeps the summed projected
+ * area of the spheres (at most the node's bounding radius), color and
+ * ambient occlusion averaged by area.
+ *
+ * Spheres are stored in Morton order, so every node covers a contiguous
+ * range, followed by one proxy per node. update() selects a cut of the tree:
+ * a node is drawn as its proxy once its bounds project to less than the
+ * error threshold in pixels, leaves closer than that are drawn with all
+ * their spheres, and nodes around the camera are always refined. Subtrees
+ * inside the frustum which cannot contain a proxy are taken as a whole.
+ * The cut is merged into ranges and drawn by glMultiDrawArrays() with the
+ * geometry shader impostor, so the number of primitives depends on the
+ * screen size and the threshold rather than on the size of the data set.
+ */
+class LodOctree
+{
+  public:
+    LodOctree();
+    /// builds the tree on the CPU (ThreadPool), no context needed
+    void build(const ChunkSphere* spheres, unsigned count);
+    /// uploads spheres and proxies, loads the shader
+    int create();
+    bool isCreated() const { return _vertexArray != 0; }
+    const std::string getDescription() const {
+      return "Spheres Rendering: LOD octree with proxy spheres (Geometry Shader billboards).";
+    }
+    int recompile() { return _shader.reload(); }
+    void setDefine(const char* name, int value) { _shader.setDefine(name, value); }
+    const std::string& variant() const { return _shader.variant(); }
+    /// projected node diameter in pixels below which a node is drawn as proxy
+    void setErrorThreshold(float pixels) { _errorPixels = pixels; }
+    float errorThreshold() const { return _errorPixels; }
+    /// selects the cut for the view
+    void update(const Camera& camera);
+    void draw();
+    /// prints and resets the statistics since the last report()
+    void report();
+    void cleanup();
+
+  private:
+    struct Node
+    {
+      glm::vec3 center; ///< bounding sphere of the spheres in the node
+      float radius;
+      float leafRadius; ///< smallest radius of the leaves below
+      unsigned first, count; ///< range of spheres
+      int child; ///< first of the consecutive children, -1 for leaves
+      unsigned children;
+    };
+    /// sums to merge proxies bottom-up
+    struct Aggregate
+    {
+      double volume, area;
+      double position[3]; ///< weighted by volume
+      double color[3]; ///< weighted by area
+      double ao;
+      glm::vec3 lower, upper;
+    };
+    Aggregate buildNode(unsigned node, const std::vector<unsigned>& codes, unsigned level,
+                        std::vector<ChunkSphere>* proxies);
+    void addRange(unsigned first, unsigned count);
+
+  private:
+    /// spheres in Morton order, then one proxy per node
+    std::vector<ChunkSphere> _spheres;
+    std::vector<Node> _nodes;
+    unsigned _count;
+    float _errorPixels;
+    std::vector<GLint> _firsts;
+    std::vector<GLsizei> _counts;
+    ShaderManager _shader;
+    GLuint _vertexBuffer, _vertexArray;
+    // statistics since the last report()
+    unsigned _frames;
+    unsigned long long _drawn, _proxies;
+};
+
+#endif /* LOD_OCTREE_H_ */
@@ -7,6 +7,27 @@
  *
  * @author Matthias Werner
  * @sa http://11235813tdd.blogspot.de/
+ * @date 2026/10/18: Sphere filter by type and radius (keys g, y, u).
+ * @date 2026/10/18: Colors by a transfer function (keys c, j, k).
+ * @date 2026/10/18: Cascaded shadows of the directional light (option -k, key h).
+ * @date 2026/10/18: Clustered point lights (option -n, keys n, m).
+ * @date 2026/10/18: Multiple views in one layered pass (option -v, key v).
+ * @date 2026/10/18: Translucent spheres by weighted blended OIT (key t).
+ * @date 2026/10/18: Scaled render resolution with upscaling (option -u, keys [ ]).
+ * @date 2026/10/18: Frame time budget controller (option -f).
+ * @date 2026/10/18: LOD octree over generated spheres (option -l, keys , .).
+ * @date 2026/10/18: Out-of-core chunk files (options -c, -p).
+ * @date 2026/10/18: Picking from a sphere ID render target (key i).
+ * @date 2026/10/18: Sphere picking by a BVH (middle click).
+ * @date 2026/10/18: Camera by triple buffer, input latency measurement.
+ * @date 2026/10/18: Render thread fed by frame packets (USE_RENDER_THREAD).
+ * @date 2026/10/18: Dynamic Brownian motion workload (option -s).
+ * @date 2026/10/18: Interpolation between trajectory frames.
+ * @date 2026/10/18: Trajectory playback (options -t, -r).
+ * @date 2026/10/18: Batched renderer (SPHERES=SpheresBatched).
+ * @date 2026/10/18: Shader variants by keys l, z, o.
+ * @date 2026/10/18: Shader hot reload on file changes.
+ * @date 2026/10/18: Frame uniforms in a uniform buffer.
  * @date 2016/03/12: Refactoring of code.
  * @date 2013/04/26: Release.
  * @date 2013/04/02: Initial commit.
@@ -14,7 +35,27 @@
 
 #include "gl_globals.h"
 #include "camera.h"
+#include "camera_snapshot.h"
+#include "clustered_lights.h"
+#include "dynamic_resolution.h"
+#include "latency_monitor.h"
 #include "tools.h"
+#include "frame_uniforms.h"
+#include "framebuffer.h"
+#include "frame_controller.h"
+#include "id_picker.h"
+#include "lod_octree.h"
+#include "multi_view.h"
+#include "out_of_core.h"
+#include "shader_watcher.h"
+#include "sphere_filter.h"
+#include "shadow_map.h"
+#include "streaming_buffer.h"
+#include "transfer_function.h"
+#include "trajectory.h"
+#include "weighted_oit.h"
+#include "simulation.h"
+#include "sphere_bvh.h"
 
 #include "spheres_instancing.h"
 
@@ -24,30 +65,87 @@
 #include "spheres_billboard_tbo.h"
 #include "spheres_point_sprite.h"
 #include "spheres_billboard_geometry_shader.h"
+#include "spheres_batched.h"
 #endif
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <float.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <vector>
 
+#ifdef USE_RENDER_THREAD
+#if !defined(LINUX) && !defined(__linux)
+#error "USE_RENDER_THREAD needs GLX."
+#endif
+#include "frame_queue.h"
+#include <X11/Xlib.h>
+#include <thread>
+#endif
+
+#ifndef NUMBER_SPHERES
 #define NUMBER_SPHERES 100000
+#endif
 #define RADIUS_MEAN 0.005f
 #define RADIUS_VAR 0.06f
+/// largest sphereScalar() of the generated spheres, sqrt(3)
+#define SCALAR_MAX 1.7320508f
 
 #define USE_OPENGL_TIMERS 1
 /// after n-th frame the averages are computed and shown.
 #define BENCHMARK_FRAME_COUNTER 200
 #define FIELD_OF_VIEW 60.0f
+/// default rate of trajectory frames, rendered frames in between are interpolated
+#define TRAJECTORY_FPS 30.0f
+/// fixed time step of the dynamic workload (option -s)
+#define SIMULATION_TIMESTEP (1.0f/60.0f)
+/// spheres within this distance of a picked sphere are reported
+#define PICK_NEIGHBOURHOOD 0.05f
 
 
 //-----------------------------------------------------------------------------
 int initGL(int argc, char** argv);
+int initContext();
+int initScene(const char* trajectory_file, SimulationMode simulation_mode);
 
 void display();
+void renderFrame(const Camera& camera);
 void keyboard(unsigned char key, int x, int y);
 void mouse(int button, int state, int x, int y);
 void motion(int x, int y);
 void reshape(int w, int h);
+void updateTrajectory();
+void buildPickingBVH();
+void buildLodOctree();
+void pickSphere(int x, int y);
+void requestIdPicking(bool enable);
+void requestPick(int x, int y);
+void setIdPicking(bool enable);
+void requestDefine(const char* name, int value);
+void applyDefine(const char* name, int value);
+void setRendererDefine(const char* name, int value);
+void requestLodError(float pixels);
+void applyLodError(float pixels);
+void requestResolutionScale(float scale);
+void applyResolutionScale(float scale);
+int setupFeatures();
+void setupFrameController();
+bool isRequested(const char* name);
+int setupMultiView();
+void requestLightCount(unsigned count);
+void applyLightCount(unsigned count);
+void requestSinglePass(bool single);
+void requestColormapPreset(unsigned preset);
+void requestColormapRange(float max);
+void requestFilter(int type, float min_radius);
+void applyFilter(int type, float min_radius);
+void generateSpheres(std::vector<float>& spheres_host);
+void applyQuality();
+void publishFrame();
 float calculate_fps();
 //-----------------------------------------------------------------------------
 typedef struct
@@ -59,7 +157,76 @@ typedef struct
 } mouse_state_t;
 //-----------------------------------------------------------------------------
 bool recompile = false;
+/// shader variant switches, defaults as in the shaders
+int lighting = 1;
+int write_depth = 1;
+int ambient_occlusion = 1;
+int transparency = 0;
+/// owned by the input callbacks, rendering uses published snapshots
 Camera camera;
+TripleBuffer<CameraSnapshot> cameraSnapshot;
+/// time of the last input event (LatencyMonitor::now())
+long long inputTime = 0;
+LatencyMonitor latency;
+FrameUniforms frameUniforms;
+ShaderWatcher shaderWatcher;
+/// trajectory playback (option -t), two frames resident for interpolation
+TrajectoryPlayer trajectory;
+StreamingBuffer positionStream[2];
+float trajectory_fps = TRAJECTORY_FPS;
+/// dynamic workload (option -s)
+Simulation simulation;
+/// out-of-core data set (option -c), replaces the built-in spheres
+const char* chunk_file = NULL;
+unsigned ooc_pool_mb = OOC_POOL_MB;
+OutOfCoreSpheres outOfCore;
+/// level of detail over generated spheres (option -l), replaces the built-in spheres
+unsigned lod_spheres = 0;
+float lod_error = LOD_ERROR_PIXELS;
+LodOctree lodOctree;
+/// frame time budget in ms (option -f), 0 if off
+float frame_budget = 0.0f;
+/// render side: quality knobs and the settings they reduce
+FrameController frameController;
+int detailKnob = -1, resolutionKnob = -1, shadingKnob = -1;
+float renderLodError = LOD_ERROR_PIXELS;
+float renderResolutionScale = 1.0f;
+/// shader defines as requested by the user, defaults as in the shaders
+std::map<std::string, int> requestedDefines = {
+  { "LIGHTING", 1 }, { "WRITE_DEPTH", 1 }, { "AMBIENT_OCCLUSION", 1 }
+};
+/// static scene on the CPU for picking (input thread only)
+SphereBVH pickingBVH;
+/// pick from the sphere ID render target instead of the BVH (key i)
+int gpu_picking = 0;
+/// rendering side: draw into idFramebuffer (color, sphere ID)
+bool idPicking = false;
+Framebuffer idFramebuffer;
+/// render resolution per axis (option -u, keys '[' ']'), upscaled to the window
+float resolution_scale = 1.0f;
+DynamicResolution dynamicResolution;
+/// translucent spheres (key t), resolved on the rendering side
+WeightedOIT weightedOIT;
+/// views side by side from one layered pass (option -v), 0 off
+unsigned multiview_views = 0;
+int multiview_single_pass = 1;
+MultiView multiView;
+/// animated point lights (option -n, keys 'n' 'm'), 0 off
+unsigned light_count = 0;
+ClusteredLights clusteredLights;
+/// shadows of the directional light (option -k, key h), rendering side
+unsigned shadow_cascades = SHADOW_CASCADES;
+int shadows = 0;
+ShadowMap shadowMap;
+/// colors from the sphere scalar (keys c, j, k), -1 off
+int colormap = -1;
+float colormap_max = SCALAR_MAX;
+TransferFunction transferFunction;
+/// spheres of a type (-1 all) and a minimum radius (keys g, y, u)
+int filter_type = -1;
+float filter_radius = 0.0f;
+SphereFilter sphereFilter;
+IdPicker idPicker;
 mouse_state_t g_mouse = { 0, 0, 0, 0, 0 };
 int width = 800, height = 600;
 float fov = FIELD_OF_VIEW;
@@ -70,6 +237,21 @@ SPHERES<NUMBER_SPHERES> spheres;
 SpheresInstancing<NUMBER_SPHERES> spheres;
 #endif
 
+#ifdef USE_RENDER_THREAD
+int startRenderThread(const char* trajectory_file, SimulationMode simulation_mode);
+void stopRenderThread();
+/// input (GLUT) thread to render thread
+FrameQueue<FramePacket, FRAME_QUEUE_SIZE> frameQueue;
+/// updates collected while the queue is full
+FramePacket pendingPacket;
+bool publishRetry = false;
+std::thread renderThread;
+Display* glxDisplay = NULL;
+GLXDrawable glxDrawable = 0;
+/// shares objects with the GLUT context, current in the render thread only
+GLXContext renderContext = NULL;
+#endif
+
 
 //-----------------------------------------------------------------------------
 //
@@ -78,32 +260,247 @@ void print_help()
 {
   printf("\nKey Mappings:\n ESC\t Exit\n '-'\t reduce FOV by 1.0\n '+'\t increase FOV by 1.0\n"
       " a\t move camera left\n d\t move camera right\n w\t move camera forward\n s\t move camera backward\n"
-      " q\t move target of camera up\n e\t move target of camera down\n r\t recompile shader\n\n");
+      " q\t move target of camera up\n e\t move target of camera down\n r\t recompile shader\n"
+      " l\t cycle lighting model (unlit, diffuse, specular)\n z\t toggle fragment depth\n"
+      " o\t toggle ambient occlusion\n"
+      " t\t toggle translucent spheres (weighted blended OIT)\n"
+      " v\t toggle multi-view in a single pass / one pass per view\n"
+      " n m\t halve/double the number of point lights (0 to %d)\n"
+      " h\t toggle cascaded shadows of the directional light\n"
+      " c\t cycle colors by the sphere scalar (transfer functions, off)\n"
+      " j k\t shrink/grow the scalar range of the transfer function\n"
+      " g\t cycle the sphere type filter (all, type 0 to %d)\n"
+      " y u\t lower/raise the minimum sphere radius of the filter\n"
+      " i\t toggle GPU picking (sphere ID buffer) / CPU picking (BVH)\n"
+      " ',' '.'\t halve/double the LOD error threshold\n"
+      " '[' ']'\t decrease/increase the render resolution scale\n"
+      " middle click\t pick sphere\n\n"
+      "Options:\n -t <file>\t play trajectory (see spheres_shader_tool)\n"
+      " -r <fps>\t trajectory frames per second (default %.0f)\n"
+      " -s cpu|gpu\t simulate Brownian motion on CPU (streamed) or GPU (compute shader)\n"
+      " -c <file>\t stream a chunk file larger than GPU memory (see spheres_shader_tool)\n"
+      " -p <MB>\t GPU page pool of the chunk file (default %u)\n"
+      " -l <n>\t draw n generated spheres through the LOD octree\n"
+      " -f <ms>\t keep the GPU frame time by reducing detail, resolution and shading\n"
+      " -u <scale>\t render at scale * window size and upscale (%.2f to 1)\n"
+      " -v <n>\t render n views side by side, 2 for stereo (up to %d)\n"
+      " -n <n>\t n animated point lights with clustered shading\n"
+      " -k <n>\t shadows with n cascades (1 to %d, default %d)\n\n"
+      "Shaders in '%s' are recompiled automatically when they change.\n\n",
+      LIGHTS_MAX, SPHERE_TYPES - 1, TRAJECTORY_FPS, OOC_POOL_MB, RESOLUTION_SCALE_MIN, MULTIVIEW_MAX_VIEWS,
+      SHADOW_CASCADES_MAX, SHADOW_CASCADES, SHADER_LOCATION);
 }
 //-----------------------------------------------------------------------------
 //
 //-----------------------------------------------------------------------------
 int main(int argc, char** argv)
 {
+  const char* trajectory_file = NULL;
+  SimulationMode simulation_mode = SIMULATION_OFF;
+  for (int i = 1; i < argc - 1; ++i)
+  {
+    if (strcmp(argv[i], "-t") == 0)
+      trajectory_file = argv[i + 1];
+    else if (strcmp(argv[i], "-r") == 0)
+      trajectory_fps = (float) atof(argv[i + 1]);
+    else if (strcmp(argv[i], "-s") == 0)
+      simulation_mode = strcmp(argv[i + 1], "gpu") == 0 ? SIMULATION_GPU : SIMULATION_CPU;
+    else if (strcmp(argv[i], "-c") == 0)
+      chunk_file = argv[i + 1];
+    else if (strcmp(argv[i], "-p") == 0)
+      ooc_pool_mb = (unsigned) atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "-l") == 0)
+      lod_spheres = (unsigned) atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "-f") == 0)
+      frame_budget = (float) atof(argv[i + 1]);
+    else if (strcmp(argv[i], "-u") == 0)
+      resolution_scale = std::min(std::max((float) atof(argv[i + 1]), RESOLUTION_SCALE_MIN), 1.0f);
+    else if (strcmp(argv[i], "-v") == 0)
+      multiview_views = (unsigned) atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "-n") == 0)
+      light_count = std::min((unsigned) atoi(argv[i + 1]), (unsigned) LIGHTS_MAX);
+    else if (strcmp(argv[i], "-k") == 0)
+    {
+      shadow_cascades = (unsigned) atoi(argv[i + 1]);
+      shadows = 1;
+    }
+  }
+#ifdef USE_RENDER_THREAD
+  // Xlib is called from the GLUT and the render thread
+  XInitThreads();
+#endif
+  // moving spheres are not tracked on the CPU, chunk files are not resident
+  if (lod_spheres > 0)
+    buildLodOctree();
+  else if (trajectory_file == NULL && simulation_mode == SIMULATION_OFF && chunk_file == NULL
+           && spheres.matchesHostSpheres())
+    buildPickingBVH();
+
   if (initGL(argc, argv) != 0)
   {
     fprintf(stderr, "Unable to init OpenGL.");
     return EXIT_FAILURE;
   }
-
+#ifdef USE_RENDER_THREAD
+  // GL resources are created by the render thread in its own context
+  if (startRenderThread(trajectory_file, simulation_mode) != 0)
+    return EXIT_FAILURE;
+#else
+  if (initContext() != 0 || initScene(trajectory_file, simulation_mode) != 0)
+    return EXIT_FAILURE;
+#endif
+  glutMainLoop();
+  return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
+// creates the spheres and the position source, needs a current context
+//-----------------------------------------------------------------------------
+int initScene(const char* trajectory_file, SimulationMode simulation_mode)
+{
+  if (chunk_file)
+  {
+    if (trajectory_file || simulation_mode != SIMULATION_OFF)
+    {
+      fprintf(stderr, "Chunk files cannot be combined with trajectories or simulation.\n");
+      return 1;
+    }
+    if (outOfCore.create(chunk_file, ooc_pool_mb) != 0)
+      return 1;
+    if (setupFeatures() != 0)
+      return 1;
+    print_help();
+    printf("%s\n", outOfCore.getDescription().c_str());
+    printf("\nAvg1\t\tAvg2\t\tMin1\t\tMin2\t\tMax1\t\tMax2\n");
+    return 0;
+  }
+  if (lod_spheres > 0)
+  {
+    if (chunk_file || trajectory_file || simulation_mode != SIMULATION_OFF)
+    {
+      fprintf(stderr, "The LOD octree cannot be combined with chunk files, trajectories or simulation.\n");
+      return 1;
+    }
+    if (lodOctree.create() != 0)
+      return 1;
+    if (setupFeatures() != 0)
+      return 1;
+    print_help();
+    printf("%s\n", lodOctree.getDescription().c_str());
+    printf("\nAvg1\t\tAvg2\t\tMin1\t\tMin2\t\tMax1\t\tMax2\n");
+    return 0;
+  }
   if (spheres.create(RADIUS_MEAN, RADIUS_VAR) != 0)
   {
     fprintf(stderr, "Unable to create spheres.");
-    return EXIT_FAILURE;
+    return 1;
+  }
+  if (simulation_mode != SIMULATION_OFF)
+  {
+    if (simulation.create(simulation_mode, NUMBER_SPHERES) != 0
+        || spheres.setPositionSource(simulation.positionBuffer(), simulation.positionOffset()) != 0)
+      return 1;
   }
+  else if (trajectory_file)
+  {
+    if (trajectory.open(trajectory_file) != 0)
+      return 1;
+    if (trajectory.numSpheres() != NUMBER_SPHERES)
+    {
+      fprintf(stderr, "Trajectory has %u spheres, renderer is built for %u (NUMBER_SPHERES).\n",
+              trajectory.numSpheres(), (unsigned) NUMBER_SPHERES);
+      return 1;
+    }
+    if (positionStream[0].create(3 * sizeof(float) * NUMBER_SPHERES) != 0
+        || positionStream[1].create(3 * sizeof(float) * NUMBER_SPHERES) != 0)
+      return 1;
+  }
+  if (setupFeatures() != 0)
+    return 1;
   printf("Spheres Renderer Benchmark 2013/04/26 - Update 2016/03/12.\n");
   print_help();
 
   printf("%s\n", spheres.getDescription().c_str());
 
   printf("\nAvg1\t\tAvg2\t\tMin1\t\tMin2\t\tMax1\t\tMax2\n");
-  glutMainLoop();
-  return EXIT_SUCCESS;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+// static scene on the CPU for picking
+//-----------------------------------------------------------------------------
+void buildPickingBVH()
+{
+  std::vector<float> spheres_host;
+  generateSpheres(spheres_host);
+  pickingBVH.build(&spheres_host[0], 4, &spheres_host[3], 4, NUMBER_SPHERES);
+}
+//-----------------------------------------------------------------------------
+// host copy of the sphere centers and radii, same sequence as the renderers
+// (see Spheres::matchesHostSpheres())
+//-----------------------------------------------------------------------------
+void generateSpheres(std::vector<float>& spheres_host)
+{
+  srand(2013);
+  spheres_host.resize(4 * NUMBER_SPHERES);
+  for (unsigned i = 0; i < NUMBER_SPHERES; ++i)
+  {
+    spheres_host[4 * i] = mrand(-1.f, 1.f);
+    spheres_host[4 * i + 1] = mrand(-1.f, 1.f);
+    spheres_host[4 * i + 2] = mrand(-1.f, 1.f);
+    mrand(0.f, 1.f); mrand(0.f, 1.f); mrand(0.f, 1.f); // color
+    spheres_host[4 * i + 3] = RADIUS_VAR * rand() / RAND_MAX + RADIUS_MEAN;
+  }
+}
+//-----------------------------------------------------------------------------
+// generated spheres with the renderers' distribution, any number of them
+//-----------------------------------------------------------------------------
+void buildLodOctree()
+{
+  srand(2013);
+  std::vector<ChunkSphere> spheres_host(lod_spheres);
+  for (unsigned i = 0; i < lod_spheres; ++i)
+  {
+    ChunkSphere& s = spheres_host[i];
+    s.x = mrand(-1.f, 1.f);
+    s.y = mrand(-1.f, 1.f);
+    s.z = mrand(-1.f, 1.f);
+    s.r = mrand(0.f, 1.f);
+    s.g = mrand(0.f, 1.f);
+    s.b = mrand(0.f, 1.f);
+    s.radius = RADIUS_VAR * rand() / RAND_MAX + RADIUS_MEAN;
+  }
+  float* data = &spheres_host[0].x;
+  const unsigned stride = sizeof(ChunkSphere) / sizeof(float);
+  computeAmbientOcclusion(data, stride, data + 3, stride, data + 7, stride, lod_spheres);
+  lodOctree.build(&spheres_host[0], lod_spheres);
+}
+//-----------------------------------------------------------------------------
+// prints the sphere under the cursor and the size of its neighbourhood
+//-----------------------------------------------------------------------------
+void pickSphere(int x, int y)
+{
+  if (pickingBVH.size() == 0)
+  {
+    if (!spheres.matchesHostSpheres())
+      printf("CPU picking is not supported by '%s'.\n", spheres.getDescription().c_str());
+    else
+      printf("Picking is not available for moving or streamed spheres.\n");
+    return;
+  }
+  glm::vec3 origin, direction;
+  camera.pickRay(x, y, &origin, &direction);
+  float distance = 0.0f;
+  int hit = pickingBVH.pick(origin, direction, &distance);
+  if (hit < 0)
+  {
+    printf("No sphere picked.\n");
+    return;
+  }
+  glm::vec3 p = origin + distance * direction;
+  std::vector<unsigned> neighbours;
+  pickingBVH.querySphere(p, PICK_NEIGHBOURHOOD, &neighbours);
+  printf("Picked sphere %d at distance %.3f, hit point (%.3f, %.3f, %.3f), "
+         "%u spheres within %.2f.\n", hit, distance, p.x, p.y, p.z,
+         (unsigned) neighbours.size(), PICK_NEIGHBOURHOOD);
 }
 //-----------------------------------------------------------------------------
 // init OpenGL, mostly GLUT-related stuff here
@@ -129,12 +526,29 @@ int initGL(int argc, char **argv)
     return 1;
   }
 
-  initTools((bool)USE_OPENGL_TIMERS);
-
   // default initialization
   camera.setupCamera(4.0f, 3.0f, 1.0f, 1.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.0);
   camera.applyProjection(fov, width, height);
   camera.apply();
+  publishFrame();
+  return 0;
+}
+//-----------------------------------------------------------------------------
+// timers, shared uniforms and default state of the current context
+//-----------------------------------------------------------------------------
+int initContext()
+{
+  initTools((bool)USE_OPENGL_TIMERS);
+
+  if (frameUniforms.create() != 0 || latency.create() != 0 || idPicker.create() != 0
+      || dynamicResolution.create() != 0 || clusteredLights.create() != 0
+      || shadowMap.create(shadow_cascades) != 0 || transferFunction.create() != 0)
+    return 1;
+  applyResolutionScale(resolution_scale);
+  transferFunction.setRange(0.0f, colormap_max);
+  // optional, without it the spheres stay opaque
+  weightedOIT.create();
+  shaderWatcher.start(SHADER_LOCATION);
 
   glEnable(GL_DEPTH_TEST);
   //glEnable(GL_DEPTH_CLAMP);
@@ -150,6 +564,65 @@ int initGL(int argc, char **argv)
 //-----------------------------------------------------------------------------
 void display()
 {
+#ifndef USE_RENDER_THREAD
+  cameraSnapshot.update();
+  const CameraSnapshot& view = cameraSnapshot.front();
+  renderFrame(view.camera);
+  glutPostRedisplay();
+  glutSwapBuffers();
+  latency.presented(view.input_time);
+
+#if USE_OPENGL_TIMERS==0
+  char sfps[32];
+  sprintf(sfps, "FPS: %.1f", calculate_fps());
+  glutSetWindowTitle(sfps);
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    exit(1);
+#endif
+#endif
+}
+//-----------------------------------------------------------------------------
+// draws one frame seen by the given camera (without swapping)
+//-----------------------------------------------------------------------------
+void renderFrame(const Camera& window_view)
+{
+  // scaled frames are seen by a camera of the render target size
+  const glm::ivec2 window = window_view.screen();
+  const bool transparent = isRequested("TRANSPARENCY");
+  const bool shadowed = isRequested("SHADOWS");
+  const bool colormapped = isRequested("COLORMAP");
+  const bool multiview = multiView.views() > 0;
+  // no sphere IDs from translucent spheres or the views
+  const bool picking = idPicking && !transparent && !multiview;
+  const bool scaled = !picking && !multiview && dynamicResolution.scale() < 1.0f;
+  Camera view = window_view;
+  if (multiview)
+  {
+    const glm::ivec2 size = multiView.viewSize(window.x, window.y);
+    view.setScreen(size.x, size.y);
+  }
+  else if (scaled)
+  {
+    const glm::ivec2 size = dynamicResolution.targetSize(window.x, window.y);
+    view.setScreen(size.x, size.y);
+  }
+  // simulated before the frame timers start, so render times stay separate
+  if (simulation.mode() != SIMULATION_OFF)
+  {
+    simulation.step(SIMULATION_TIMESTEP);
+    spheres.setPositionSource(simulation.positionBuffer(), simulation.positionOffset());
+  }
+  // before the shadow pass, which draws the same positions
+  if (trajectory.isOpen())
+    updateTrajectory();
+  else if (trajectory.hasFailed())
+  {
+    // the last uploaded frame stays on screen
+    printf("Trajectory playback stopped.\n");
+    trajectory.close();
+  }
+  // only if changed, the draws read the count from the GPU
+  sphereFilter.update();
 #if USE_OPENGL_TIMERS==1
   static uint cbuffer = 0xffff;
   static uint lbuffer = 0;
@@ -157,6 +630,11 @@ void display()
   static double avgt1=0.0, avgt2=0.0;
   static double mint1=999999.0, mint2=999999.0, maxt1=0.0, maxt2=0.0;
   static uint framecounter = BENCHMARK_FRAME_COUNTER;
+  static float lscale = 1.0f;
+  static bool ltransparent = false;
+  static bool lsingle = true;
+  static unsigned llights = 0;
+  static bool lshadowed = false;
   double eltime1, eltime2;
 
   if(cbuffer==0xffff) // first frame
@@ -175,6 +653,14 @@ void display()
       maxt1=eltime1;
     if(eltime2>maxt2)
       maxt2=eltime2;
+    // whole frame, measured from the end of the previous one
+    dynamicResolution.record(lscale, eltime1);
+    weightedOIT.record(ltransparent, eltime1);
+    multiView.record(lsingle, eltime1);
+    clusteredLights.record(llights, eltime1);
+    shadowMap.record(lshadowed, eltime1);
+    if (frameController.update(eltime1))
+      applyQuality();
     if(--framecounter==0)
     {
       framecounter = BENCHMARK_FRAME_COUNTER;
@@ -184,6 +670,17 @@ void display()
         mint1, mint2,
         maxt1, maxt2
        );
+      simulation.report();
+      outOfCore.report();
+      lodOctree.report();
+      frameController.report();
+      dynamicResolution.report();
+      weightedOIT.report();
+      multiView.report();
+      clusteredLights.report();
+      shadowMap.report();
+      sphereFilter.report();
+      latency.report();
       avgt1 = 0.0;
       avgt2 = 0.0;
       mint1 = mint2 = 999999.0;
@@ -193,35 +690,164 @@ void display()
   // here we start measuring the frame drawing time
   // (will be read into eltime1 next frame)
   gpuTimerStart(cbuffer);
+  lscale = scaled ? dynamicResolution.scale() : 1.0f;
+  ltransparent = transparent;
+  lsingle = multiView.singlePass();
+  llights = clusteredLights.count();
+  lshadowed = shadowed;
 #endif
+  std::string modified;
+  if (shaderWatcher.poll(&modified))
+  {
+    printf("'%s' modified.\n", modified.c_str());
+    recompile = true;
+  }
   if (recompile)
   {
+    // compiles in the background, errors keep the previous shader running
     printf("Recompile...\n");
-    if(spheres.recompile()!=0)
-      exit(EXIT_FAILURE);
+    if((outOfCore.isOpen() ? outOfCore.recompile()
+        : lodOctree.isCreated() ? lodOctree.recompile() : spheres.recompile())!=0)
+      printf("Recompile failed, keeping previous shader.\n");
+    dynamicResolution.recompile();
+    if (weightedOIT.isCreated())
+      weightedOIT.recompile();
 
     recompile = false;
   }
 
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  glm::vec4 lightPos = view.modelview_glm() * glm::vec4(1.5,2.5,1.5,0.0);
+  if (colormapped)
+    transferFunction.bind();
+  if (shadowed)
+  {
+    // casters from the light with the renderer's buffers, one layer per cascade
+    shadowMap.update(view, glm::vec3(1.5f, 2.5f, 1.5f));
+    shadowMap.bind();
+    // the map is only cleared (nothing shadowed) while the program compiles
+    if (spheres.bindShadowPass(shadowMap.cascades()))
+    {
+      spheres();
+      spheres.unbind();
+    }
+    shadowMap.unbind(window.x, window.y);
+    shadowMap.bindTexture();
+  }
+
+  const glm::ivec2 screen = view.screen();
+  if (multiview)
+  {
+    if (multiView.bind(screen.x, screen.y) != 0)
+      exit(1);
+  }
+  else if (scaled)
+  {
+    if (dynamicResolution.bind(screen.x, screen.y) != 0)
+      exit(1);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  }
+  else if (picking)
+  {
+    if (idFramebuffer.resize(screen.x, screen.y) != 0)
+      exit(1);
+    idFramebuffer.bind();
+    const GLfloat clear_color[] = { 0.9f, 0.9f, 0.9f, 1.0f };
+    const GLuint clear_id[] = { 0, 0, 0, 0 };
+    const GLfloat clear_depth = 1.0f;
+    glClearBufferfv(GL_COLOR, 0, clear_color);
+    glClearBufferuiv(GL_COLOR, 1, clear_id);
+    glClearBufferfv(GL_DEPTH, 0, &clear_depth);
+  }
+  else
+  {
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  }
   glEnable(GL_DEPTH_TEST);
-  glm::vec4 lightPos = camera.modelview_glm() * glm::vec4(1.5,2.5,1.5,0.0);
+  // camera and light are shared by all programs via uniform buffer
+  frameUniforms.update(view, lightPos);
+  if (multiview)
+    multiView.update(view);
+  const bool lit = clusteredLights.count() > 0;
+  if (lit)
+  {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    clusteredLights.update(view, std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count());
+    clusteredLights.bind();
+  }
   // --- SPHERES ---
+  if (transparent && weightedOIT.bind(screen.x, screen.y) != 0)
+    exit(1);
 
 #if NUMBER_SPHERES>0
 #if USE_OPENGL_TIMERS==1
   gpuTimerStart(cbuffer);
 #endif
 
-  spheres.bind(&lightPos.x, camera);
+  if (outOfCore.isOpen())
+  {
+    outOfCore.update(view);
+#if USE_OPENGL_TIMERS==1
+    gpuTimerStop(cbuffer);
+#endif
+    for (unsigned pass = 0; multiView.setPass(pass); ++pass)
+      outOfCore.draw();
+  }
+  else if (lodOctree.isCreated())
+  {
+    lodOctree.update(view);
+#if USE_OPENGL_TIMERS==1
+    gpuTimerStop(cbuffer);
+#endif
+    for (unsigned pass = 0; multiView.setPass(pass); ++pass)
+      lodOctree.draw();
+  }
+  else
+  {
+    spheres.bind(&lightPos.x, view);
 
 #if USE_OPENGL_TIMERS==1
-  gpuTimerStop(cbuffer);
+    gpuTimerStop(cbuffer);
 #endif
 
-  spheres();
+    for (unsigned pass = 0; multiView.setPass(pass); ++pass)
+      spheres();
 
-  spheres.unbind();
+    spheres.unbind();
+  }
+  if (lit)
+    clusteredLights.unbind();
+  if (shadowed)
+    shadowMap.unbindTexture();
+  if (colormapped)
+    transferFunction.unbind();
+  if (transparent)
+    weightedOIT.composite();
+  if (multiview)
+    multiView.present(window.x, window.y);
+  if (scaled)
+    dynamicResolution.upscale(window.x, window.y);
+  if (picking)
+  {
+    // the pick reads this frame, results arrive without stalling
+    idPicker.readback(idFramebuffer, 1);
+    idFramebuffer.blit(0, screen.x, screen.y);
+    idFramebuffer.unbind();
+    int sphere;
+    unsigned frames;
+    while (idPicker.poll(&sphere, &frames))
+    {
+      if (sphere >= 0)
+        printf("GPU pick: sphere %d (%u frames later).\n", sphere, frames);
+      else
+        printf("GPU pick: no sphere (%u frames later).\n", frames);
+    }
+  }
+  if (trajectory.isOpen())
+  {
+    positionStream[0].fence();
+    positionStream[1].fence();
+  }
+  simulation.fence();
 
   if (CHECK_GLERROR() != GL_NO_ERROR)
     exit(1);
@@ -233,25 +859,559 @@ void display()
   lbuffer = cbuffer;
   cbuffer = cbuffer==0 ? 1 : 0;
 #endif
-  glutPostRedisplay();
-  glutSwapBuffers();
+}
+//-----------------------------------------------------------------------------
+// uploads trajectory frames at trajectory_fps, the renderer blends between
+// the previous and the newest frame (each resident in its own stream)
+//-----------------------------------------------------------------------------
+void updateTrajectory()
+{
+  static std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+  static float blend = 1.0f; // 1: next frame is due
+  static GLintptr offsets[2] = { 0, 0 };
+  static int newest = -1;
 
-#if USE_OPENGL_TIMERS==0
-  char sfps[32];
-  sprintf(sfps, "FPS: %.1f", calculate_fps());
-  glutSetWindowTitle(sfps);
-  if (CHECK_GLERROR() != GL_NO_ERROR)
-    exit(1);
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  blend += std::chrono::duration<float>(now - last).count() * trajectory_fps;
+  last = now;
+  if (blend >= 1.0f)
+  {
+    // keep the newest frame if the decoder is behind
+    const float* positions = trajectory.acquire();
+    if (positions)
+    {
+      int stream = newest < 0 ? 0 : 1 - newest;
+      offsets[stream] = positionStream[stream].upload(positions, 3 * sizeof(float) * NUMBER_SPHERES);
+      trajectory.release();
+      int previous = newest < 0 ? stream : newest;
+      newest = stream;
+      spheres.setPositionSource(positionStream[previous].id(), offsets[previous],
+                                positionStream[newest].id(), offsets[newest]);
+      blend = std::min(blend - 1.0f, 1.0f);
+    }
+    else
+    {
+      blend = 1.0f;
+    }
+  }
+  spheres.setPositionBlend(blend);
+}
+//-----------------------------------------------------------------------------
+// selects a shader variant, applied by the thread owning the context
+//-----------------------------------------------------------------------------
+void requestDefine(const char* name, int value)
+{
+#ifdef USE_RENDER_THREAD
+  pendingPacket.defines.push_back(std::make_pair(std::string(name), value));
+#else
+  applyDefine(name, value);
+#endif
+}
+//-----------------------------------------------------------------------------
+// rendering side of requestDefine()
+//-----------------------------------------------------------------------------
+void applyDefine(const char* name, int value)
+{
+  // the scene is owned by this thread, so support is checked here
+  const bool streamed = outOfCore.isOpen() || lodOctree.isCreated();
+  if (value != 0 && strcmp(name, "TRANSPARENCY") == 0 && !spheres.isImpostor() && !streamed)
+  {
+    printf("Transparency is not supported by '%s'.\n", spheres.getDescription().c_str());
+    return;
+  }
+  if (value != 0 && strcmp(name, "TRANSPARENCY") == 0
+      && (!weightedOIT.isCreated() || multiView.views() > 0))
+  {
+    printf("Transparency is not supported by this context or with multiple views.\n");
+    return;
+  }
+  if (value != 0 && strcmp(name, "COLORMAP") == 0 && (streamed || !spheres.supportsColormap()))
+  {
+    printf("Colormapping is not supported by '%s'.\n", streamed
+           ? "streamed or LOD spheres" : spheres.getDescription().c_str());
+    return;
+  }
+  if (value != 0 && strcmp(name, "SHADOWS") == 0
+      && (streamed || !spheres.supportsShadowPass()))
+  {
+    printf("Shadows are not supported by '%s'.\n", streamed
+           ? "streamed or LOD spheres" : spheres.getDescription().c_str());
+    return;
+  }
+  // the shadow matrices map the eye space of the central camera only
+  if (value != 0 && strcmp(name, "SHADOWS") == 0 && multiView.views() > 0)
+  {
+    printf("Shadows are not supported with multiple views.\n");
+    return;
+  }
+  requestedDefines[name] = value;
+  setRendererDefine(name, value);
+}
+//-----------------------------------------------------------------------------
+// LOD error threshold, applied by the thread owning the octree
+//-----------------------------------------------------------------------------
+void requestLodError(float pixels)
+{
+  printf("LOD error threshold: %.2f px\n", pixels);
+#ifdef USE_RENDER_THREAD
+  pendingPacket.lod_error = pixels;
+#else
+  applyLodError(pixels);
+#endif
+}
+//-----------------------------------------------------------------------------
+// rendering side of requestLodError()
+//-----------------------------------------------------------------------------
+void applyLodError(float pixels)
+{
+  renderLodError = pixels;
+  applyQuality();
+}
+//-----------------------------------------------------------------------------
+// render resolution scale, applied by the render thread
+//-----------------------------------------------------------------------------
+void requestResolutionScale(float scale)
+{
+  printf("Resolution scale: %.3f\n", scale);
+#ifdef USE_RENDER_THREAD
+  pendingPacket.resolution_scale = scale;
+#else
+  applyResolutionScale(scale);
+#endif
+}
+//-----------------------------------------------------------------------------
+// rendering side of requestResolutionScale()
+//-----------------------------------------------------------------------------
+void applyResolutionScale(float scale)
+{
+  renderResolutionScale = scale;
+  applyQuality();
+}
+//-----------------------------------------------------------------------------
+// options that need the created scene, on the rendering side
+//-----------------------------------------------------------------------------
+int setupFeatures()
+{
+  setupFrameController();
+  if (setupMultiView() != 0)
+    return 1;
+  if (light_count > 0)
+    applyLightCount(light_count);
+  if (shadows)
+    applyDefine("SHADOWS", 1);
+  return 0;
+}
+//-----------------------------------------------------------------------------
+// define as requested by the user, before frame budget reductions
+//-----------------------------------------------------------------------------
+bool isRequested(const char* name)
+{
+  std::map<std::string, int>::const_iterator define = requestedDefines.find(name);
+  return define != requestedDefines.end() && define->second != 0;
+}
+//-----------------------------------------------------------------------------
+// knobs of the frame budget in the order they are reduced
+//-----------------------------------------------------------------------------
+void setupFrameController()
+{
+  if (frame_budget <= 0.0f)
+    return;
+  frameController.setTarget(frame_budget);
+  // fewer streamed spheres or coarser octree cut, detail of sub-pixel spheres goes first
+  if (outOfCore.isOpen() || lodOctree.isCreated())
+    detailKnob = (int) frameController.addKnob("detail", 4);
+  resolutionKnob = (int) frameController.addKnob("resolution", 3);
+  shadingKnob = (int) frameController.addKnob("shading", 4);
+  printf("Frame budget: %.2f ms\n", frame_budget);
+}
+/// shading level of the frame budget from which a feature is switched off
+static const struct { const char* name; unsigned level; } shadingFeatures[] = {
+  { "AMBIENT_OCCLUSION", 1 }, { "LIGHTING", 2 }, { "WRITE_DEPTH", 3 }
+};
+//-----------------------------------------------------------------------------
+// applies the knob levels to the requested settings
+//-----------------------------------------------------------------------------
+void applyQuality()
+{
+  const float detail = detailKnob < 0 ? 1.0f
+      : (float) (1u << frameController.level((unsigned) detailKnob));
+  lodOctree.setErrorThreshold(renderLodError * detail);
+  outOfCore.setSpheresPerPixel(OOC_SPHERES_PER_PIXEL / detail);
+  // 1, 0.75, 0.5 of the requested scale
+  const float resolution = resolutionKnob < 0 ? 1.0f
+      : 1.0f - 0.25f * frameController.level((unsigned) resolutionKnob);
+  dynamicResolution.setScale(renderResolutionScale * resolution);
+  if (shadingKnob < 0)
+    return;
+  for (size_t i = 0; i < sizeof(shadingFeatures) / sizeof(shadingFeatures[0]); ++i)
+    setRendererDefine(shadingFeatures[i].name, requestedDefines[shadingFeatures[i].name]);
+}
+//-----------------------------------------------------------------------------
+// sets a define of the active renderer, reduced by the frame budget
+//-----------------------------------------------------------------------------
+void setRendererDefine(const char* name, int value)
+{
+  const unsigned level = shadingKnob < 0 ? 0 : frameController.level((unsigned) shadingKnob);
+  for (size_t i = 0; i < sizeof(shadingFeatures) / sizeof(shadingFeatures[0]); ++i)
+  {
+    if (level >= shadingFeatures[i].level && strcmp(name, shadingFeatures[i].name) == 0)
+      value = 0;
+  }
+  if (outOfCore.isOpen())
+  {
+    outOfCore.setDefine(name, value);
+    printf("Shader variant: %s\n", outOfCore.variant().c_str());
+    return;
+  }
+  if (lodOctree.isCreated())
+  {
+    lodOctree.setDefine(name, value);
+    printf("Shader variant: %s\n", lodOctree.variant().c_str());
+    return;
+  }
+  spheres.setDefine(name, value);
+  printf("Shader variant: %s\n", spheres.variant().c_str());
+}
+//-----------------------------------------------------------------------------
+// layered views of the renderers that expand in sphere_geom.geom
+//-----------------------------------------------------------------------------
+int setupMultiView()
+{
+  if (multiview_views == 0)
+    return 0;
+  if (!outOfCore.isOpen() && !lodOctree.isCreated() && !spheres.supportsMultiView())
+  {
+    printf("Multi-view is not supported by '%s'.\n", spheres.getDescription().c_str());
+    return 0;
+  }
+  if (multiView.create(multiview_views) != 0)
+    return 1;
+  applyDefine("MULTIVIEW", (int) multiview_views);
+  return 0;
+}
+//-----------------------------------------------------------------------------
+// number of point lights, applied by the render thread
+//-----------------------------------------------------------------------------
+void requestLightCount(unsigned count)
+{
+  printf("Point lights: %u\n", count);
+#ifdef USE_RENDER_THREAD
+  pendingPacket.light_count = (int) count;
+#else
+  applyLightCount(count);
+#endif
+}
+//-----------------------------------------------------------------------------
+// rendering side of requestLightCount()
+//-----------------------------------------------------------------------------
+void applyLightCount(unsigned count)
+{
+  if (!outOfCore.isOpen() && !lodOctree.isCreated() && !spheres.isImpostor())
+  {
+    printf("Point lights are not supported by '%s'.\n", spheres.getDescription().c_str());
+    return;
+  }
+  // the light grid and the light positions follow the central camera only
+  if (count > 0 && multiView.views() > 0)
+  {
+    printf("Point lights are not supported with multiple views.\n");
+    return;
+  }
+  const bool was_lit = clusteredLights.count() > 0;
+  clusteredLights.setCount(count);
+  if (was_lit != (count > 0))
+    applyDefine("LIGHTS", count > 0 ? 1 : 0);
+}
+//-----------------------------------------------------------------------------
+// multi-view in one pass or one pass per view, applied by the render thread
+//-----------------------------------------------------------------------------
+void requestSinglePass(bool single)
+{
+  printf("Multi-view: %s\n", single ? "single pass" : "one pass per view");
+#ifdef USE_RENDER_THREAD
+  pendingPacket.single_pass = single ? 1 : 0;
+#else
+  multiView.setSinglePass(single);
+#endif
+}
+//-----------------------------------------------------------------------------
+// transfer function table, applied by the render thread
+//-----------------------------------------------------------------------------
+void requestColormapPreset(unsigned preset)
+{
+  printf("Transfer function: %s\n", TransferFunction::presetName(preset));
+#ifdef USE_RENDER_THREAD
+  pendingPacket.colormap_preset = (int) preset;
+#else
+  transferFunction.setPreset(preset);
+#endif
+}
+//-----------------------------------------------------------------------------
+// scalar range of the transfer function, a uniform update only
+//-----------------------------------------------------------------------------
+void requestColormapRange(float max)
+{
+  printf("Transfer function range: [0, %.3f]\n", max);
+#ifdef USE_RENDER_THREAD
+  pendingPacket.colormap_max = max;
+#else
+  transferFunction.setRange(0.0f, max);
+#endif
+}
+//-----------------------------------------------------------------------------
+// sphere filter by type and radius, applied by the render thread
+//-----------------------------------------------------------------------------
+void requestFilter(int type, float min_radius)
+{
+  if (type < 0)
+    printf("Filter: all types, radius >= %.4f\n", min_radius);
+  else
+    printf("Filter: type %d, radius >= %.4f\n", type, min_radius);
+#ifdef USE_RENDER_THREAD
+  pendingPacket.filter = true;
+  pendingPacket.filter_type = type;
+  pendingPacket.filter_radius = min_radius;
+#else
+  applyFilter(type, min_radius);
+#endif
+}
+//-----------------------------------------------------------------------------
+// rendering side of requestFilter(), the filter is created on first use
+//-----------------------------------------------------------------------------
+void applyFilter(int type, float min_radius)
+{
+  if (!sphereFilter.isCreated())
+  {
+    if (outOfCore.isOpen() || lodOctree.isCreated())
+    {
+      printf("Filtering is not supported for streamed or LOD spheres.\n");
+      return;
+    }
+    if (spheres.setDrawIndirect(0, 0) != 0)
+      return;
+    // attributes of the generated spheres
+    std::vector<float> spheres_host;
+    generateSpheres(spheres_host);
+    std::vector<SphereAttributes> attributes(NUMBER_SPHERES);
+    for (unsigned i = 0; i < NUMBER_SPHERES; ++i)
+    {
+      const float* s = &spheres_host[4 * i];
+      attributes[i].radius = s[3];
+      attributes[i].scalar = sphereScalar(s[0], s[1], s[2]);
+      attributes[i].type = sphereType(i);
+    }
+    if (sphereFilter.create(attributes) != 0)
+    {
+      sphereFilter.cleanup();
+      return;
+    }
+  }
+  sphereFilter.setTypeMask(type < 0 ? FILTER_ALL_TYPES : 1u << type);
+  sphereFilter.setRadiusRange(min_radius > 0.0f ? min_radius : -FLT_MAX, FLT_MAX);
+  if (sphereFilter.isActive())
+    spheres.setDrawIndirect(sphereFilter.indexBuffer(), sphereFilter.commandBuffer());
+  else
+    spheres.setDrawIndirect(0, 0);
+}
+//-----------------------------------------------------------------------------
+// switches between ID buffer and BVH picking
+//-----------------------------------------------------------------------------
+void requestIdPicking(bool enable)
+{
+#ifdef USE_RENDER_THREAD
+  pendingPacket.id_picking = enable ? 1 : 0;
+#else
+  setIdPicking(enable);
+#endif
+}
+//-----------------------------------------------------------------------------
+// ID buffer pick at window coordinates, answered by the rendering side
+//-----------------------------------------------------------------------------
+void requestPick(int x, int y)
+{
+#ifdef USE_RENDER_THREAD
+  pendingPacket.pick = true;
+  pendingPacket.pick_x = x;
+  pendingPacket.pick_y = y;
+  pendingPacket.pick_width = width;
+  pendingPacket.pick_height = height;
+#else
+  idPicker.request(x, y, width, height);
+#endif
+}
+//-----------------------------------------------------------------------------
+// rendering side, the framebuffer is created on the next frame
+//-----------------------------------------------------------------------------
+void setIdPicking(bool enable)
+{
+  idPicking = enable;
+  if (!enable)
+    idFramebuffer.cleanup();
+  else if (idFramebuffer.id() == 0)
+    idFramebuffer.create(1, 1, { GL_RGBA8, GL_R32UI }, true);
+}
+//-----------------------------------------------------------------------------
+// publishes the camera snapshot and hands collected updates to the render
+// thread (without render thread they have been applied already)
+//-----------------------------------------------------------------------------
+#ifdef USE_RENDER_THREAD
+void retryPublish(int)
+{
+  publishRetry = false;
+  publishFrame();
+}
+#endif
+void publishFrame()
+{
+  CameraSnapshot& snapshot = cameraSnapshot.back();
+  snapshot.camera = camera;
+  snapshot.width = width;
+  snapshot.height = height;
+  snapshot.input_time = inputTime;
+  cameraSnapshot.publish();
+#ifdef USE_RENDER_THREAD
+  if (pendingPacket.empty())
+    return;
+  if (frameQueue.push(pendingPacket))
+    pendingPacket = FramePacket();
+  else if (!publishRetry)
+  {
+    // render thread is behind, keep the updates and try again
+    publishRetry = true;
+    glutTimerFunc(1, retryPublish, 0);
+  }
 #endif
 }
+#ifdef USE_RENDER_THREAD
+//-----------------------------------------------------------------------------
+// render thread: owns the GL context, consumes frame packets and draws
+// continuously with the newest camera snapshot, independent of input handling
+//-----------------------------------------------------------------------------
+void renderLoop(const char* trajectory_file, SimulationMode simulation_mode)
+{
+  if (!glXMakeCurrent(glxDisplay, glxDrawable, renderContext))
+  {
+    fprintf(stderr, "Render thread could not make the context current.\n");
+    exit(EXIT_FAILURE);
+  }
+  if (initContext() != 0 || initScene(trajectory_file, simulation_mode) != 0)
+    exit(EXIT_FAILURE);
+
+  int viewport[2] = { -1, -1 };
+  FramePacket packet;
+  for (;;)
+  {
+    // apply all updates in order
+    while (frameQueue.pop(&packet))
+    {
+      for (size_t i = 0; i < packet.defines.size(); ++i)
+        applyDefine(packet.defines[i].first.c_str(), packet.defines[i].second);
+      if (packet.recompile)
+        recompile = true;
+      if (packet.lod_error > 0.0f)
+        applyLodError(packet.lod_error);
+      if (packet.resolution_scale > 0.0f)
+        applyResolutionScale(packet.resolution_scale);
+      if (packet.light_count >= 0)
+        applyLightCount((unsigned) packet.light_count);
+      if (packet.colormap_preset >= 0)
+        transferFunction.setPreset((unsigned) packet.colormap_preset);
+      if (packet.colormap_max > 0.0f)
+        transferFunction.setRange(0.0f, packet.colormap_max);
+      if (packet.filter)
+        applyFilter(packet.filter_type, packet.filter_radius);
+      if (packet.single_pass >= 0)
+        multiView.setSinglePass(packet.single_pass != 0);
+      if (packet.id_picking >= 0)
+        setIdPicking(packet.id_picking != 0);
+      if (packet.pick)
+        idPicker.request(packet.pick_x, packet.pick_y, packet.pick_width, packet.pick_height);
+      if (packet.quit)
+      {
+        glFinish();
+        glXMakeCurrent(glxDisplay, None, NULL);
+        return;
+      }
+    }
+    cameraSnapshot.update();
+    const CameraSnapshot& view = cameraSnapshot.front();
+    if (view.width != viewport[0] || view.height != viewport[1])
+    {
+      viewport[0] = view.width;
+      viewport[1] = view.height;
+      glViewport(0, 0, view.width, view.height);
+    }
+    renderFrame(view.camera);
+    glXSwapBuffers(glxDisplay, glxDrawable);
+    latency.presented(view.input_time);
+  }
+}
+//-----------------------------------------------------------------------------
+// GLUT keeps its context on this thread (it makes it current on events),
+// the render thread gets a second context sharing all objects
+//-----------------------------------------------------------------------------
+int startRenderThread(const char* trajectory_file, SimulationMode simulation_mode)
+{
+  glxDisplay = glXGetCurrentDisplay();
+  glxDrawable = glXGetCurrentDrawable();
+  GLXContext glut_context = glXGetCurrentContext();
+  int config_id = 0;
+  if (glut_context == NULL
+      || glXQueryContext(glxDisplay, glut_context, GLX_FBCONFIG_ID, &config_id) != Success)
+  {
+    fprintf(stderr, "Render thread needs a GLX context.\n");
+    return 1;
+  }
+  const int attributes[] = { GLX_FBCONFIG_ID, config_id, None };
+  int count = 0;
+  GLXFBConfig* configs = glXChooseFBConfig(glxDisplay, DefaultScreen(glxDisplay),
+                                           attributes, &count);
+  if (configs == NULL || count == 0)
+  {
+    fprintf(stderr, "No framebuffer config for the render thread.\n");
+    return 1;
+  }
+  renderContext = glXCreateNewContext(glxDisplay, configs[0], GLX_RGBA_TYPE,
+                                      glut_context, True);
+  XFree(configs);
+  if (renderContext == NULL)
+  {
+    fprintf(stderr, "Could not create the render thread context.\n");
+    return 1;
+  }
+  renderThread = std::thread(renderLoop, trajectory_file, simulation_mode);
+  printf("Rendering on a dedicated thread.\n");
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void stopRenderThread()
+{
+  if (!renderThread.joinable())
+    return;
+  FramePacket packet;
+  packet.quit = true;
+  // the render thread empties the queue every frame
+  while (!frameQueue.push(packet))
+    std::this_thread::yield();
+  renderThread.join();
+  glXDestroyContext(glxDisplay, renderContext);
+  renderContext = NULL;
+}
+#endif
 //-----------------------------------------------------------------------------
 // calculate_fps
 //-----------------------------------------------------------------------------
 void keyboard(unsigned char key, int x, int y)
 {
+  inputTime = LatencyMonitor::now();
   switch (key)
   {
   case 27:
+#ifdef USE_RENDER_THREAD
+    stopRenderThread();
+#endif
     exit(0);
   case '+':
     fov -= 1.f;
@@ -280,19 +1440,119 @@ void keyboard(unsigned char key, int x, int y)
     camera.advanceTargetZ(-0.05f);
     break;
   case 'r':
+#ifdef USE_RENDER_THREAD
+    pendingPacket.recompile = true;
+#else
     recompile = true;
+#endif
+    break;
+  case 'l':
+    lighting = (lighting + 1) % 3;
+    requestDefine("LIGHTING", lighting);
+    break;
+  case 'z':
+    write_depth = !write_depth;
+    requestDefine("WRITE_DEPTH", write_depth);
+    break;
+  case 'o':
+    ambient_occlusion = !ambient_occlusion;
+    requestDefine("AMBIENT_OCCLUSION", ambient_occlusion);
+    break;
+  case 't':
+    transparency = !transparency;
+    requestDefine("TRANSPARENCY", transparency);
+    break;
+  case 'h':
+    shadows = !shadows;
+    requestDefine("SHADOWS", shadows);
+    break;
+  case 'c':
+    // presets in order, then off
+    colormap = colormap + 1 < (int) TransferFunction::presets() ? colormap + 1 : -1;
+    if (colormap >= 0)
+      requestColormapPreset((unsigned) colormap);
+    if (colormap <= 0)
+      requestDefine("COLORMAP", colormap + 1);
+    break;
+  case 'j':
+    colormap_max *= 0.8f;
+    requestColormapRange(colormap_max);
+    break;
+  case 'k':
+    colormap_max *= 1.25f;
+    requestColormapRange(colormap_max);
+    break;
+  case 'g':
+    filter_type = filter_type + 1 < SPHERE_TYPES ? filter_type + 1 : -1;
+    requestFilter(filter_type, filter_radius);
+    break;
+  case 'y':
+    filter_radius = std::max(filter_radius - 0.125f * RADIUS_VAR, 0.0f);
+    requestFilter(filter_type, filter_radius);
+    break;
+  case 'u':
+    filter_radius = std::min(filter_radius + 0.125f * RADIUS_VAR, RADIUS_MEAN + RADIUS_VAR);
+    requestFilter(filter_type, filter_radius);
+    break;
+  case 'v':
+    if (multiview_views == 0)
+    {
+      printf("Multi-view is off (option -v).\n");
+      break;
+    }
+    multiview_single_pass = !multiview_single_pass;
+    requestSinglePass(multiview_single_pass != 0);
+    break;
+  case 'n':
+    light_count /= 2;
+    requestLightCount(light_count);
+    break;
+  case 'm':
+    light_count = std::min(std::max(2 * light_count, 1u), (unsigned) LIGHTS_MAX);
+    requestLightCount(light_count);
+    break;
+  case 'i':
+    gpu_picking = !gpu_picking;
+    requestDefine("SPHERE_ID", gpu_picking);
+    requestIdPicking(gpu_picking != 0);
+    printf("Picking: %s\n", gpu_picking ? "GPU (sphere ID buffer)" : "CPU (BVH)");
+    break;
+  case ',':
+    lod_error = std::max(lod_error * 0.5f, 0.25f);
+    requestLodError(lod_error);
+    break;
+  case '.':
+    lod_error = std::min(lod_error * 2.0f, 1024.0f);
+    requestLodError(lod_error);
+    break;
+  case '[':
+    resolution_scale = std::max(resolution_scale - RESOLUTION_SCALE_STEP, RESOLUTION_SCALE_MIN);
+    requestResolutionScale(resolution_scale);
+    break;
+  case ']':
+    resolution_scale = std::min(resolution_scale + RESOLUTION_SCALE_STEP, 1.0f);
+    requestResolutionScale(resolution_scale);
     break;
   }
   camera.apply();
+  publishFrame();
 }
 //-----------------------------------------------------------------------------
 // mouse callback
 //-----------------------------------------------------------------------------
 void mouse(int button, int state, int x, int y)
 {
+  inputTime = LatencyMonitor::now();
   if (state == GLUT_DOWN)
   {
     g_mouse.buttons |= 1 << button;
+    if (button == GLUT_MIDDLE_BUTTON)
+    {
+      if (gpu_picking)
+        requestPick(x, y);
+      else
+        pickSphere(x, y);
+    }
   }
   else if (state == GLUT_UP)
   {
@@ -307,6 +1567,7 @@ void mouse(int button, int state, int x, int y)
 //-----------------------------------------------------------------------------
 void motion(int x, int y)
 {
+  inputTime = LatencyMonitor::now();
   float dx, dy;
   dx = (float) (x - g_mouse.button_x);
   dy = (float) (y - g_mouse.button_y);
@@ -325,6 +1586,7 @@ void motion(int x, int y)
   g_mouse.button_x = x;
   g_mouse.button_y = y;
   camera.apply();
+  publishFrame();
 }
 //-----------------------------------------------------------------------------
 // window reshape callback
@@ -333,8 +1595,11 @@ void reshape(int w, int h)
 {
   width = w;
   height = h;
+#ifndef USE_RENDER_THREAD
   glViewport(0, 0, width, height);
+#endif
   camera.applyProjection(fov, width, height);
+  publishFrame();
 }
 //-----------------------------------------------------------------------------
 //
@@ -0,0 +1,218 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "multi_view.h"
+
+#include <stddef.h>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+MultiView::MultiView()
+  : _views(0), _singlePass(true), _buffer(0), _fbo(0), _readFbo(0), _color(0), _depth(0),
+    _width(0), _height(0)
+{
+  _frames[0] = _frames[1] = 0;
+  _sum[0] = _sum[1] = 0.0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int MultiView::create(unsigned views)
+{
+  if (views < 2 || views > MULTIVIEW_MAX_VIEWS)
+  {
+    printf("Multi-view: %u views, expected 2 to %d.\n", views, MULTIVIEW_MAX_VIEWS);
+    return 1;
+  }
+  _views = views;
+  glGenBuffers(1, &_buffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(ViewData), NULL, GL_STREAM_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, VIEW_UNIFORM_BINDING, _buffer);
+  glGenFramebuffers(1, &_fbo);
+  glGenFramebuffers(1, &_readFbo);
+
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+glm::ivec2 MultiView::viewSize(int width, int height) const
+{
+  return glm::ivec2(std::max(width / (int) std::max(_views, 1u), 1), std::max(height, 1));
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void MultiView::update(const Camera& camera)
+{
+  const glm::mat4 modelview = camera.modelview_glm();
+  const glm::mat4 projection = camera.projection_glm();
+  // zero parallax at the camera target
+  const float convergence = std::max(glm::length(glm::vec3(camera.position_glm()) - camera.target()),
+                                     1e-3f);
+  const float baseline = MULTIVIEW_SEPARATION * convergence;
+  for (unsigned v = 0; v < _views; ++v)
+  {
+    // eye offset along the camera x axis, views from left to right
+    const float offset = baseline * ((float) v / (_views - 1) - 0.5f);
+    glm::mat4 shift(1.0f);
+    shift[3][0] = -offset;
+    _data.MVMatrix[v] = shift * modelview;
+    // off-axis frustum, a point at -convergence keeps its window position
+    _data.PMatrix[v] = projection;
+    _data.PMatrix[v][2][0] -= projection[0][0] * offset / convergence;
+  }
+  _data.range = glm::ivec4(0, _views, 0, 0);
+
+  glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ViewData), &_data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void MultiView::setRange(int first, int count)
+{
+  if (_data.range.x == first && _data.range.y == count)
+    return;
+  _data.range = glm::ivec4(first, count, 0, 0);
+  glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, offsetof(ViewData, range), sizeof(glm::ivec4), &_data.range);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+bool MultiView::setPass(unsigned pass)
+{
+  if (_views == 0)
+    return pass == 0;
+  if (_singlePass)
+  {
+    if (pass > 0)
+      return false;
+    setRange(0, (int) _views);
+    return true;
+  }
+  if (pass >= _views)
+    return false;
+  setRange((int) pass, 1);
+  return true;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int MultiView::bind(int width, int height)
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+  if (_color == 0 || width != _width || height != _height)
+  {
+    if (_color)
+    {
+      glDeleteTextures(1, &_color);
+      glDeleteTextures(1, &_depth);
+    }
+    _width = width;
+    _height = height;
+    // one layer per view, attached layered so gl_Layer selects the view
+    glGenTextures(1, &_color);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, _color);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, _width, _height, _views, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, _color, 0);
+    glGenTextures(1, &_depth);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, _depth);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, _width, _height, _views, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, _depth, 0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+      fprintf(stderr, "Multi-view framebuffer incomplete (0x%x).\n", status);
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      return 1;
+    }
+  }
+  glViewport(0, 0, _width, _height);
+  // clears all layers
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void MultiView::present(int width, int height)
+{
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  glViewport(0, 0, width, height);
+  glClear(GL_COLOR_BUFFER_BIT);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, _readFbo);
+  glReadBuffer(GL_COLOR_ATTACHMENT0);
+  for (unsigned v = 0; v < _views; ++v)
+  {
+    glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, _color, 0, (GLint) v);
+    const int x = (int) v * width / (int) _views;
+    glBlitFramebuffer(0, 0, _width, _height, x, 0, x + _width, _height,
+                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  }
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void MultiView::record(bool single_pass, double frame_ms)
+{
+  if (frame_ms < 0.0)
+    return;
+  ++_frames[single_pass];
+  _sum[single_pass] += frame_ms;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void MultiView::report()
+{
+  if (_views == 0 || _frames[0] + _frames[1] == 0)
+    return;
+  printf("Multi-view: %u views", _views);
+  if (_frames[1] > 0)
+    printf(", single pass %.3f ms (%u frames)", _sum[1] / _frames[1], _frames[1]);
+  if (_frames[0] > 0)
+    printf(", per view %.3f ms (%u frames)", _sum[0] / _frames[0], _frames[0]);
+  if (_frames[0] > 0 && _frames[1] > 0)
+    printf(", x%.2f", (_sum[1] / _frames[1]) / (_sum[0] / _frames[0]));
+  printf("\n");
+  _frames[0] = _frames[1] = 0;
+  _sum[0] = _sum[1] = 0.0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void MultiView::cleanup()
+{
+  if (_color)
+  {
+    glDeleteTextures(1, &_color);
+    glDeleteTextures(1, &_depth);
+  }
+  _color = _depth = 0;
+  glDeleteFramebuffers(1, &_fbo);
+  glDeleteFramebuffers(1, &_readFbo);
+  _fbo = _readFbo = 0;
+  glDeleteBuffers(1, &_buffer);
+  _buffer = 0;
+  _views = 0;
+}
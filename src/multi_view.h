@@ -0,0 +1,99 @@
+/*****************************************************************************/
+/**
+ * @file multi_view.h
+ * @brief Stereo and multi-view rendering into the layers of a texture array.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef MULTI_VIEW_H_
+#define MULTI_VIEW_H_
+
+#include "gl_globals.h"
+#include "camera.h"
+
+#include <glm/glm.hpp>
+
+/// name of the uniform block in the shaders
+#define VIEW_UNIFORM_BLOCK "ViewData"
+/// uniform buffer binding point of the ViewData block
+#define VIEW_UNIFORM_BINDING 1
+/// array size of the ViewData block and the largest MULTIVIEW define
+#define MULTIVIEW_MAX_VIEWS 4
+/// distance between the outer views relative to the distance of the target
+#define MULTIVIEW_SEPARATION (1.0f / 30.0f)
+
+/// memory layout of the ViewData uniform block (std140) in shader/common.glsl
+struct ViewData
+{
+  glm::mat4 MVMatrix[MULTIVIEW_MAX_VIEWS];
+  glm::mat4 PMatrix[MULTIVIEW_MAX_VIEWS];
+  glm::ivec4 range;
+};
+
+/**
+ * Renders n views of the camera in one pass. With the shader define
+ * MULTIVIEW=n, sphere_geom.geom fetches a sphere once and emits its billboard
+ * into layer i of a GL_TEXTURE_2D_ARRAY target for each view i (gl_Layer),
+ * so vertex fetch and expansion are not repeated per view.
+ *
+ * The views are parallel cameras on a horizontal baseline with off-axis
+ * projections converging at the camera target. Each view is w/n x h and
+ * keeps the window projection, so present() tiles them side by side at
+ * half horizontal resolution (the usual side-by-side stereo format).
+ *
+ * For comparison, setSinglePass(false) draws each view in its own pass with
+ * the same shader and target. Frame times of both modes are kept.
+ *
+ * GL_OVR_multiview is not used: it excludes geometry shaders, which expand
+ * all impostors that support this path.
+ */
+class MultiView
+{
+  public:
+    MultiView();
+    /**
+     * @param views in [2, MULTIVIEW_MAX_VIEWS]
+     * @retval 0 on success, 1 on error
+     */
+    int create(unsigned views);
+    /// 0 if not created
+    unsigned views() const { return _views; }
+    /// size of one view for a window
+    glm::ivec2 viewSize(int width, int height) const;
+    /// computes and uploads the view matrices, camera has the size of one view
+    void update(const Camera& camera);
+    /// resizes, binds and clears the layered target
+    int bind(int width, int height);
+    /**
+     * Selects the views of a draw call, e.g.
+     * for (unsigned pass = 0; multiView.setPass(pass); ++pass) draw();
+     * @retval false if all views have been drawn
+     */
+    bool setPass(unsigned pass);
+    void setSinglePass(bool single) { _singlePass = single; }
+    bool singlePass() const { return _singlePass; }
+    /// copies the views side by side into the default framebuffer
+    void present(int width, int height);
+    /// adds the GPU time of a frame in single or per-view pass mode
+    void record(bool single_pass, double frame_ms);
+    /// prints and resets the statistics
+    void report();
+    void cleanup();
+
+  private:
+    /// uploads the view range of a pass
+    void setRange(int first, int count);
+
+    unsigned _views;
+    bool _singlePass;
+    GLuint _buffer;
+    ViewData _data;
+    GLuint _fbo, _readFbo;
+    GLuint _color, _depth;
+    int _width, _height;
+    // statistics since the last report(), [0] per view, [1] single pass
+    unsigned _frames[2];
+    double _sum[2];
+};
+
+#endif /* MULTI_VIEW_H_ */
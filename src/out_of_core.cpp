@@ -0,0 +1,430 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Clustered point lights (LIGHTS).
+ * @date 2026/10/18: ViewData block binding for multi-view.
+ * @date 2026/10/18: Level of detail can be scaled.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "out_of_core.h"
+#include "clustered_lights.h"
+#include "frame_uniforms.h"
+#include "multi_view.h"
+
+#include <math.h>
+#include <algorithm>
+#include <utility>
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+OutOfCoreSpheres::OutOfCoreSpheres()
+  : _spheresPerPixel(OOC_SPHERES_PER_PIXEL), _frame(0),
+    _baseBuffer(0), _baseArray(0), _poolBuffer(0), _poolArray(0),
+    _inFlight(0), _quit(false),
+    _frames(0), _drawn(0), _deserved(0), _bytesRead(0),
+    _visibleSum(0), _evictions(0)
+{
+}
+OutOfCoreSpheres::~OutOfCoreSpheres()
+{
+  // GL objects are released by cleanup() while the context exists
+  stopLoader();
+}
+//-----------------------------------------------------------------------------
+// interleaved ChunkSphere records as read by sphere_geom.vert
+//-----------------------------------------------------------------------------
+void OutOfCoreSpheres::setupArray(GLuint array, GLuint buffer)
+{
+  const GLsizei stride = sizeof(ChunkSphere);
+  glBindVertexArray(array);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+  glEnableVertexAttribArray(0); // pos
+  glEnableVertexAttribArray(1); // color
+  glEnableVertexAttribArray(2); // radius
+  glEnableVertexAttribArray(3); // ambient occlusion
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, 0);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)16);
+  glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)12);
+  glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)28);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int OutOfCoreSpheres::create(const char* filename, unsigned pool_mb)
+{
+  if (_reader.open(filename) != 0)
+    return 1;
+  const unsigned num_chunks = _reader.numChunks();
+  const GLsizeiptr page_bytes = OOC_PAGE_SPHERES * sizeof(ChunkSphere);
+  const unsigned long long chunk_pages =
+      (_reader.chunkSpheres() + OOC_PAGE_SPHERES - 1) / OOC_PAGE_SPHERES;
+  unsigned pages = (unsigned) std::max((GLsizeiptr) 1,
+                                       ((GLsizeiptr) pool_mb << 20) / page_bytes);
+  pages = (unsigned) std::min((unsigned long long) pages, chunk_pages * num_chunks);
+
+  // coarsest level of detail of every chunk, read synchronously
+  std::vector<ChunkSphere> base((size_t) num_chunks * OOC_BASE_SPHERES);
+  for (unsigned c = 0; c < num_chunks; ++c)
+  {
+    unsigned count = std::min(_reader.chunk(c).count, (unsigned) OOC_BASE_SPHERES);
+    if (_reader.read(c, 0, count, &base[(size_t) c * OOC_BASE_SPHERES]) != 0)
+      return 1;
+  }
+  glGenBuffers(1, &_baseBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, _baseBuffer);
+  glBufferData(GL_ARRAY_BUFFER, base.size() * sizeof(ChunkSphere), &base[0], GL_STATIC_DRAW);
+  glGenBuffers(1, &_poolBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, _poolBuffer);
+  glBufferData(GL_ARRAY_BUFFER, page_bytes * pages, NULL, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glGenVertexArrays(1, &_baseArray);
+  glGenVertexArrays(1, &_poolArray);
+  setupArray(_baseArray, _baseBuffer);
+  setupArray(_poolArray, _poolBuffer);
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+
+  _shader.load("sphere_geom.vert", "sphere.frag", "sphere_geom.geom");
+  _shader.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+  _shader.setUniformBlockBinding(VIEW_UNIFORM_BLOCK, VIEW_UNIFORM_BINDING);
+  ClusteredLights::setBindings(_shader);
+  if (_shader.link())
+  {
+    printf("Error occurred.\n");
+    return 1;
+  }
+
+  Chunk chunk;
+  chunk.resident = chunk.requested = chunk.deserved = chunk.lastVisible = 0;
+  chunk.importance = 0.0f;
+  _chunks.assign(num_chunks, chunk);
+  _pageChunk.assign(pages, -1);
+  _quit = false;
+  _thread = std::thread(&OutOfCoreSpheres::loadLoop, this);
+  printf("Out-of-core: %llu spheres in %u chunks, %u pages of %.2f MB, "
+         "%.1f MB resident base level.\n", _reader.numSpheres(), num_chunks, pages,
+         page_bytes / 1048576.0, base.size() * sizeof(ChunkSphere) / 1048576.0);
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void OutOfCoreSpheres::update(const Camera& camera)
+{
+  ++_frame;
+  upload();
+  evaluate(camera);
+  schedule();
+}
+//-----------------------------------------------------------------------------
+// frustum culling and spheres deserved by the projected area of each chunk
+//-----------------------------------------------------------------------------
+void OutOfCoreSpheres::evaluate(const Camera& camera)
+{
+  const glm::mat4 mvp = camera.mvpmatrix_glm();
+  const glm::mat4 mv = camera.modelview_glm();
+  const glm::mat4 projection = camera.projection_glm();
+  const glm::ivec2 screen = camera.screen();
+  const float screen_area = (float) screen.x * screen.y;
+  // pixels per unit of tan(angle) from the view axis
+  const float focal = 0.5f * screen.y * projection[1][1];
+
+  _visible.clear();
+  for (unsigned c = 0; c < _chunks.size(); ++c)
+  {
+    const ChunkInfo& info = _reader.chunk(c);
+    Chunk& chunk = _chunks[c];
+    chunk.deserved = 0;
+    // culled if all corners are outside of one clip plane
+    unsigned outside[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int k = 0; k < 8; ++k)
+    {
+      glm::vec4 p = mvp * glm::vec4(k & 1 ? info.upper[0] : info.lower[0],
+                                    k & 2 ? info.upper[1] : info.lower[1],
+                                    k & 4 ? info.upper[2] : info.lower[2], 1.0f);
+      outside[0] += p.x < -p.w;
+      outside[1] += p.x > p.w;
+      outside[2] += p.y < -p.w;
+      outside[3] += p.y > p.w;
+      outside[4] += p.z < -p.w;
+      outside[5] += p.z > p.w;
+    }
+    if (*std::max_element(outside, outside + 6) == 8)
+      continue;
+
+    glm::vec3 lower(info.lower[0], info.lower[1], info.lower[2]);
+    glm::vec3 upper(info.upper[0], info.upper[1], info.upper[2]);
+    float radius = 0.5f * glm::length(upper - lower);
+    glm::vec4 eye = mv * glm::vec4(0.5f * (lower + upper), 1.0f);
+    float distance = glm::length(glm::vec3(eye.x, eye.y, eye.z));
+    float area = screen_area;
+    if (distance > radius)
+    {
+      float projected = focal * radius / sqrtf(distance * distance - radius * radius);
+      area = std::min(screen_area, 3.14159265f * projected * projected);
+    }
+    chunk.importance = area;
+    chunk.lastVisible = _frame;
+    chunk.deserved = (unsigned) std::min((float) info.count,
+                                         std::max((float) OOC_BASE_SPHERES,
+                                                  area * _spheresPerPixel));
+    _visible.push_back(c);
+  }
+}
+//-----------------------------------------------------------------------------
+// copies finished reads into their pages, at most OOC_UPLOAD_BYTES per frame
+//-----------------------------------------------------------------------------
+void OutOfCoreSpheres::upload()
+{
+  const GLsizeiptr page_bytes = OOC_PAGE_SPHERES * sizeof(ChunkSphere);
+  GLsizeiptr budget = OOC_UPLOAD_BYTES;
+  Read read;
+  for (;;)
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_completed.empty() || budget <= 0)
+        break;
+      read = std::move(_completed.front());
+      _completed.pop_front();
+    }
+    --_inFlight;
+    // pages with reads in flight are not evicted and the reads of a chunk
+    // complete in order, unless a read has failed before
+    Chunk& chunk = _chunks[read.chunk];
+    unsigned index = read.first / OOC_PAGE_SPHERES;
+    if (read.spheres.empty() || index >= chunk.pages.size()
+        || chunk.pages[index] != (int) read.page || read.first != chunk.resident)
+    {
+      chunk.requested = chunk.resident;
+      continue;
+    }
+    GLsizeiptr size = (GLsizeiptr) read.spheres.size() * sizeof(ChunkSphere);
+    if (budget == OOC_UPLOAD_BYTES)
+      glBindBuffer(GL_ARRAY_BUFFER, _poolBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, page_bytes * read.page
+                    + (GLintptr) (read.first % OOC_PAGE_SPHERES) * sizeof(ChunkSphere),
+                    size, &read.spheres[0]);
+    budget -= size;
+    _bytesRead += size;
+    chunk.resident += (unsigned) read.spheres.size();
+  }
+  if (budget != OOC_UPLOAD_BYTES)
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+// free page, else the last page of the least recently visible chunk, else
+// the last page of the least important visible chunk (if less important)
+//-----------------------------------------------------------------------------
+int OutOfCoreSpheres::allocatePage(unsigned chunk)
+{
+  int victim = -1;
+  bool victim_visible = true;
+  unsigned oldest = _frame;
+  float lowest = _chunks[chunk].importance;
+  for (unsigned p = 0; p < _pageChunk.size(); ++p)
+  {
+    int owner = _pageChunk[p];
+    if (owner < 0)
+    {
+      victim = (int) p;
+      break;
+    }
+    const Chunk& c = _chunks[owner];
+    if (owner == (int) chunk || c.pages.back() != (int) p || c.requested != c.resident)
+      continue;
+    if (c.lastVisible != _frame)
+    {
+      if (victim_visible || c.lastVisible < oldest)
+      {
+        victim = (int) p;
+        victim_visible = false;
+        oldest = c.lastVisible;
+      }
+    }
+    else if (victim_visible && c.importance < lowest)
+    {
+      victim = (int) p;
+      lowest = c.importance;
+    }
+  }
+  if (victim < 0)
+    return -1;
+  int owner = _pageChunk[victim];
+  if (owner >= 0)
+  {
+    Chunk& c = _chunks[owner];
+    c.pages.pop_back();
+    c.resident = c.requested = (unsigned) c.pages.size() * OOC_PAGE_SPHERES;
+    ++_evictions;
+  }
+  _pageChunk[victim] = (int) chunk;
+  _chunks[chunk].pages.push_back(victim);
+  return victim;
+}
+//-----------------------------------------------------------------------------
+// refines the most important chunks which deserve more than is resident
+//-----------------------------------------------------------------------------
+void OutOfCoreSpheres::schedule()
+{
+  std::vector<unsigned> candidates;
+  for (size_t i = 0; i < _visible.size(); ++i)
+  {
+    const Chunk& chunk = _chunks[_visible[i]];
+    if (chunk.deserved > OOC_BASE_SPHERES && chunk.deserved > chunk.requested)
+      candidates.push_back(_visible[i]);
+  }
+  std::sort(candidates.begin(), candidates.end(), [this](unsigned a, unsigned b) {
+    return _chunks[a].importance > _chunks[b].importance;
+  });
+
+  std::vector<Read> reads;
+  for (size_t i = 0; i < candidates.size() && _inFlight < OOC_MAX_READS; ++i)
+  {
+    Chunk& chunk = _chunks[candidates[i]];
+    unsigned index = chunk.requested / OOC_PAGE_SPHERES;
+    if (index == chunk.pages.size() && allocatePage(candidates[i]) < 0)
+      break;
+    // up to the end of the page
+    unsigned end = std::min(chunk.deserved, (index + 1) * OOC_PAGE_SPHERES);
+    Read read;
+    read.chunk = candidates[i];
+    read.page = (unsigned) chunk.pages[index];
+    read.first = chunk.requested;
+    read.spheres.resize(end - chunk.requested);
+    chunk.requested = end;
+    reads.push_back(std::move(read));
+    ++_inFlight;
+  }
+  if (reads.empty())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < reads.size(); ++i)
+      _requests.push_back(std::move(reads[i]));
+  }
+  _cond.notify_one();
+}
+//-----------------------------------------------------------------------------
+// loader thread, reads the requests in order
+//-----------------------------------------------------------------------------
+void OutOfCoreSpheres::loadLoop()
+{
+  Read read;
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _cond.wait(lock, [this] { return _quit || !_requests.empty(); });
+      if (_quit)
+        return;
+      read = std::move(_requests.front());
+      _requests.pop_front();
+    }
+    // a failed read leaves the chunk at the resident level of detail
+    if (_reader.read(read.chunk, read.first, (unsigned) read.spheres.size(),
+                     &read.spheres[0]) != 0)
+      read.spheres.clear();
+    std::lock_guard<std::mutex> lock(_mutex);
+    _completed.push_back(std::move(read));
+  }
+}
+//-----------------------------------------------------------------------------
+// resident pages at their level of detail, all other visible chunks from
+// the base level
+//-----------------------------------------------------------------------------
+void OutOfCoreSpheres::draw()
+{
+  _shader.bind();
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    _firsts.clear();
+    _counts.clear();
+    for (size_t i = 0; i < _visible.size(); ++i)
+    {
+      const Chunk& chunk = _chunks[_visible[i]];
+      bool paged = chunk.resident > OOC_BASE_SPHERES;
+      if (paged != (pass == 0))
+        continue;
+      if (paged)
+      {
+        unsigned count = std::min(chunk.resident, chunk.deserved);
+        for (unsigned p = 0; p * OOC_PAGE_SPHERES < count; ++p)
+        {
+          _firsts.push_back((GLint) (chunk.pages[p] * OOC_PAGE_SPHERES));
+          _counts.push_back((GLsizei) std::min(count - p * OOC_PAGE_SPHERES,
+                                               (unsigned) OOC_PAGE_SPHERES));
+        }
+        _drawn += count;
+      }
+      else
+      {
+        unsigned count = std::min(_reader.chunk(_visible[i]).count, (unsigned) OOC_BASE_SPHERES);
+        _firsts.push_back((GLint) (_visible[i] * OOC_BASE_SPHERES));
+        _counts.push_back((GLsizei) count);
+        _drawn += count;
+      }
+      _deserved += chunk.deserved;
+    }
+    if (_firsts.empty())
+      continue;
+    glBindVertexArray(pass == 0 ? _poolArray : _baseArray);
+    glMultiDrawArrays(GL_POINTS, &_firsts[0], &_counts[0], (GLsizei) _firsts.size());
+  }
+  glBindVertexArray(0);
+  _shader.unbind();
+  _visibleSum += (unsigned) _visible.size();
+  ++_frames;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void OutOfCoreSpheres::report()
+{
+  if (_frames == 0)
+    return;
+  unsigned resident = 0;
+  for (size_t p = 0; p < _pageChunk.size(); ++p)
+    resident += _pageChunk[p] >= 0;
+  printf("Out-of-core: %u of %u chunks visible, %.2fM of %.2fM deserved spheres drawn, "
+         "%u/%u pages, %.1f MB streamed, %u evictions\n",
+         _visibleSum / _frames, (unsigned) _chunks.size(),
+         _drawn / (1e6 * _frames), _deserved / (1e6 * _frames),
+         resident, (unsigned) _pageChunk.size(), _bytesRead / 1048576.0, _evictions);
+  _frames = 0;
+  _drawn = _deserved = _bytesRead = 0;
+  _visibleSum = _evictions = 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void OutOfCoreSpheres::stopLoader()
+{
+  if (!_thread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _quit = true;
+  }
+  _cond.notify_all();
+  _thread.join();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void OutOfCoreSpheres::cleanup()
+{
+  stopLoader();
+  _requests.clear();
+  _completed.clear();
+  _inFlight = 0;
+  _reader.close();
+  glDeleteVertexArrays(1, &_baseArray);
+  glDeleteVertexArrays(1, &_poolArray);
+  _baseArray = _poolArray = 0;
+  glDeleteBuffers(1, &_baseBuffer);
+  glDeleteBuffers(1, &_poolBuffer);
+  _baseBuffer = _poolBuffer = 0;
+}
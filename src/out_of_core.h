@@ -0,0 +1,133 @@
+/*****************************************************************************/
+/**
+ * @file out_of_core.h
+ * @brief Streaming renderer for chunk files larger than GPU memory.
+ * @date 2026/10/18: Level of detail can be scaled.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef OUT_OF_CORE_H_
+#define OUT_OF_CORE_H_
+
+#include "gl_globals.h"
+#include "camera.h"
+#include "chunk_file.h"
+#include "shader.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// spheres of every chunk which are always resident (coarsest level of detail)
+#define OOC_BASE_SPHERES 128
+/// default size of the GPU page pool in MB (option -p)
+#define OOC_POOL_MB 512
+/// spheres per GPU page, a chunk is refined page by page (one read each)
+#define OOC_PAGE_SPHERES 8192
+/// disk reads in flight
+#define OOC_MAX_READS 8
+/// bytes uploaded to the page pool per frame
+#define OOC_UPLOAD_BYTES (16 << 20)
+/// spheres drawn per pixel of the projected chunk bounds
+#define OOC_SPHERES_PER_PIXEL 0.5f
+
+/**
+ * Renders a chunk file (see ChunkWriter) with a bounded amount of GPU memory.
+ *
+ * - The first OOC_BASE_SPHERES of every chunk are uploaded at create(), so
+ *   every chunk can be drawn at a coarse level of detail at any time.
+ * - A pool of fixed-size pages holds the streamed prefixes of the chunks,
+ *   OOC_PAGE_SPHERES each. update() culls the chunk bounds against the view
+ *   frustum and derives the number of spheres a chunk deserves from its
+ *   projected area. The most important chunks are refined first. A page is
+ *   taken from the end of the least recently visible chunk or else of a
+ *   visible chunk of lower importance, which coarsens that chunk by one step.
+ * - A loader thread reads the requested sphere ranges; finished reads are
+ *   uploaded by update() within a per-frame budget.
+ *
+ * Chunks are shuffled on disk, so any prefix of a chunk is a random subsample
+ * and a chunk is drawn with min(resident, deserved) spheres. If the pool or
+ * the disk cannot keep up, chunks stay at a coarser level of detail.
+ * Drawing uses the geometry shader impostor, one glMultiDrawArrays() call
+ * for all pages and one for the base level.
+ */
+class OutOfCoreSpheres
+{
+  public:
+    OutOfCoreSpheres();
+    ~OutOfCoreSpheres();
+    /**
+     * @param pool_mb size of the GPU page pool in MB
+     * @retval 0 on success
+     */
+    int create(const char* filename, unsigned pool_mb);
+    bool isOpen() const { return _thread.joinable(); }
+    const std::string getDescription() const {
+      return "Spheres Rendering: Out-of-core chunks (Geometry Shader billboards).";
+    }
+    int recompile() { return _shader.reload(); }
+    void setDefine(const char* name, int value) { _shader.setDefine(name, value); }
+    const std::string& variant() const { return _shader.variant(); }
+    /// spheres drawn per pixel of the projected chunk bounds
+    void setSpheresPerPixel(float spheres) { _spheresPerPixel = spheres; }
+    /// uploads finished reads, selects the level of detail and schedules reads
+    void update(const Camera& camera);
+    void draw();
+    /// prints and resets the statistics since the last report()
+    void report();
+    void cleanup();
+
+  private:
+    struct Chunk
+    {
+      std::vector<int> pages; ///< holding spheres [i * OOC_PAGE_SPHERES, ...)
+      unsigned resident; ///< spheres uploaded to the pages
+      unsigned requested; ///< spheres uploaded or being read
+      unsigned deserved; ///< for the current view, 0 if culled
+      float importance; ///< projected area in pixels
+      unsigned lastVisible; ///< frame
+    };
+    struct Read
+    {
+      unsigned chunk, page, first;
+      std::vector<ChunkSphere> spheres;
+    };
+    void evaluate(const Camera& camera);
+    void upload();
+    void schedule();
+    /// @retval page or -1 if all pages are needed by more important chunks
+    int allocatePage(unsigned chunk);
+    void loadLoop();
+    void stopLoader();
+    void setupArray(GLuint array, GLuint buffer);
+
+  private:
+    ChunkReader _reader;
+    std::vector<Chunk> _chunks;
+    std::vector<int> _pageChunk; ///< chunk of every page, -1 if free
+    std::vector<unsigned> _visible;
+    float _spheresPerPixel;
+    unsigned _frame;
+    ShaderManager _shader;
+    GLuint _baseBuffer, _baseArray;
+    GLuint _poolBuffer, _poolArray;
+    std::vector<GLint> _firsts;
+    std::vector<GLsizei> _counts;
+    /// reads requested and not uploaded yet
+    unsigned _inFlight;
+    // shared with the loader thread
+    std::deque<Read> _requests, _completed;
+    bool _quit;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::thread _thread;
+    // statistics since the last report()
+    unsigned _frames;
+    unsigned long long _drawn, _deserved, _bytesRead;
+    unsigned _visibleSum, _evictions;
+};
+
+#endif /* OUT_OF_CORE_H_ */
@@ -2,24 +2,66 @@
 /**
  * @author Matthias Werner
  * @sa http://11235813tdd.blogspot.de/
+ * @date 2026/10/18: #include of shared shader files.
+ * @date 2026/10/18: Compute shader programs.
+ * @date 2026/10/18: Shader variants by injected defines.
+ * @date 2026/10/18: Non-blocking reload keeping the previous program on errors.
+ * @date 2026/10/18: Uniform location cache, uniform block bindings.
+ * @date 2026/10/18: Program binary cache.
  * @date 2013/04/26: Release.
  * @date 2013/04/02: Initial commit.
  *****************************************************************************/
 #include "shader.h"
 #include <fstream>
 #include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <sys/stat.h>
+#ifdef M_WINDOWS
+#include <direct.h>
+#endif
 using std::ifstream;
 
 static char buffer[1024];
 static int len = 0;
 
+static const char BINARY_MAGIC[4] = { 'S', 'P', 'B', 'C' };
+
+/// header of a cached program binary file
+struct BinaryHeader
+{
+  char magic[4];
+  unsigned long long key;
+  GLenum format;
+  GLint length;
+};
+
+//-----------------------------------------------------------------------------
+// FNV-1a
+//-----------------------------------------------------------------------------
+static unsigned long long hashString(unsigned long long h, const char* s)
+{
+  if (s == NULL)
+    return h;
+  for (; *s; ++s)
+  {
+    h ^= (unsigned char) *s;
+    h *= 1099511628211ULL;
+  }
+  // separator, so that ("ab","c") and ("a","bc") differ
+  h ^= 0xff;
+  h *= 1099511628211ULL;
+  return h;
+}
+
 //-----------------------------------------------------------------------------
 //
 //-----------------------------------------------------------------------------
 ShaderManager::ShaderManager()
 {
   init();
-  setShaderLocation("./shader/");
+  setShaderLocation(SHADER_LOCATION);
 }
 //-----------------------------------------------------------------------------
 //
@@ -32,123 +74,555 @@ ShaderManager::ShaderManager(const char * shader_location)
 //-----------------------------------------------------------------------------
 //bundles a VS and a PS into a program
 //-----------------------------------------------------------------------------
-void ShaderManager::load(const char * vertexshader,
-                         const char * pixelshader,
-                         const char * geoshader)
+int ShaderManager::load(const char * vertexshader,
+                        const char * pixelshader,
+                        const char * geoshader)
 {
   if (_isLoaded)
   {
     printf("Shader already loaded to application.\n");
-    exit(1);
+    return 1;
   }
-  if (_programID == 0)
-    _programID = glCreateProgram();
-  if (vertexshader != NULL)
+  _filenames[0] = vertexshader ? vertexshader : "";
+  _filenames[1] = pixelshader ? pixelshader : "";
+  _filenames[2] = geoshader ? geoshader : "";
+  _isLoaded = true;
+
+  if (_pending.program)
+    deleteBuild(&_pending);
+  _pending.variant = _variant;
+  return beginBuild(&_pending);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ShaderManager::loadCompute(const char * computeshader)
+{
+  if (_isLoaded)
   {
-    _vertexShaderID = loadShader(vertexshader, GL_VERTEX_SHADER);
-    glAttachShader(_programID, _vertexShaderID);
+    printf("Shader already loaded to application.\n");
+    return 1;
   }
-  if (pixelshader != NULL)
+  _compute = true;
+  return load(computeshader, NULL);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ShaderManager::link()
+{
+  if (_pending.program == 0)
+    return 1;
+  return finishBuild(&_pending, true) == BUILD_OK ? 0 : 1;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ShaderManager::reload()
+{
+  if (!_isLoaded)
+    return 1;
+  // sources changed, so all variants but the running one are stale
+  std::map<std::string, Program>::iterator it = _programs.begin();
+  while (it != _programs.end())
   {
-    _pixelShaderID = loadShader(pixelshader, GL_FRAGMENT_SHADER);
-    glAttachShader(_programID, _pixelShaderID);
+    if (&it->second == _current)
+    {
+      ++it;
+      continue;
+    }
+    deleteProgram(&it->second);
+    _programs.erase(it++);
   }
-  if (geoshader != NULL)
-  {
-    _geoShaderID = loadShader(geoshader, GL_GEOMETRY_SHADER);
-    glAttachShader(_programID, _geoShaderID);
+  _failedVariant.clear();
+  // a newer edit supersedes a build still in flight
+  if (_pending.program)
+    deleteBuild(&_pending);
+  _pending.variant = _variant;
+  return beginBuild(&_pending);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ShaderManager::update()
+{
+  if (_pending.program == 0)
+    return 0;
+  return finishBuild(&_pending, false) == BUILD_OK ? 1 : 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::setDefine(const char* name, int value)
+{
+  _defines[name] = value;
+  updateVariant();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::removeDefine(const char* name)
+{
+  _defines.erase(name);
+  updateVariant();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::updateVariant()
+{
+  std::ostringstream key;
+  std::map<std::string, int>::const_iterator it;
+  for (it = _defines.begin(); it != _defines.end(); ++it)
+    key << (it == _defines.begin() ? "" : " ") << it->first << "=" << it->second;
+  _variant = key.str();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::injectDefines(std::string* source)
+{
+  if (_defines.empty())
+    return;
+  std::ostringstream defines;
+  std::map<std::string, int>::const_iterator it;
+  for (it = _defines.begin(); it != _defines.end(); ++it)
+    defines << "#define " << it->first << " " << it->second << "\n";
 
-    glProgramParameteriEXT(_programID, GL_GEOMETRY_INPUT_TYPE_EXT, GL_POINTS);
-    glProgramParameteriEXT(_programID, GL_GEOMETRY_OUTPUT_TYPE_EXT,
-                           GL_TRIANGLE_STRIP);
-    glProgramParameteriEXT(_programID, GL_GEOMETRY_VERTICES_OUT_EXT, 4);
+  // #version has to stay the first statement
+  size_t pos = 0;
+  int line = 1;
+  size_t version = source->find("#version");
+  if (version != std::string::npos)
+  {
+    pos = source->find('\n', version);
+    pos = pos == std::string::npos ? source->size() : pos + 1;
+    for (size_t k = 0; k < pos; ++k)
+      line += (*source)[k] == '\n';
   }
-  _isLoaded = true;
+  // keep line numbers of compiler messages in sync with the file
+  defines << "#line " << line << "\n";
+  source->insert(pos, defines.str());
+}
+//-----------------------------------------------------------------------------
+// replaces lines #include "file" by the file from the shader location
+//-----------------------------------------------------------------------------
+int ShaderManager::expandIncludes(std::string* source)
+{
+  size_t pos = 0;
+  int line = 1;
+  int includes = 0;
+  while (pos < source->size())
+  {
+    size_t end = source->find('\n', pos);
+    end = end == std::string::npos ? source->size() : end + 1;
+    size_t first = source->find_first_not_of(" \t", pos);
+    if (first < end && source->compare(first, 8, "#include") == 0)
+    {
+      size_t open = source->find('"', first);
+      size_t close = open < end ? source->find('"', open + 1) : std::string::npos;
+      if (close >= end)
+      {
+        printf("Malformed #include in line %d.\n", line);
+        return 1;
+      }
+      std::string included;
+      std::string filename = source->substr(open + 1, close - open - 1);
+      if (readEntireFile(&included, (_shader_location + filename).c_str()) != 0)
+        return 1;
+      // messages of the included file refer to its own lines (source string > 0)
+      std::ostringstream text;
+      text << "#line 1 " << ++includes << "\n" << included << "#line " << line + 1 << " 0\n";
+      source->replace(pos, end - pos, text.str());
+      end = pos + text.str().size();
+    }
+    pos = end;
+    ++line;
+  }
+  return 0;
 }
 //-----------------------------------------------------------------------------
 //
 //-----------------------------------------------------------------------------
-int ShaderManager::link()
+int ShaderManager::beginBuild(Build* build)
 {
-  glLinkProgram(_programID);
+  static bool parallel_init = false;
+  if (!parallel_init)
+  {
+    // let the driver compile on as many threads as it likes
+#ifdef GL_KHR_parallel_shader_compile
+    if (GLEW_KHR_parallel_shader_compile)
+      glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+#endif
+#ifdef GL_ARB_parallel_shader_compile
+    if (!GLEW_KHR_parallel_shader_compile && GLEW_ARB_parallel_shader_compile)
+      glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+#endif
+    parallel_init = true;
+  }
+
+  std::string sources[3];
+  for (int k = 0; k < 3; ++k)
+  {
+    if (_filenames[k].empty())
+      continue;
+    if (readEntireFile(&sources[k], (_shader_location + _filenames[k]).c_str()) != 0
+        || expandIncludes(&sources[k]) != 0)
+      return 1;
+    injectDefines(&sources[k]);
+  }
+
+  // the binary depends on the sources (including defines) and on the driver
+  build->key = 14695981039346656037ULL;
+  for (int k = 0; k < 3; ++k)
+  {
+    build->key = hashString(build->key, _filenames[k].c_str());
+    build->key = hashString(build->key, sources[k].c_str());
+  }
+  build->key = hashString(build->key, (const char*) glGetString(GL_VENDOR));
+  build->key = hashString(build->key, (const char*) glGetString(GL_RENDERER));
+  build->key = hashString(build->key, (const char*) glGetString(GL_VERSION));
+
+  build->program = glCreateProgram();
+  build->binary = loadBinary(build->program, build->key);
+  if (build->binary)
+    return 0;
+
+  const int types[3] = { _compute ? GL_COMPUTE_SHADER : GL_VERTEX_SHADER,
+                         GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER };
+  for (int k = 0; k < 3; ++k)
+  {
+    if (_filenames[k].empty())
+      continue;
+    build->shaders[k] = loadShader(sources[k], _filenames[k].c_str(), types[k]);
+    if (build->shaders[k] == 0)
+    {
+      deleteBuild(build);
+      return 1;
+    }
+    glAttachShader(build->program, build->shaders[k]);
+  }
+  if (build->shaders[2])
+  {
+    glProgramParameteriEXT(build->program, GL_GEOMETRY_INPUT_TYPE_EXT, GL_POINTS);
+    glProgramParameteriEXT(build->program, GL_GEOMETRY_OUTPUT_TYPE_EXT,
+                           GL_TRIANGLE_STRIP);
+    glProgramParameteriEXT(build->program, GL_GEOMETRY_VERTICES_OUT_EXT, 4);
+  }
+#ifndef NO_SHADER_CACHE
+  if (GLEW_ARB_get_program_binary)
+    glProgramParameteri(build->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+  // status is not queried here, so the driver may compile in the background
+  glLinkProgram(build->program);
   if (CHECK_GLERROR() != GL_NO_ERROR)
+  {
+    deleteBuild(build);
     return 1;
+  }
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ShaderManager::BuildStatus ShaderManager::finishBuild(Build* build, bool wait)
+{
+  GLint status = GL_FALSE;
+#ifdef GL_KHR_parallel_shader_compile
+  if (!wait && !build->binary
+      && (GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile))
+  {
+    glGetProgramiv(build->program, GL_COMPLETION_STATUS_KHR, &status);
+    if (status == GL_FALSE)
+      return BUILD_PENDING;
+  }
+#endif
+  glGetProgramiv(build->program, GL_LINK_STATUS, &status);
+  if (status == GL_FALSE)
+  {
+    printLogs(*build);
+    printf("Shader program not updated, previous program is kept.\n");
+    _failedVariant = build->variant;
+    deleteBuild(build);
+    return BUILD_FAILED;
+  }
+  if (!build->binary)
+    storeBinary(build->program, build->key);
+
+  // replace program of this variant
+  Program& program = _programs[build->variant];
+  deleteProgram(&program);
+  program.id = build->program;
+  for (int k = 0; k < 3; ++k)
+    program.shaders[k] = build->shaders[k];
+  cacheUniforms(&program);
 
-  glGetProgramInfoLog(_programID, 1000, &len, buffer);
+  if (build->variant == _variant || _current == NULL)
+  {
+    _current = &program;
+    _currentVariant = build->variant;
+  }
+  *build = Build();
+  return BUILD_OK;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::deleteBuild(Build* build)
+{
+  for (int k = 0; k < 3; ++k)
+  {
+    if (build->shaders[k])
+    {
+      glDetachShader(build->program, build->shaders[k]);
+      glDeleteShader(build->shaders[k]);
+    }
+  }
+  if (build->program)
+    glDeleteProgram(build->program);
+  *build = Build();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::deleteProgram(Program* program)
+{
+  for (int k = 0; k < 3; ++k)
+  {
+    if (program->shaders[k])
+    {
+      glDetachShader(program->id, program->shaders[k]);
+      glDeleteShader(program->shaders[k]);
+    }
+    program->shaders[k] = 0;
+  }
+  if (program->id)
+    glDeleteProgram(program->id);
+  program->id = 0;
+  program->uniforms.clear();
+}
+//-----------------------------------------------------------------------------
+// compiler and linker messages of a failed build
+//-----------------------------------------------------------------------------
+void ShaderManager::printLogs(const Build& build)
+{
+  if (!build.variant.empty())
+    printf("Variant: %s\n", build.variant.c_str());
+  for (int k = 0; k < 3; ++k)
+  {
+    if (build.shaders[k] == 0)
+      continue;
+    GLint result = GL_FALSE;
+    glGetShaderiv(build.shaders[k], GL_COMPILE_STATUS, &result);
+    if (result)
+      continue;
+    printf("Shader '%s%s' failed compilation.\n",
+           _shader_location.c_str(), _filenames[k].c_str());
+
+    GLint errorLoglength = 0;
+    glGetShaderiv(build.shaders[k], GL_INFO_LOG_LENGTH, &errorLoglength);
+    std::vector<char> errorLogText(errorLoglength + 1, 0);
+    glGetShaderInfoLog(build.shaders[k], errorLoglength, NULL, &errorLogText[0]);
+    printf("%s\n", &errorLogText[0]);
+  }
+  glGetProgramInfoLog(build.program, sizeof(buffer), &len, buffer);
   if (len)
+    printf("Could not link %u: '%s'\n", build.program, buffer);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::selectVariant()
+{
+  std::map<std::string, Program>::iterator it = _programs.find(_variant);
+  if (it != _programs.end())
   {
-    printf("Could not link %u: '%s'\n", _programID, buffer);
-    return 1;
+    _current = &it->second;
+    _currentVariant = _variant;
+    return;
   }
-  return 0;
+  if (_variant == _failedVariant)
+    return;
+  if (_pending.program && _pending.variant == _variant)
+    return;
+  // keep rendering the current variant until the requested one is linked
+  if (_pending.program)
+    deleteBuild(&_pending);
+  _pending.variant = _variant;
+  beginBuild(&_pending);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::cacheUniforms(Program* program)
+{
+  program->uniforms.clear();
+  GLint count = 0;
+  GLint maxlen = 0;
+  glGetProgramiv(program->id, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(program->id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxlen);
+  std::vector<GLchar> name(maxlen + 1);
+  for (GLint k = 0; k < count; ++k)
+  {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(program->id, k, maxlen + 1, &length, &size, &type, &name[0]);
+    GLint location = glGetUniformLocation(program->id, &name[0]);
+    // members of uniform blocks have no location
+    if (location < 0)
+      continue;
+    std::string uname(&name[0], length);
+    program->uniforms[uname] = location;
+    // arrays are reported as "name[0]", but also addressed as "name"
+    if (uname.size() > 3 && uname.compare(uname.size() - 3, 3, "[0]") == 0)
+      program->uniforms[uname.substr(0, uname.size() - 3)] = location;
+  }
+
+  std::map<std::string, GLuint>::const_iterator it;
+  for (it = _blockBindings.begin(); it != _blockBindings.end(); ++it)
+  {
+    GLuint index = glGetUniformBlockIndex(program->id, it->first.c_str());
+    if (index != GL_INVALID_INDEX)
+      glUniformBlockBinding(program->id, index, it->second);
+  }
+
+  if (!_samplerUnits.empty())
+  {
+    GLint current = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+    glUseProgram(program->id);
+    std::map<std::string, GLint>::const_iterator su;
+    for (su = _samplerUnits.begin(); su != _samplerUnits.end(); ++su)
+    {
+      std::unordered_map<std::string, GLint>::const_iterator loc = program->uniforms.find(su->first);
+      if (loc != program->uniforms.end())
+        glUniform1i(loc->second, su->second);
+    }
+    glUseProgram(current);
+  }
+  CHECK_GLERROR();
 }
 //-----------------------------------------------------------------------------
 //
 //-----------------------------------------------------------------------------
-GLuint ShaderManager::loadShader(const char *filename, int type)
+bool ShaderManager::loadBinary(GLuint program, unsigned long long key)
+{
+#ifdef NO_SHADER_CACHE
+  return false;
+#else
+  if (!GLEW_ARB_get_program_binary)
+    return false;
+
+  char name[32];
+  sprintf(name, "%016llx.bin", key);
+  FILE* f = fopen((_cache_location + name).c_str(), "rb");
+  if (f == NULL)
+    return false;
+
+  BinaryHeader header;
+  std::vector<char> data;
+  bool valid = fread(&header, sizeof(header), 1, f) == 1
+            && memcmp(header.magic, BINARY_MAGIC, 4) == 0
+            && header.key == key
+            && header.length > 0;
+  if (valid)
+  {
+    data.resize(header.length);
+    valid = fread(&data[0], 1, header.length, f) == (size_t) header.length;
+  }
+  fclose(f);
+  if (!valid)
+    return false;
+
+  // an unknown format would raise GL_INVALID_ENUM, so it is not passed on
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  std::vector<GLint> supported(formats > 0 ? formats : 1, 0);
+  if (formats > 0)
+    glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, &supported[0]);
+  if (std::find(supported.begin(), supported.begin() + formats, (GLint) header.format)
+      == supported.begin() + formats)
+    return false;
+
+  // a rejected binary (e.g. after driver update) fails to link
+  glProgramBinary(program, header.format, &data[0], header.length);
+  GLint status = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &status);
+  return status == GL_TRUE;
+#endif
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::storeBinary(GLuint program, unsigned long long key)
+{
+#ifndef NO_SHADER_CACHE
+  if (!GLEW_ARB_get_program_binary)
+    return;
+
+  BinaryHeader header;
+  memcpy(header.magic, BINARY_MAGIC, 4);
+  header.key = key;
+  header.format = 0;
+  header.length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &header.length);
+  if (header.length <= 0)
+    return;
+  std::vector<char> data(header.length);
+  glGetProgramBinary(program, header.length, NULL, &header.format, &data[0]);
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return;
+
+#ifdef M_WINDOWS
+  _mkdir(_cache_location.c_str());
+#else
+  mkdir(_cache_location.c_str(), 0755);
+#endif
+  char name[32];
+  sprintf(name, "%016llx.bin", key);
+  FILE* f = fopen((_cache_location + name).c_str(), "wb");
+  if (f == NULL)
+  {
+    fprintf(stderr, "Could not write program binary to '%s'.\n", _cache_location.c_str());
+    return;
+  }
+  fwrite(&header, sizeof(header), 1, f);
+  fwrite(&data[0], 1, header.length, f);
+  fclose(f);
+#endif
+}
+//-----------------------------------------------------------------------------
+// compilation status is checked in finishBuild()
+//-----------------------------------------------------------------------------
+GLuint ShaderManager::loadShader(const std::string& source, const char *filename, int type)
 {
   if (filename == NULL)
   {
     printf("ERROR. No Filename given.\n");
-    exit(1);
+    return 0;
   }
   std::string filename_full = _shader_location;
-  GLhandleARB handle;
-
-  // shader Compilation variable
-  GLint result; // Compilation code result
-  GLint errorLoglength;
-  char* errorLogText;
-  GLsizei actualErrorLogLength;
+  GLuint handle;
 
   filename_full += filename;
 
-  handle = glCreateShaderObjectARB(type);
+  handle = glCreateShader(type);
   if (!handle)
   {
     //We have failed creating the vertex shader object.
-    printf("Failed creating vertex shader object from file: %s.", filename_full);
-    exit(1);
+    printf("Failed creating shader object from file: %s.\n", filename_full.c_str());
+    return 0;
   }
 
-  std::string content;
-  readEntireFile(&content, filename_full.c_str());
-  GLchar const *shader_source = content.c_str();
-  GLint const shader_length = content.size();
+  GLchar const *shader_source = source.c_str();
+  GLint const shader_length = source.size();
   glShaderSource(handle, //The handle to our shader
       1, //The number of files.
       &shader_source, //An array of const char * data, which represents the source code of theshaders
       &shader_length);
 
-  glCompileShaderARB(handle);
-
-  //Compilation checking.
-  glGetObjectParameterivARB(handle, GL_OBJECT_COMPILE_STATUS_ARB, &result);
-
-  // If an error was detected.
-  if (!result)
-  {
-    //We failed to compile.
-    printf("Shader '%s' failed compilation.\n", filename_full);
-
-    //Attempt to get the length of our error log.
-    glGetObjectParameterivARB(handle, GL_OBJECT_INFO_LOG_LENGTH_ARB,
-                              &errorLoglength);
-
-    //Create a buffer to read compilation error message
-    errorLogText = (char*) malloc(sizeof(char) * errorLoglength);
-
-    //Used to get the final length of the log.
-    glGetInfoLogARB(handle, errorLoglength, &actualErrorLogLength,
-                    errorLogText);
-
-    // Display errors.
-    printf("%s\n", errorLogText);
-
-    // Free the buffer malloced earlier
-    free(errorLogText);
-    exit(1);
-  }
+  glCompileShader(handle);
 
   return handle;
 }
@@ -157,12 +631,26 @@ GLuint ShaderManager::loadShader(const char *filename, int type)
 //-----------------------------------------------------------------------------
 int ShaderManager::getUniformVarID(const char *name)
 {
-  glGetUniformLocation(_programID, name);
-  if(CHECK_GLERROR()!=GL_NO_ERROR){
-    fprintf(stderr, "Could not get uniform location '%s'.\n", name);
+  if (_current == NULL)
     return -1;
-  }
-  return glGetUniformLocation(_programID, name);
+  std::unordered_map<std::string, GLint>::const_iterator it = _current->uniforms.find(name);
+  if (it == _current->uniforms.end())
+    return -1;
+  return it->second;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::setUniformBlockBinding(const char* name, GLuint binding)
+{
+  _blockBindings[name] = binding;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderManager::setSamplerUnit(const char* name, GLint unit)
+{
+  _samplerUnits[name] = unit;
 }
 //-----------------------------------------------------------------------------
 //
@@ -232,7 +720,11 @@ void ShaderManager::setUniformMat4(const char* name, const float* array)
 //-----------------------------------------------------------------------------
 void ShaderManager::bind()
 {
-  glUseProgram(_programID);
+  if (_pending.program)
+    update();
+  if (_isLoaded && (_current == NULL || _currentVariant != _variant))
+    selectVariant();
+  glUseProgram(programID());
   glEnable(GL_VERTEX_PROGRAM_ARB);
   glEnable(GL_FRAGMENT_PROGRAM_ARB);
 }
@@ -255,7 +747,7 @@ bool ShaderManager::isLoaded()
 //-----------------------------------------------------------------------------
 //
 //-----------------------------------------------------------------------------
-void ShaderManager::readEntireFile(std::string* content, const char * filename)
+int ShaderManager::readEntireFile(std::string* content, const char * filename)
 {
   // --- Read file
   std::string line;
@@ -272,38 +764,30 @@ void ShaderManager::readEntireFile(std::string* content, const char * filename)
   else
   {
     printf("Could not open file '%s'.\n", filename);
-    exit(1);
+    return 1;
   }
+  return 0;
 }
 //-----------------------------------------------------------------------------
 //
 //-----------------------------------------------------------------------------
 void ShaderManager::unload()
 {
-  if (_programID == 0)
-  {
-    printf("Error occurred on unloading Shader.\n");
-    exit(1);
-  }
-  if (_vertexShaderID)
-    glDetachShader(_programID, _vertexShaderID);
-  if (_pixelShaderID)
-    glDetachShader(_programID, _pixelShaderID);
-  if (_geoShaderID)
-    glDetachShader(_programID, _geoShaderID);
+  // the current program stays in use until the next successful link
+  if (_pending.program)
+    deleteBuild(&_pending);
   _isLoaded = false;
-
+  _compute = false;
 }
 
 void
 ShaderManager::init()
 {
-  _programID=0;
-  _vertexShaderID=0;
-  _pixelShaderID=0;
-  _geoShaderID=0;
   _isLoaded=false;
+  _compute=false;
+  _current=NULL;
   _shader_location="./";
+  _cache_location=SHADER_CACHE_LOCATION;
 }
 
 void
@@ -311,3 +795,9 @@ ShaderManager::setShaderLocation(const char* shader_location)
 {
   _shader_location = shader_location;
 }
+
+void
+ShaderManager::setCacheLocation(const char* cache_location)
+{
+  _cache_location = cache_location;
+}
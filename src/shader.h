@@ -3,6 +3,12 @@
  * @brief OpenGL shader helper class.
  * @author Matthias Werner
  * @sa http://11235813tdd.blogspot.de/
+ * @date 2026/10/18: #include of shared shader files.
+ * @date 2026/10/18: Compute shader programs.
+ * @date 2026/10/18: Shader variants by injected defines.
+ * @date 2026/10/18: Non-blocking reload keeping the previous program on errors.
+ * @date 2026/10/18: Uniform location cache, uniform block bindings.
+ * @date 2026/10/18: Program binary cache.
  * @date 2016/03/12: Shader location support.
  * @date 2013/04/26: Release.
  * @date 2013/04/02: Initial commit.
@@ -13,22 +19,91 @@
 
 #include "gl_globals.h"
 #include <string>
+#include <map>
+#include <unordered_map>
 
 /**
- * Manages vertex, fragment and geometry shaders.
+ * Manages vertex, fragment and geometry shaders (or a compute shader).
+ *
+ * Every (re)build creates a new program object. The current program stays
+ * in use until the new one has compiled and linked successfully, so shader
+ * errors during reload() are reported but never interrupt rendering.
+ * Builds started by reload() are completed in bind() without blocking if
+ * the driver supports KHR/ARB_parallel_shader_compile.
+ *
+ * Shader variants: defines set by setDefine() are injected after the
+ * #version line of every stage. Each combination of defines is compiled
+ * once and cached, bind() switches between known variants for free.
+ *
+ * Shared declarations: a line #include "file" is replaced by the file from
+ * the shader location (one level, no include guards), see common.glsl.
  */
 class ShaderManager
 {
 public:
   ShaderManager();
   ShaderManager(const char* shader_location);
-  void load(const char * vertexshader,
+  /**
+   * Reads the shader files and starts compilation, complete it with link().
+   * @retval 0 on success, 1 if a file could not be read.
+   */
+  int  load(const char * vertexshader,
             const char * pixelshader,
             const char * geoshader = NULL);
+  /**
+   * Same as load() for a compute shader program (GL 4.3), run it with
+   * bind() and glDispatchCompute().
+   */
+  int  loadCompute(const char * computeshader);
+  /**
+   * Waits for the build started by load() and makes it the current program.
+   * @retval 0 on success, 1 on compile or link errors (previous program is kept).
+   */
   int  link();
+  /**
+   * Starts rebuilding the loaded shader files in the background.
+   * The new program replaces the current one in bind() once it is linked.
+   * All other cached variants are dropped and rebuilt on demand.
+   * @retval 0 if the build has been started.
+   */
+  int  reload();
+  /**
+   * Completes a pending build without blocking (if supported by the driver).
+   * @retval 1 if the program has been replaced, 0 otherwise.
+   */
+  int  update();
+  /// true while a build started by reload() is compiling
+  bool isPending() const { return _pending.program != 0; }
+  /// true if bind() uses the program of the requested variant
+  bool isCurrent() const { return _current != NULL && _currentVariant == _variant; }
+  /**
+   * Sets define (as "#define name value") for the next bind() or load().
+   * A variant that has not been compiled yet is built in the background.
+   */
+  void setDefine(const char* name, int value);
+  void removeDefine(const char* name);
+  /// defines of the requested variant, e.g. "LIGHTING=2 WRITE_DEPTH=1"
+  const std::string& variant() const { return _variant; }
+  /// number of cached (linked) variants
+  unsigned variantCount() const { return (unsigned) _programs.size(); }
   void bind();
   void setShaderLocation(const char* );
+  void setCacheLocation(const char* );
+  /**
+   * Uniform location from the table built at link time.
+   * @retval -1 if the program has no such (active) uniform.
+   */
   int  getUniformVarID(const char * name);
+  /**
+   * Assigns uniform block name to a uniform buffer binding point.
+   * The binding is (re-)applied on every link.
+   */
+  void setUniformBlockBinding(const char* name, GLuint binding);
+  /**
+   * Assigns sampler uniform to a texture unit.
+   * The unit is (re-)applied on every link.
+   */
+  void setSamplerUnit(const char* name, GLint unit);
 
   void setUniformVar(const char* name, int varValue);
   void setUniformVar(const char* name, int var[4]);
@@ -45,20 +120,73 @@ public:
   void unload();
   bool isLoaded();
 
-  GLuint programID() const{ return _programID; }
+  GLuint programID() const{ return _current ? _current->id : 0; }
 
 private:
-  GLuint loadShader(const char * filename, int type);
-  void   readEntireFile(std::string* content, const char * filename);
+  /// linked program of one variant
+  struct Program
+  {
+    Program() : id(0) { shaders[0] = shaders[1] = shaders[2] = 0; }
+    GLuint id;
+    GLuint shaders[3];
+    std::unordered_map<std::string, GLint> uniforms;
+  };
+  /// program object under construction
+  struct Build
+  {
+    Build() : program(0), binary(false), key(0) { shaders[0] = shaders[1] = shaders[2] = 0; }
+    GLuint program;
+    GLuint shaders[3];
+    bool   binary;
+    unsigned long long key;
+    std::string variant;
+  };
+  enum BuildStatus { BUILD_PENDING, BUILD_OK, BUILD_FAILED };
+
+  GLuint loadShader(const std::string& source, const char * filename, int type);
+  int    readEntireFile(std::string* content, const char * filename);
   void   init();
+  /// replaces #include lines by the files, 1 if one could not be read
+  int    expandIncludes(std::string* source);
+  /// inserts the defines of the variant behind the #version line
+  void   injectDefines(std::string* source);
+  /// reads sources, creates program and issues compile and link commands
+  int    beginBuild(Build* build);
+  /// checks build and stores it on success (wait=false: only if complete)
+  BuildStatus finishBuild(Build* build, bool wait);
+  void   deleteBuild(Build* build);
+  void   deleteProgram(Program* program);
+  void   printLogs(const Build& build);
+  /// makes the requested variant current or starts building it
+  void   selectVariant();
+  /// rebuilds the variant key from the defines
+  void   updateVariant();
+  /**
+   * Replaces the program by a cached binary, if there is one for the key.
+   * @retval true if the program has been loaded and linked successfully.
+   */
+  bool   loadBinary(GLuint program, unsigned long long key);
+  void   storeBinary(GLuint program, unsigned long long key);
+  /// builds uniform location table, applies uniform block bindings and sampler units
+  void   cacheUniforms(Program* program);
 
 private:
-  GLuint _programID;
-  GLuint _vertexShaderID;
-  GLuint _pixelShaderID;
-  GLuint _geoShaderID;
   bool   _isLoaded;
+  bool   _compute;   ///< stage 0 is a compute shader
+  Build  _pending;
+  std::string _filenames[3];
   std::string _shader_location;
+  std::string _cache_location;
+  std::map<std::string, int> _defines;
+  /// requested variant
+  std::string _variant;
+  /// variant which failed to build (not retried until reload())
+  std::string _failedVariant;
+  std::map<std::string, Program> _programs;
+  Program* _current;
+  std::string _currentVariant;
+  std::map<std::string, GLuint> _blockBindings;
+  std::map<std::string, GLint> _samplerUnits;
 };
 
 #endif
@@ -0,0 +1,51 @@
+// declarations shared by the shaders, pulled in by #include "common.glsl"
+// (expanded by ShaderManager). Blocks a program does not use are inactive.
+// The memory layouts on the C++ side are the structs named alike.
+
+// see FrameUniforms
+layout(std140) uniform FrameData
+{
+  mat4 MVMatrix;
+  mat4 PMatrix;
+  mat4 MVPMatrix;
+  vec4 lightPos;
+  vec4 viewport; // width, height, 1/width, 1/height
+};
+
+// see MultiView, MULTIVIEW_MAX_VIEWS = 4
+layout(std140) uniform ViewData
+{
+  mat4 ViewMVMatrix[4];
+  mat4 ViewPMatrix[4];
+  ivec4 ViewRange; // first view and number of views of this pass
+};
+
+// see ShadowMap, SHADOW_CASCADES_MAX = 4
+layout(std140) uniform ShadowData
+{
+  mat4 ShadowMVMatrix;    // world to light eye space
+  mat4 ShadowPMatrix[4];  // orthographic projection of each cascade
+  mat4 ShadowMatrix[4];   // camera eye space to shadow map [0,1]^3 of each cascade
+  vec4 ShadowSplits;      // far view distance of each cascade
+};
+
+// see ClusteredLights
+layout(std140) uniform LightData
+{
+  vec4 LightGridScale; // clusters per pixel (x,y), depth slice = log(-z)*z + w
+  ivec4 LightGridSize; // clusters in x, y, z and the number of lights
+};
+
+// see TransferFunction
+layout(std140) uniform ColormapData
+{
+  vec4 ColormapRange; // scalar at 0, 1/(max - min), texel scale and offset
+};
+uniform sampler1D Colormap;
+
+// color of a scalar by the transfer function, the alpha is kept
+vec4 colormap(float scalar, vec4 color)
+{
+  float t = clamp((scalar - ColormapRange.x) * ColormapRange.y, 0.0, 1.0);
+  return vec4(texture(Colormap, t * ColormapRange.z + ColormapRange.w).rgb, color.a);
+}
@@ -0,0 +1,21 @@
+#version 330 core
+
+// weighted blended OIT resolve, blended over the opaque image with
+// (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+uniform sampler2D Accum;     // sum of weighted premultiplied color, sum of weighted alpha
+uniform sampler2D Revealage; // product of (1 - alpha)
+
+layout(location = 0) out vec4 out_Color;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    float revealage = texelFetch(Revealage, texel, 0).r;
+    if (revealage == 1.0)
+      discard;
+    vec4 accum = texelFetch(Accum, texel, 0);
+    // half float overflow of many bright layers
+    if (isinf(max(max(abs(accum.r), abs(accum.g)), abs(accum.b))))
+      accum.rgb = vec3(accum.a);
+    out_Color = vec4(accum.rgb / max(accum.a, 1e-5), 1.0 - revealage);
+}
@@ -1,18 +1,83 @@
 #version 330 core
 
+// variant switches, set by ShaderManager::setDefine()
+#ifndef POINT_SPRITE
+#define POINT_SPRITE 0        // impostor coordinates from gl_PointCoord
+#endif
+#ifndef WRITE_DEPTH
+#define WRITE_DEPTH 1         // 0: depth of the billboard plane (early-z)
+#endif
+#ifndef LIGHTING
+#define LIGHTING 1            // 0: unlit, 1: diffuse, 2: diffuse+specular
+#endif
+#ifndef AMBIENT_OCCLUSION
+#define AMBIENT_OCCLUSION 1
+#endif
+#ifndef SPHERE_ID
+#define SPHERE_ID 0           // 1: write sphere index + 1 to render target 1
+#endif
+#ifndef TRANSPARENCY
+#define TRANSPARENCY 0        // 1: weighted blended OIT, accumulation and revealage targets
+#endif
+#ifndef LIGHTS
+#define LIGHTS 0              // 1: point lights of the cluster (ClusteredLights)
+#endif
+#ifndef MULTIVIEW
+#define MULTIVIEW 0           // n > 1: projection of the view from ViewData (sphere_geom.geom)
+#endif
+#ifndef SHADOW_PASS
+#define SHADOW_PASS 0         // n > 0: depth only, projection of the cascade (sphere_geom.geom)
+#endif
+#ifndef SHADOWS
+#define SHADOWS 0             // 1: directional light attenuated by the shadow map (ShadowMap)
+#endif
+#if TRANSPARENCY
+// targets 0 and 1 are taken, transparent spheres are not picked
+#undef SPHERE_ID
+#define SPHERE_ID 0
+#endif
 
-uniform mat4 PMatrix;
+#include "common.glsl"
 
-flat in vec3 sphere_color;
+#if MULTIVIEW || SHADOW_PASS
+flat in int view_index;
+#endif
+
+#if SHADOWS
+uniform sampler2DArrayShadow ShadowMap;
+#endif
+
+#if LIGHTS
+uniform samplerBuffer LightParams;    // eye position, radius; color
+uniform usamplerBuffer LightClusters; // offset, count
+uniform usamplerBuffer LightIndices;
+#endif
+
+flat in vec4 sphere_color; // alpha: opacity along the diameter
 flat in float sphere_radius;
+flat in float sphere_ao;
+#if !POINT_SPRITE
 smooth in vec2 texcoord;
+#endif
 flat in vec4 eye_position;
 flat in vec3 lightDir;
+#if SPHERE_ID
+flat in uint sphere_id;
+layout(location = 1) out uint out_ID;
+#endif
 
-out vec4 out_Color;
+#if TRANSPARENCY
+layout(location = 0) out vec4 out_Accum;
+layout(location = 1) out float out_Revealage;
+#else
+layout(location = 0) out vec4 out_Color;
+#endif
 
 void main()
 {     
+#if POINT_SPRITE
+    vec2 texcoord = gl_PointCoord* 2.0 - vec2(1.0);
+#endif
     // r^2 = (x - x0)^2 + (y - y0)^2 + (z - z0)^2
     float x = texcoord.x;
     float y = texcoord.y;
@@ -22,13 +87,92 @@ void main()
       discard;
 
     float z = sqrt(zz);    
+#if SHADOW_PASS
+    // seen from the light, only the depth is written
+    vec4 pos = eye_position;
+    pos.z += sphere_radius*z;
+    pos = ShadowPMatrix[view_index] * pos;
+    gl_FragDepth = 0.5*(pos.z / pos.w)+0.5;
+    return;
+#elif WRITE_DEPTH && !TRANSPARENCY
     vec4 pos = eye_position;
     pos.z += sphere_radius*z;
+#if MULTIVIEW
+    pos = ViewPMatrix[view_index] * pos;
+#else
     pos = PMatrix * pos;
+#endif
     gl_FragDepth = 0.5*(pos.z / pos.w)+0.5;
+#endif
     
     vec3 normal = vec3(x,y,z);
-    float diffuseTerm = clamp(dot(normal, lightDir), 0.0, 1.0);
+#if LIGHTING == 0
+    vec3 color = sphere_color.rgb;
+#else
+    vec3 surface = eye_position.xyz + sphere_radius * normal;
+    float shadow = 1.0;
+#if SHADOWS
+    // cascade of the view distance, none beyond the last split
+    int cascade = int(dot(vec4(greaterThan(vec4(-surface.z), ShadowSplits)), vec4(1.0)));
+    if (cascade < 4)
+    {
+      // offset along the normal against self-shadowing of the curved surface
+      vec4 coord = ShadowMatrix[cascade] * vec4(surface + 0.01 * normal, 1.0);
+      shadow = texture(ShadowMap, vec4(coord.xy, float(cascade), coord.z - 0.001));
+    }
+#endif
+    float diffuseTerm = shadow * clamp(dot(normal, lightDir), 0.0, 1.0);
+    vec3 color = vec3(0.15,0.15,0.15) +  diffuseTerm * sphere_color.rgb;
+#if LIGHTING == 2
+    // Blinn-Phong, the viewer looks along -z in eye space
+    vec3 halfway = normalize(lightDir + vec3(0.0, 0.0, 1.0));
+    color += shadow * vec3(0.4) * pow(clamp(dot(normal, halfway), 0.0, 1.0), 32.0);
+#endif
+#if LIGHTS
+    // lights of the cluster of the surface point
+    ivec3 cluster = ivec3(gl_FragCoord.xy * LightGridScale.xy,
+                          log(max(-surface.z, 1e-5)) * LightGridScale.z + LightGridScale.w);
+    cluster = clamp(cluster, ivec3(0), LightGridSize.xyz - 1);
+    uvec2 range = texelFetch(LightClusters,
+                             (cluster.z * LightGridSize.y + cluster.y) * LightGridSize.x + cluster.x).xy;
+    for (uint i = 0u; i < range.y; ++i)
+    {
+      int light = int(texelFetch(LightIndices, int(range.x + i)).x);
+      vec4 position_radius = texelFetch(LightParams, 2 * light);
+      vec3 toLight = position_radius.xyz - surface;
+      float distance2 = dot(toLight, toLight);
+      // smooth window, 0 at the radius of influence
+      float falloff = clamp(1.0 - distance2 / (position_radius.w * position_radius.w), 0.0, 1.0);
+      if (falloff == 0.0)
+        continue;
+      falloff *= falloff;
+      vec3 L = toLight * inversesqrt(distance2);
+      vec3 lightColor = texelFetch(LightParams, 2 * light + 1).rgb * falloff;
+      color += lightColor * clamp(dot(normal, L), 0.0, 1.0) * sphere_color.rgb;
+#if LIGHTING == 2
+      color += lightColor * 0.4 * pow(clamp(dot(normal, normalize(L + vec3(0.0, 0.0, 1.0))), 0.0, 1.0), 32.0);
+#endif
+    }
+#endif
+#endif
+#if AMBIENT_OCCLUSION
+    color *= sphere_ao;
+#endif
 
-    out_Color = vec4(vec3(0.15,0.15,0.15) +  diffuseTerm * sphere_color, 1.0);
+#if TRANSPARENCY
+    // the view ray crosses the sphere along 2 * radius * z, so by Beer-Lambert
+    // the opacity of this fragment is 1 - (1 - alpha)^z
+    float alpha = 1.0 - pow(1.0 - sphere_color.a, z);
+    // depth weight of McGuire and Bavoil (2013), eq. 7, distance of the front surface
+    float d = -(eye_position.z + sphere_radius * z);
+    float weight = alpha * clamp(10.0 / (1e-5 + pow(d / 5.0, 2.0) + pow(d / 200.0, 6.0)),
+                                 1e-2, 3e3);
+    out_Accum = vec4(color * alpha, alpha) * weight;
+    out_Revealage = alpha;
+#else
+    out_Color = vec4(color, 1.0);
+#endif
+#if SPHERE_ID
+    out_ID = sphere_id + 1u;
+#endif
 }
\ No newline at end of file
@@ -1,27 +1,97 @@
 #version 330 core
 #extension GL_EXT_gpu_shader4 : enable
 
+// variant switches, set by ShaderManager::setDefine()
+#ifndef SPHERE_COMPACT
+#define SPHERE_COMPACT 0
+#endif
+#ifndef SPHERE_QUANTIZED
+#define SPHERE_QUANTIZED 0    // 1: 16-bit normalized texels (GL_RGBA16 TBO)
+#endif
+#ifndef STREAM_POSITIONS
+#define STREAM_POSITIONS 0    // 1: centers from the Positions TBO (x,y,z)
+#endif
+#ifndef INTERPOLATE
+#define INTERPOLATE 0         // 1: blend Positions and NextPositions
+#endif
+#ifndef SPHERE_ID
+#define SPHERE_ID 0           // 1: sphere index for ID buffer picking
+#endif
+
+#if SPHERE_COMPACT || SPHERE_QUANTIZED
+// 2 texels per sphere: (x,y,z,radius), (r,g,b,ao)
+#define SPHERE_TEXELS 2
+#else
+// 3 texels per sphere: (x,y,z,w), (r,g,b,a), (radius,ao,-,-)
+#define SPHERE_TEXELS 3
+#endif
+
 layout(location = 0) in vec2  SphereImpostorSpace;
 
 uniform samplerBuffer SphereParams;
-uniform mat4 MVMatrix;
-uniform mat4 PMatrix;
-uniform vec4 lightPos;
+#if SPHERE_COMPACT || SPHERE_QUANTIZED
+// no alpha texel, sphereAlpha() (tools.h) from radius mean and 1/variance
+uniform vec4 AlphaRadius;
+#endif
+#if SPHERE_QUANTIZED
+// x,y,z,radius = QuantizeOrigin + texel * QuantizeScale
+uniform vec4 QuantizeOrigin;
+uniform vec4 QuantizeScale;
+#endif
+#if STREAM_POSITIONS
+uniform samplerBuffer Positions;
+#if INTERPOLATE
+uniform samplerBuffer NextPositions;
+uniform float PositionBlend;
+#endif
+#endif
+
+#include "common.glsl"
 
 smooth out vec2 texcoord;
 flat out vec4 eye_position;
-flat out vec3 sphere_color;
+flat out vec4 sphere_color;
 flat out float sphere_radius;
+flat out float sphere_ao;
 flat out vec3 lightDir;
+#if SPHERE_ID
+flat out uint sphere_id;
+#endif
 
 void main()
 {
-  int id = int(gl_VertexID/4) * 3;
+  int sphere = int(gl_VertexID/4);
+  int id = sphere * SPHERE_TEXELS;
   texcoord = SphereImpostorSpace;
+#if SPHERE_ID
+  sphere_id = uint(sphere);
+#endif
   // Output vertex position
+#if SPHERE_COMPACT || SPHERE_QUANTIZED
+  vec4 position_radius = texelFetchBuffer(SphereParams, id);
+#if SPHERE_QUANTIZED
+  position_radius = QuantizeOrigin + position_radius * QuantizeScale;
+#endif
+  vec4 color_ao = texelFetchBuffer(SphereParams, id+1);
+  eye_position = MVMatrix * vec4(position_radius.xyz, 1.0);
+  float alpha = 1.0 - 0.8 * (position_radius.w - AlphaRadius.x) * AlphaRadius.y;
+  sphere_color = vec4(color_ao.xyz, clamp(alpha, 0.2, 1.0));
+  sphere_radius = position_radius.w;
+  sphere_ao = color_ao.w;
+#else
   eye_position = MVMatrix * texelFetchBuffer(SphereParams, id);
-  sphere_color = texelFetchBuffer(SphereParams, id+1).xyz;
-  sphere_radius = texelFetchBuffer(SphereParams, id+2).x;
+  sphere_color = texelFetchBuffer(SphereParams, id+1);
+  vec2 radius_ao = texelFetchBuffer(SphereParams, id+2).xy;
+  sphere_radius = radius_ao.x;
+  sphere_ao = radius_ao.y;
+#endif
+#if STREAM_POSITIONS
+  vec3 center = texelFetchBuffer(Positions, sphere).xyz;
+#if INTERPOLATE
+  center = mix(center, texelFetchBuffer(NextPositions, sphere).xyz, PositionBlend);
+#endif
+  eye_position = MVMatrix * vec4(center, 1.0);
+#endif
 
   lightDir = normalize(lightPos.xyz);
   
@@ -0,0 +1,71 @@
+#version 330 core
+#extension GL_EXT_gpu_shader4 : enable
+
+// variant switches, set by ShaderManager::setDefine()
+#ifndef DRAW_ID
+#define DRAW_ID 0             // 1: group from gl_DrawIDARB, 0: from SphereGroup
+#endif
+#ifndef COLORMAP
+#define COLORMAP 0            // 1: color of the scalar attribute from the transfer function
+#endif
+#ifndef SPHERE_ID
+#define SPHERE_ID 0           // 1: sphere index for ID buffer picking
+#endif
+
+#if DRAW_ID
+#extension GL_ARB_shader_draw_parameters : require
+#endif
+
+// texels per group: rotation quaternion, translation + scale
+#define TRANSFORM_TEXELS 2
+
+layout(location = 0) in vec4  SpherePosition; // group-local space
+layout(location = 1) in vec4  SphereColor;
+layout(location = 2) in float SphereRadius;
+layout(location = 3) in float SphereOcclusion;
+layout(location = 4) in uint  SphereGroup;    // per draw (baseInstance)
+
+#if COLORMAP
+layout(location = 5) in float SphereScalar;
+#endif
+
+uniform samplerBuffer GroupTransforms; // updated each frame
+uniform samplerBuffer GroupMaterials;  // tint
+
+#include "common.glsl"
+
+out vec4 sphere_color_in;
+out float sphere_radius_in;
+out float sphere_ao_in;
+#if SPHERE_ID
+flat out uint sphere_id_in; // gl_VertexID includes the first vertex of the draw
+#endif
+
+void main()
+{
+#if DRAW_ID
+  int group = gl_DrawIDARB;
+#else
+  int group = int(SphereGroup);
+#endif
+  vec4 q = texelFetchBuffer(GroupTransforms, group * TRANSFORM_TEXELS);
+  vec4 translation_scale = texelFetchBuffer(GroupTransforms, group * TRANSFORM_TEXELS + 1);
+  vec3 material = texelFetchBuffer(GroupMaterials, group).xyz;
+
+  // rigid transform: scale, rotate by unit quaternion q, translate
+  vec3 p = SpherePosition.xyz * translation_scale.w;
+  p += 2.0 * cross(q.xyz, cross(q.xyz, p) + q.w * p);
+
+#if COLORMAP
+  // the scalar replaces the color and the tint of the group
+  sphere_color_in = colormap(SphereScalar, SphereColor);
+#else
+  sphere_color_in = vec4(SphereColor.xyz * material, SphereColor.w);
+#endif
+  sphere_radius_in = SphereRadius * translation_scale.w;
+  sphere_ao_in = SphereOcclusion;
+#if SPHERE_ID
+  sphere_id_in = uint(gl_VertexID);
+#endif
+  gl_Position = vec4(p + translation_scale.xyz, 1.0);
+}
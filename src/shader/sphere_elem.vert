@@ -1,27 +1,39 @@
 #version 330 core
 
+// variant switches, set by ShaderManager::setDefine()
+#ifndef SPHERE_ID
+#define SPHERE_ID 0           // 1: sphere index for ID buffer picking
+#endif
+
 layout(location = 0) in vec4  SpherePosition;
 layout(location = 1) in vec4  SphereColor;
 layout(location = 2) in float SphereRadius;
 layout(location = 3) in vec2  SphereTexCoord;
+layout(location = 4) in float SphereOcclusion;
 
-uniform mat4 MVMatrix;
-uniform mat4 PMatrix;
-uniform vec4 lightPos;
+#include "common.glsl"
 
 smooth out vec2 texcoord;
 flat out vec4 eye_position;
-flat out vec3 sphere_color;
+flat out vec4 sphere_color;
 flat out float sphere_radius;
+flat out float sphere_ao;
 flat out vec3 lightDir;
+#if SPHERE_ID
+flat out uint sphere_id;
+#endif
 
 void main()
 {
   texcoord = SphereTexCoord;
+#if SPHERE_ID
+  sphere_id = uint(gl_VertexID / 4);
+#endif
   // Output vertex position
   eye_position = MVMatrix * SpherePosition;
-  sphere_color = SphereColor.xyz;
+  sphere_color = SphereColor;
   sphere_radius = SphereRadius;
+  sphere_ao = SphereOcclusion;
 
   lightDir = normalize(lightPos.xyz);
   
@@ -1,17 +1,53 @@
 #version 330 core
 #extension GL_EXT_gpu_shader4 : enable
 
+// variant switches, set by ShaderManager::setDefine()
+#ifndef INTERPOLATE
+#define INTERPOLATE 0         // 1: blend between two streamed position frames
+#endif
+#ifndef COLORMAP
+#define COLORMAP 0            // 1: color of the scalar attribute from the transfer function
+#endif
+#ifndef SPHERE_ID
+#define SPHERE_ID 0           // 1: sphere index for ID buffer picking
+#endif
+
 layout(location = 0) in vec4  SpherePosition;
 layout(location = 1) in vec4  SphereColor;
 layout(location = 2) in float SphereRadius;
+layout(location = 3) in float SphereOcclusion;
+#if COLORMAP
+layout(location = 5) in float SphereScalar;
+#endif
+#if INTERPOLATE
+layout(location = 4) in vec3  SphereNextPosition;
+uniform float PositionBlend;
+#endif
 
-out vec3 sphere_color_in;
-out float sphere_radius_in;
+#include "common.glsl"
 
+out vec4 sphere_color_in;
+out float sphere_radius_in;
+out float sphere_ao_in;
+#if SPHERE_ID
+flat out uint sphere_id_in;
+#endif
 
 void main()
 {  
-  sphere_color_in = SphereColor.xyz;
+#if COLORMAP
+  sphere_color_in = colormap(SphereScalar, SphereColor);
+#else
+  sphere_color_in = SphereColor;
+#endif
   sphere_radius_in = SphereRadius;
+  sphere_ao_in = SphereOcclusion;
+#if SPHERE_ID
+  sphere_id_in = uint(gl_VertexID);
+#endif
+#if INTERPOLATE
+  gl_Position = vec4(mix(SpherePosition.xyz, SphereNextPosition, PositionBlend), 1.0);
+#else
   gl_Position = SpherePosition;
+#endif
 }
\ No newline at end of file
@@ -1,19 +1,51 @@
 #version 330 core
 
+// variant switches, set by ShaderManager::setDefine()
+#ifndef LIGHTING
+#define LIGHTING 1            // 0: unlit, 1: diffuse, 2: diffuse+specular
+#endif
+#ifndef AMBIENT_OCCLUSION
+#define AMBIENT_OCCLUSION 1
+#endif
+#ifndef SPHERE_ID
+#define SPHERE_ID 0           // 1: write sphere index + 1 to render target 1
+#endif
+
 in vec3 normal;
 in vec3 color;
+in float occlusion;
+#if SPHERE_ID
+flat in uint sphere_id;
+layout(location = 1) out uint out_ID;
+#endif
 
-uniform vec4 lightPos;
+#include "common.glsl"
  
-out vec4 out_Color;
+layout(location = 0) out vec4 out_Color;
  
 void main()
 {
+#if LIGHTING == 0
+  vec3 shaded = color;
+#else
   float dot1 = dot(normalize(lightPos.xyz), normal);
   float backlight = clamp(-dot1,0.0,0.5);
   vec3 ambient = vec3(0.1, 0.1, backlight); // ambient
   
   float diffuse = clamp(dot1, 0.0, 1.0);
+  vec3 shaded = ambient + diffuse * color;
+#if LIGHTING == 2
+  // viewer along -z as for the impostors
+  vec3 halfway = normalize(normalize(lightPos.xyz) + vec3(0.0, 0.0, 1.0));
+  shaded += vec3(0.4) * pow(clamp(dot(normal, halfway), 0.0, 1.0), 32.0);
+#endif
+#endif
+#if AMBIENT_OCCLUSION
+  shaded *= occlusion;
+#endif
   
-  out_Color = vec4(ambient + diffuse * color, 1.0);
+  out_Color = vec4(shaded, 1.0);
+#if SPHERE_ID
+  out_ID = sphere_id + 1u;
+#endif
 }
\ No newline at end of file
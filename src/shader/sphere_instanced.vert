@@ -2,33 +2,47 @@
 #extension GL_EXT_gpu_shader4 : require
 #extension GL_ARB_draw_instanced : require
 
+// variant switches, set by ShaderManager::setDefine()
+#ifndef SPHERE_ID
+#define SPHERE_ID 0           // 1: sphere index for ID buffer picking
+#endif
+
 layout(location=0) in vec3 in_Position;
 layout(location=1) in vec3 in_Normal;
  
 uniform samplerBuffer tboParams;
-uniform mat4 MVPMatrix; // modelviewprojection
+
+#include "common.glsl"
 
 out vec3 normal;
 out vec3 position;
 out vec3 color;
+out float occlusion;
+#if SPHERE_ID
+flat out uint sphere_id;
+#endif
 
 void main()
 {
     vec4  transform = vec4(
-                        texelFetchBuffer(tboParams, 9*gl_InstanceID).r,
-                        texelFetchBuffer(tboParams, 9*gl_InstanceID+1).r,
-                        texelFetchBuffer(tboParams, 9*gl_InstanceID+2).r,
-                        texelFetchBuffer(tboParams, 9*gl_InstanceID+3).r);
+                        texelFetchBuffer(tboParams, 10*gl_InstanceID).r,
+                        texelFetchBuffer(tboParams, 10*gl_InstanceID+1).r,
+                        texelFetchBuffer(tboParams, 10*gl_InstanceID+2).r,
+                        texelFetchBuffer(tboParams, 10*gl_InstanceID+3).r);
     color           = vec3(
-                        texelFetchBuffer(tboParams, 9*gl_InstanceID+4).r,
-                        texelFetchBuffer(tboParams, 9*gl_InstanceID+5).r,
-                        texelFetchBuffer(tboParams, 9*gl_InstanceID+6).r);
-    float radius    = texelFetchBuffer(tboParams, 9*gl_InstanceID+8).r;
+                        texelFetchBuffer(tboParams, 10*gl_InstanceID+4).r,
+                        texelFetchBuffer(tboParams, 10*gl_InstanceID+5).r,
+                        texelFetchBuffer(tboParams, 10*gl_InstanceID+6).r);
+    float radius    = texelFetchBuffer(tboParams, 10*gl_InstanceID+8).r;
+    occlusion       = texelFetchBuffer(tboParams, 10*gl_InstanceID+9).r;
     
     vec4  vertex    = vec4((in_Position * transform.w * radius + transform.xyz), 1.0);
     
 
 //color = vec4(cos(9.423*strength),sin(-9.423*strength+3.141),sin(9.423*strength-0.782),1.0);
     normal   = in_Normal;
+#if SPHERE_ID
+    sphere_id = uint(gl_InstanceID);
+#endif
     gl_Position = MVPMatrix * vertex;
 }
\ No newline at end of file
@@ -1,25 +1,57 @@
 #version 330 core
 
+// variant switches, set by ShaderManager::setDefine()
+#ifndef INTERPOLATE
+#define INTERPOLATE 0         // 1: blend between two streamed position frames
+#endif
+#ifndef COLORMAP
+#define COLORMAP 0            // 1: color of the scalar attribute from the transfer function
+#endif
+#ifndef SPHERE_ID
+#define SPHERE_ID 0           // 1: sphere index for ID buffer picking
+#endif
+
 layout(location = 0) in vec4  SpherePosition;
 layout(location = 1) in vec4  SphereColor;
 layout(location = 2) in float SphereRadius;
+layout(location = 3) in float SphereOcclusion;
+#if COLORMAP
+layout(location = 5) in float SphereScalar;
+#endif
+#if INTERPOLATE
+layout(location = 4) in vec3  SphereNextPosition;
+uniform float PositionBlend;
+#endif
 
-uniform mat4 MVMatrix;
-uniform mat4 PMatrix;
-uniform vec4 lightPos;
-uniform int screenWidth;   // scale to calculate size in pixels
+#include "common.glsl"
 
 flat out vec4 eye_position;
-flat out vec3 sphere_color;
+flat out vec4 sphere_color;
 flat out float sphere_radius;
+flat out float sphere_ao;
 flat out vec3 lightDir;
+#if SPHERE_ID
+flat out uint sphere_id;
+#endif
 
 void main()
 {
   // Output vertex position
+#if INTERPOLATE
+  eye_position = MVMatrix * vec4(mix(SpherePosition.xyz, SphereNextPosition, PositionBlend), 1.0);
+#else
   eye_position = MVMatrix * SpherePosition;
-  sphere_color = SphereColor.xyz;
+#endif
+#if COLORMAP
+  sphere_color = colormap(SphereScalar, SphereColor);
+#else
+  sphere_color = SphereColor;
+#endif
   sphere_radius = SphereRadius;
+  sphere_ao = SphereOcclusion;
+#if SPHERE_ID
+  sphere_id = uint(gl_VertexID);
+#endif
 
   lightDir = normalize(lightPos.xyz);
   float dist = length(eye_position.xyz);
@@ -28,5 +60,5 @@ void main()
   gl_Position = PMatrix * gl_Position;
 // http://stackoverflow.com/questions/8608844/resizing-point-sprites-based-on-distance-from-the-camera
   vec4 projCorner = PMatrix * vec4(sphere_radius, sphere_radius, eye_position.z, eye_position.w);
-  gl_PointSize = screenWidth * projCorner.x / projCorner.w;
+  gl_PointSize = viewport.x * projCorner.x / projCorner.w;
 }
\ No newline at end of file
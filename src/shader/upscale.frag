@@ -0,0 +1,55 @@
+#version 330 core
+
+// variant switches, set by ShaderManager::setDefine()
+#ifndef EDGE_AWARE
+#define EDGE_AWARE 1          // 0: plain bilinear
+#endif
+// relative linear depth difference at which a texel weight drops to 1/e
+#define EDGE_DEPTH 0.02
+
+#include "common.glsl"
+
+uniform sampler2D Color;
+uniform sampler2D Depth;
+uniform vec4 SourceSize; // width, height, 1/width, 1/height
+
+smooth in vec2 texcoord;
+
+layout(location = 0) out vec4 out_Color;
+
+// eye space distance along -z of a depth buffer value
+float linearDepth(float depth)
+{
+    return PMatrix[3][2] / (2.0 * depth - 1.0 + PMatrix[2][2]);
+}
+
+void main()
+{
+#if EDGE_AWARE
+    vec2 p = texcoord * SourceSize.xy - vec2(0.5);
+    vec2 f = fract(p);
+    ivec2 base = ivec2(floor(p));
+    ivec2 last = ivec2(SourceSize.xy) - ivec2(1);
+    ivec2 texel[4] = ivec2[4](base, base + ivec2(1, 0), base + ivec2(0, 1), base + ivec2(1, 1));
+    float bilinear[4] = float[4]((1.0 - f.x) * (1.0 - f.y), f.x * (1.0 - f.y),
+                                 (1.0 - f.x) * f.y, f.x * f.y);
+    // the texel nearest to the pixel decides which surface the pixel shows
+    ivec2 nearest = clamp(ivec2(floor(p + vec2(0.5))), ivec2(0), last);
+    float reference = abs(linearDepth(texelFetch(Depth, nearest, 0).r));
+
+    vec3 color = vec3(0.0);
+    float sum = 0.0;
+    for (int i = 0; i < 4; ++i)
+    {
+        ivec2 t = clamp(texel[i], ivec2(0), last);
+        float depth = abs(linearDepth(texelFetch(Depth, t, 0).r));
+        float w = bilinear[i] * exp(-abs(depth - reference) / (EDGE_DEPTH * reference));
+        color += w * texelFetch(Color, t, 0).rgb;
+        sum += w;
+    }
+    // the nearest texel keeps its bilinear weight (>= 0.25), so sum > 0
+    out_Color = vec4(color / sum, 1.0);
+#else
+    out_Color = vec4(texture(Color, texcoord).rgb, 1.0);
+#endif
+}
@@ -0,0 +1,11 @@
+#version 330 core
+
+// full screen triangle, no vertex attributes
+smooth out vec2 texcoord;
+
+void main()
+{
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    texcoord = corner;
+    gl_Position = vec4(corner * 2.0 - vec2(1.0), 0.0, 1.0);
+}
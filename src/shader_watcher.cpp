@@ -0,0 +1,118 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "shader_watcher.h"
+#include "gl_globals.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(LINUX) || defined(__linux)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#define HAVE_INOTIFY 1
+#endif
+
+//-----------------------------------------------------------------------------
+// editor backup and swap files do not trigger a reload
+//-----------------------------------------------------------------------------
+static bool isShaderFile(const char* name)
+{
+  size_t n = strlen(name);
+  if (n == 0 || name[0] == '.' || name[n - 1] == '~')
+    return false;
+  if (n > 4 && strcmp(name + n - 4, ".swp") == 0)
+    return false;
+  return true;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ShaderWatcher::ShaderWatcher()
+  : _fd(-1), _wd(-1)
+{
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ShaderWatcher::~ShaderWatcher()
+{
+  stop();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ShaderWatcher::start(const char* directory)
+{
+#ifdef HAVE_INOTIFY
+  stop();
+  _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (_fd < 0)
+  {
+    fprintf(stderr, "Could not initialize inotify: %s\n", strerror(errno));
+    return 1;
+  }
+  // editors either write in place or move a temporary file over the original
+  _wd = inotify_add_watch(_fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+  if (_wd < 0)
+  {
+    fprintf(stderr, "Could not watch '%s': %s\n", directory, strerror(errno));
+    stop();
+    return 1;
+  }
+  return 0;
+#else
+  printf("Shader file watching is not supported on this platform.\n");
+  return 1;
+#endif
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+bool ShaderWatcher::poll(std::string* filename)
+{
+#ifdef HAVE_INOTIFY
+  if (_fd < 0)
+    return false;
+  bool changed = false;
+  char events[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  for (;;)
+  {
+    ssize_t n = read(_fd, events, sizeof(events));
+    if (n <= 0)
+      break;
+    for (char* p = events; p < events + n;)
+    {
+      const struct inotify_event* ev = (const struct inotify_event*) p;
+      if (ev->len > 0 && isShaderFile(ev->name))
+      {
+        changed = true;
+        if (filename)
+          *filename = ev->name;
+      }
+      p += sizeof(struct inotify_event) + ev->len;
+    }
+  }
+  return changed;
+#else
+  return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShaderWatcher::stop()
+{
+#ifdef HAVE_INOTIFY
+  if (_fd >= 0)
+  {
+    if (_wd >= 0)
+      inotify_rm_watch(_fd, _wd);
+    close(_fd);
+  }
+#endif
+  _fd = -1;
+  _wd = -1;
+}
@@ -0,0 +1,41 @@
+/*****************************************************************************/
+/**
+ * @file shader_watcher.h
+ * @brief Watches the shader directory for modifications (hot reload).
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef SHADER_WATCHER_H_
+#define SHADER_WATCHER_H_
+
+#include <string>
+
+/**
+ * Reports modified files in a directory via inotify (Linux only, on other
+ * platforms watching is disabled and poll() always returns false).
+ * The descriptor is non-blocking, so poll() can be called every frame.
+ */
+class ShaderWatcher
+{
+  public:
+    ShaderWatcher();
+    ~ShaderWatcher();
+    /**
+     * @param directory directory to watch (not recursive)
+     * @retval 0 on success
+     */
+    int start(const char* directory);
+    /**
+     * Drains pending events.
+     * @param[out] filename name of the last modified file (optional)
+     * @retval true if a shader file has been written, created or moved in
+     */
+    bool poll(std::string* filename = NULL);
+    void stop();
+
+  private:
+    int _fd;
+    int _wd;
+};
+
+#endif /* SHADER_WATCHER_H_ */
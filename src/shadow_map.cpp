@@ -0,0 +1,223 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "shadow_map.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ShadowMap::ShadowMap()
+  : _cascades(0), _size(SHADOW_MAP_SIZE), _buffer(0), _fbo(0), _depth(0),
+    _sceneCenter(0.0f), _sceneRadius(SHADOW_SCENE_RADIUS)
+{
+  _frames[0] = _frames[1] = 0;
+  _sum[0] = _sum[1] = 0.0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int ShadowMap::create(unsigned cascades, int size)
+{
+  if (cascades < 1 || cascades > SHADOW_CASCADES_MAX)
+  {
+    printf("Shadow map: %u cascades, expected 1 to %d.\n", cascades, SHADOW_CASCADES_MAX);
+    return 1;
+  }
+  _cascades = cascades;
+  _size = size;
+  glGenBuffers(1, &_buffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(ShadowData), NULL, GL_STREAM_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, SHADOW_UNIFORM_BINDING, _buffer);
+
+  // one layer per cascade, compared in the lookup with linear filtering (2x2 PCF)
+  glGenTextures(1, &_depth);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, _depth);
+  glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, _size, _size, _cascades, 0,
+               GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+  glGenFramebuffers(1, &_fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+  glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, _depth, 0);
+  glDrawBuffer(GL_NONE);
+  glReadBuffer(GL_NONE);
+  GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  if (status != GL_FRAMEBUFFER_COMPLETE)
+  {
+    fprintf(stderr, "Shadow map framebuffer incomplete (0x%x).\n", status);
+    return 1;
+  }
+
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShadowMap::setBindings(ShaderManager& shader)
+{
+  shader.setUniformBlockBinding(SHADOW_UNIFORM_BLOCK, SHADOW_UNIFORM_BINDING);
+  shader.setSamplerUnit("ShadowMap", SHADOW_TEXTURE_UNIT);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShadowMap::setScene(const glm::vec3& center, float radius)
+{
+  _sceneCenter = center;
+  _sceneRadius = radius;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShadowMap::update(const Camera& camera, const glm::vec3& direction)
+{
+  const glm::mat4 modelview = camera.modelview_glm();
+  const glm::mat4 projection = camera.projection_glm();
+  const glm::mat4 inverse_view = glm::inverse(modelview);
+  // planes of the perspective projection, the far cascade ends behind the scene
+  const float near = projection[3][2] / (projection[2][2] - 1.0f);
+  const float scene_far = -(modelview * glm::vec4(_sceneCenter, 1.0f)).z + _sceneRadius;
+  const float far = std::max(std::min(projection[3][2] / (projection[2][2] + 1.0f), scene_far),
+                             2.0f * near);
+
+  // the light looks at the scene center from outside the scene
+  const glm::vec3 light = glm::normalize(direction);
+  const glm::vec3 up = std::abs(light.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f)
+                                                 : glm::vec3(0.0f, 1.0f, 0.0f);
+  _data.MVMatrix = glm::lookAt(_sceneCenter + 2.0f * _sceneRadius * light, _sceneCenter, up);
+  const glm::mat4 eye_to_light = _data.MVMatrix * inverse_view;
+  // clip space to texture coordinates and depth in [0,1]
+  glm::mat4 bias(0.5f);
+  bias[3] = glm::vec4(0.5f, 0.5f, 0.5f, 1.0f);
+
+  float split_near = near;
+  for (unsigned c = 0; c < _cascades; ++c)
+  {
+    // practical split scheme of Zhang et al.
+    const float t = (float) (c + 1) / _cascades;
+    const float split = SHADOW_SPLIT_LAMBDA * near * std::pow(far / near, t)
+        + (1.0f - SHADOW_SPLIT_LAMBDA) * (near + (far - near) * t);
+    // bounding sphere of the slice, its size does not change with the camera
+    // orientation; the center lies on the view axis of a symmetric frustum
+    const float center_z = 0.5f * (split_near + split);
+    const glm::vec3 corner_near(split_near / projection[0][0], split_near / projection[1][1],
+                                split_near - center_z);
+    const glm::vec3 corner_far(split / projection[0][0], split / projection[1][1],
+                               split - center_z);
+    float radius = std::max(glm::length(corner_near), glm::length(corner_far));
+    glm::vec4 center = eye_to_light * glm::vec4(0.0f, 0.0f, -center_z, 1.0f);
+    if (radius > _sceneRadius)
+    {
+      radius = _sceneRadius;
+      center = _data.MVMatrix * glm::vec4(_sceneCenter, 1.0f);
+    }
+    // whole texels, so the rasterization of the casters is stable
+    const float texel = 2.0f * radius / _size;
+    center.x = std::floor(center.x / texel) * texel;
+    center.y = std::floor(center.y / texel) * texel;
+    _data.PMatrix[c] = glm::ortho(center.x - radius, center.x + radius,
+                                  center.y - radius, center.y + radius,
+                                  _sceneRadius, 3.0f * _sceneRadius);
+    _data.matrix[c] = bias * _data.PMatrix[c] * eye_to_light;
+    _data.splits[c] = split;
+    split_near = split;
+  }
+  // beyond the last cascade, points are not shadowed
+  for (unsigned c = _cascades; c < SHADOW_CASCADES_MAX; ++c)
+    _data.splits[c] = split_near;
+
+  glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ShadowData), &_data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShadowMap::bind()
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+  glViewport(0, 0, _size, _size);
+  // clears all layers
+  glClear(GL_DEPTH_BUFFER_BIT);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShadowMap::unbind(int width, int height)
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glViewport(0, 0, width, height);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShadowMap::bindTexture()
+{
+  glActiveTexture(GL_TEXTURE0 + SHADOW_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, _depth);
+  glActiveTexture(GL_TEXTURE0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShadowMap::unbindTexture()
+{
+  glActiveTexture(GL_TEXTURE0 + SHADOW_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+  glActiveTexture(GL_TEXTURE0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShadowMap::record(bool shadowed, double frame_ms)
+{
+  if (frame_ms < 0.0)
+    return;
+  ++_frames[shadowed];
+  _sum[shadowed] += frame_ms;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShadowMap::report()
+{
+  if (_cascades == 0 || _frames[1] == 0)
+    return;
+  printf("Shadows: %u cascades of %d^2, %.3f ms (%u frames)", _cascades, _size,
+         _sum[1] / _frames[1], _frames[1]);
+  if (_frames[0] > 0)
+    printf(", without %.3f ms (%u frames)", _sum[0] / _frames[0], _frames[0]);
+  printf(", splits");
+  for (unsigned c = 0; c < _cascades; ++c)
+    printf(" %.2f", _data.splits[c]);
+  printf("\n");
+  _frames[0] = _frames[1] = 0;
+  _sum[0] = _sum[1] = 0.0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ShadowMap::cleanup()
+{
+  glDeleteFramebuffers(1, &_fbo);
+  glDeleteTextures(1, &_depth);
+  glDeleteBuffers(1, &_buffer);
+  _fbo = _depth = _buffer = 0;
+  _cascades = 0;
+}
@@ -0,0 +1,105 @@
+/*****************************************************************************/
+/**
+ * @file shadow_map.h
+ * @brief Cascaded shadow map of a directional light, drawn with the impostors.
+ * @sa Engel: Cascaded Shadow Maps, ShaderX5, 2006.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef SHADOW_MAP_H_
+#define SHADOW_MAP_H_
+
+#include "gl_globals.h"
+#include "camera.h"
+#include "shader.h"
+
+#include <glm/glm.hpp>
+
+/// name of the uniform block in the shaders
+#define SHADOW_UNIFORM_BLOCK "ShadowData"
+/// uniform buffer binding point of the ShadowData block
+#define SHADOW_UNIFORM_BINDING 3
+/// texture unit of the shadow map (sampler2DArrayShadow)
+#define SHADOW_TEXTURE_UNIT 7
+/// array size of the ShadowData block and the largest SHADOW_PASS define
+#define SHADOW_CASCADES_MAX 4
+#define SHADOW_CASCADES 3
+/// resolution of each cascade
+#define SHADOW_MAP_SIZE 2048
+/// blend of logarithmic (1) and uniform (0) cascade splits
+#define SHADOW_SPLIT_LAMBDA 0.75f
+/// bounding sphere of the casters, the generated spheres fill [-1,1]^3
+#define SHADOW_SCENE_RADIUS 2.5f
+
+/// memory layout of the ShadowData uniform block (std140) in shader/common.glsl
+struct ShadowData
+{
+  glm::mat4 MVMatrix;
+  glm::mat4 PMatrix[SHADOW_CASCADES_MAX];
+  glm::mat4 matrix[SHADOW_CASCADES_MAX];
+  glm::vec4 splits;
+};
+
+/**
+ * Cascaded shadow map of a directional light. The view frustum is split in
+ * depth into n cascades, each covered by an orthographic light projection
+ * fitted to the bounding sphere of its slice and snapped to shadow map
+ * texels, so the shadows do not swim while the camera moves.
+ *
+ * The casters are drawn with the renderer's own buffers and a second program
+ * of its shaders (Spheres::bindShadowPass()). With the define SHADOW_PASS=n,
+ * sphere_geom.geom fetches a sphere once, culls it against each cascade and
+ * emits a billboard into layer i of the depth array for each cascade i it
+ * touches. sphere.frag writes the analytic sphere depth
+ * of the light projection, as it does for the camera, and returns.
+ *
+ * With SHADOWS=1, sphere.frag selects the cascade from the view distance of
+ * the surface point and attenuates the directional light by a hardware PCF
+ * lookup. Ambient and point lights are not shadowed.
+ */
+class ShadowMap
+{
+  public:
+    ShadowMap();
+    /**
+     * @param cascades in [1, SHADOW_CASCADES_MAX]
+     * @retval 0 on success, 1 on error
+     */
+    int create(unsigned cascades, int size = SHADOW_MAP_SIZE);
+    /// 0 if not created
+    unsigned cascades() const { return _cascades; }
+    /// sets the uniform block and the texture unit of an impostor shader
+    static void setBindings(ShaderManager& shader);
+    /// bounding sphere of the casters in world space
+    void setScene(const glm::vec3& center, float radius);
+    /**
+     * Computes the cascades and uploads the ShadowData block.
+     * @param direction world space direction towards the light
+     */
+    void update(const Camera& camera, const glm::vec3& direction);
+    /// binds and clears the layered depth target
+    void bind();
+    /// restores the default framebuffer and the viewport of the camera
+    void unbind(int width, int height);
+    /// binds the shadow map to SHADOW_TEXTURE_UNIT for the main pass
+    void bindTexture();
+    void unbindTexture();
+    /// adds the GPU time of a frame with or without shadows
+    void record(bool shadowed, double frame_ms);
+    /// prints and resets the statistics
+    void report();
+    void cleanup();
+
+  private:
+    unsigned _cascades;
+    int _size;
+    GLuint _buffer, _fbo, _depth;
+    ShadowData _data;
+    glm::vec3 _sceneCenter;
+    float _sceneRadius;
+    // statistics since the last report(), [0] unshadowed, [1] shadowed
+    unsigned _frames[2];
+    double _sum[2];
+};
+
+#endif /* SHADOW_MAP_H_ */
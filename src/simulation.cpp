@@ -0,0 +1,252 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Integration runs on the shared thread pool.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "simulation.h"
+#include "thread_pool.h"
+#include "tools.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+
+//-----------------------------------------------------------------------------
+// PCG hash, identical to sphere_simulate.comp
+//-----------------------------------------------------------------------------
+static inline unsigned pcgHash(unsigned v)
+{
+  unsigned state = v * 747796405u + 2891336453u;
+  unsigned word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+  return (word >> 22u) ^ word;
+}
+//-----------------------------------------------------------------------------
+// uniform random number in [-1,1] per sphere component and frame
+//-----------------------------------------------------------------------------
+static inline float noise(unsigned component, unsigned frame_seed)
+{
+  return (pcgHash(component + frame_seed) >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+//-----------------------------------------------------------------------------
+// Langevin step of components [first,last)
+//-----------------------------------------------------------------------------
+static void integrate(float* positions, float* velocities, unsigned first,
+                      unsigned last, float dt, unsigned frame_seed)
+{
+  const float damping = 1.0f - SIMULATION_DAMPING * dt;
+  // uniform noise has variance 1/3
+  const float kick = SIMULATION_NOISE * sqrtf(3.0f * dt);
+  for (unsigned i = first; i < last; ++i)
+  {
+    float v = velocities[i] * damping + kick * noise(i, frame_seed);
+    float x = positions[i] + v * dt;
+    if (x > SIMULATION_BOX)
+    {
+      x = 2.0f * SIMULATION_BOX - x;
+      v = -v;
+    }
+    else if (x < -SIMULATION_BOX)
+    {
+      x = -2.0f * SIMULATION_BOX - x;
+      v = -v;
+    }
+    positions[i] = x;
+    velocities[i] = v;
+  }
+}
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+Simulation::Simulation()
+  : _mode(SIMULATION_OFF), _count(0), _frame(0), _offset(0),
+    _simTime(0.0), _uploadTime(0.0), _simFrames(0), _uploadFrames(0)
+{
+  _ssbo[0] = _ssbo[1] = 0;
+  _query[0] = _query[1] = 0;
+  _queryFrame[0] = _queryFrame[1] = 0;
+}
+Simulation::~Simulation()
+{
+  // GL objects are released by cleanup() while the context exists
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int Simulation::create(SimulationMode mode, unsigned count)
+{
+  cleanup();
+  _count = count;
+  _frame = 0;
+  _offset = 0;
+
+  // same sequence as the interleaved renderers, so the simulation starts
+  // from the static scene
+  srand(2013);
+  _positions.resize(3 * count);
+  _velocities.assign(3 * count, 0.0f);
+  for (unsigned i = 0; i < count; ++i)
+  {
+    _positions[3 * i] = mrand(-1.f, 1.f);
+    _positions[3 * i + 1] = mrand(-1.f, 1.f);
+    _positions[3 * i + 2] = mrand(-1.f, 1.f);
+    mrand(0.f, 1.f); mrand(0.f, 1.f); mrand(0.f, 1.f); // color
+    rand(); // radius
+  }
+
+  if (mode == SIMULATION_GPU)
+  {
+    if (!GLEW_ARB_compute_shader || !GLEW_ARB_shader_storage_buffer_object)
+    {
+      printf("Compute shader simulation needs ARB_compute_shader and SSBOs.\n");
+      return 1;
+    }
+    glGenBuffers(2, _ssbo);
+    upload_buffer(_ssbo[0], &_positions[0], 3 * count, GL_SHADER_STORAGE_BUFFER, GL_DYNAMIC_COPY);
+    upload_buffer(_ssbo[1], &_velocities[0], 3 * count, GL_SHADER_STORAGE_BUFFER, GL_DYNAMIC_COPY);
+    glGenQueries(2, _query);
+    if (_shader.loadCompute("sphere_simulate.comp") || _shader.link())
+    {
+      printf("Error occurred.\n");
+      return 1;
+    }
+    // host copies are not needed anymore
+    std::vector<float>().swap(_positions);
+    std::vector<float>().swap(_velocities);
+  }
+  else if (mode == SIMULATION_CPU)
+  {
+    if (_stream.create(3 * sizeof(float) * count))
+      return 1;
+    _offset = _stream.upload(&_positions[0], 3 * sizeof(float) * count);
+  }
+  _mode = mode;
+  printf("Simulation: %u spheres on the %s.\n", count,
+         mode == SIMULATION_GPU ? "GPU (compute shader)" : "CPU");
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Simulation::step(float dt)
+{
+  if (_mode == SIMULATION_CPU)
+    stepCPU(dt);
+  else if (_mode == SIMULATION_GPU)
+    stepGPU(dt);
+  ++_frame;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Simulation::stepCPU(float dt)
+{
+  typedef std::chrono::steady_clock clock;
+  clock::time_point t0 = clock::now();
+
+  const unsigned n = 3 * _count;
+  const unsigned seed = pcgHash(_frame);
+  float* positions = &_positions[0];
+  float* velocities = &_velocities[0];
+  ThreadPool::global().parallelFor(0, n, 0, [=](unsigned first, unsigned last) {
+    integrate(positions, velocities, first, last, dt, seed);
+  });
+
+  clock::time_point t1 = clock::now();
+  _offset = _stream.upload(&_positions[0], 3 * sizeof(float) * _count);
+  clock::time_point t2 = clock::now();
+
+  _simTime += std::chrono::duration<double, std::milli>(t1 - t0).count();
+  _uploadTime += std::chrono::duration<double, std::milli>(t2 - t1).count();
+  ++_simFrames;
+  ++_uploadFrames;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Simulation::stepGPU(float dt)
+{
+  // the query of this slot was issued two frames ago
+  readGPUTimer();
+  unsigned slot = _frame & 1;
+
+  glBeginQuery(GL_TIME_ELAPSED, _query[slot]);
+  _shader.bind();
+  _shader.setUniformVar("Count", (int) (3 * _count));
+  _shader.setUniformVar("TimeStep", dt);
+  _shader.setUniformVar("FrameSeed", (int) pcgHash(_frame));
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, _ssbo[0]);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, _ssbo[1]);
+  glDispatchCompute((3 * _count + SIMULATION_GROUP_SIZE - 1) / SIMULATION_GROUP_SIZE, 1, 1);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+  _shader.unbind();
+  glEndQuery(GL_TIME_ELAPSED);
+  _queryFrame[slot] = _frame + 1; // 0 means unused
+
+  // positions are read as vertex attributes or texture buffers
+  glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Simulation::readGPUTimer()
+{
+  unsigned slot = _frame & 1;
+  if (_queryFrame[slot] == 0)
+    return;
+  GLuint64 ns = 0;
+  glGetQueryObjectui64v(_query[slot], GL_QUERY_RESULT, &ns);
+  _simTime += ns * 1e-6;
+  ++_simFrames;
+  _queryFrame[slot] = 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Simulation::fence()
+{
+  if (_mode == SIMULATION_CPU)
+    _stream.fence();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+GLuint Simulation::positionBuffer() const
+{
+  return _mode == SIMULATION_GPU ? _ssbo[0] : _stream.id();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Simulation::report()
+{
+  if (_mode == SIMULATION_OFF)
+    return;
+  printf("Simulation %s: %.3lf ms, upload: ", _mode == SIMULATION_GPU ? "GPU" : "CPU",
+         _simFrames ? _simTime / _simFrames : 0.0);
+  if (_mode == SIMULATION_GPU)
+    printf("none (in place)\n");
+  else
+    printf("%.3lf ms\n", _uploadFrames ? _uploadTime / _uploadFrames : 0.0);
+  _simTime = _uploadTime = 0.0;
+  _simFrames = _uploadFrames = 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void Simulation::cleanup()
+{
+  _stream.cleanup();
+  if (_ssbo[0])
+    glDeleteBuffers(2, _ssbo);
+  _ssbo[0] = _ssbo[1] = 0;
+  if (_query[0])
+    glDeleteQueries(2, _query);
+  _query[0] = _query[1] = 0;
+  _queryFrame[0] = _queryFrame[1] = 0;
+  _mode = SIMULATION_OFF;
+}
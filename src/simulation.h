@@ -0,0 +1,88 @@
+/*****************************************************************************/
+/**
+ * @file simulation.h
+ * @brief Dynamic workload: Brownian motion of the spheres on CPU or GPU.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef SIMULATION_H_
+#define SIMULATION_H_
+
+#include "gl_globals.h"
+#include "shader.h"
+#include "streaming_buffer.h"
+
+#include <vector>
+
+/// velocity damping of the Langevin integrator (1/s)
+#define SIMULATION_DAMPING 2.0f
+/// strength of the random force
+#define SIMULATION_NOISE 0.2f
+/// spheres are confined to [-SIMULATION_BOX, SIMULATION_BOX]^3
+#define SIMULATION_BOX 1.0f
+/// work group size of sphere_simulate.comp
+#define SIMULATION_GROUP_SIZE 256
+
+enum SimulationMode
+{
+  SIMULATION_OFF = 0,
+  SIMULATION_CPU, ///< multithreaded, uploaded through a streaming buffer
+  SIMULATION_GPU  ///< compute shader, updates the SSBO in place
+};
+
+/**
+ * Advances the sphere centers every frame by a Langevin integrator
+ * (damped Brownian motion) with reflecting walls, either on all CPU cores
+ * or in a compute shader. The centers (x,y,z floats) are fed to the
+ * renderer by setPositionSource(positionBuffer(), positionOffset()).
+ * The random force is a hash of sphere, axis and frame, so both paths
+ * compute the same motion.
+ * Simulation and upload times are averaged until report().
+ */
+class Simulation
+{
+  public:
+    Simulation();
+    ~Simulation();
+    /**
+     * @param mode CPU or GPU path
+     * @param count number of spheres
+     * @retval 0 on success, 1 if the mode is not supported
+     */
+    int create(SimulationMode mode, unsigned count);
+    /// advances by dt seconds and uploads the result (CPU path)
+    void step(float dt);
+    /// to be called after the draws which read the positions
+    void fence();
+    GLuint positionBuffer() const;
+    GLintptr positionOffset() const { return _offset; }
+    SimulationMode mode() const { return _mode; }
+    /// prints and resets average simulation and upload times
+    void report();
+    void cleanup();
+
+  private:
+    void stepCPU(float dt);
+    void stepGPU(float dt);
+    void readGPUTimer();
+
+  private:
+    SimulationMode _mode;
+    unsigned _count;
+    unsigned _frame;
+    // CPU path
+    std::vector<float> _positions;
+    std::vector<float> _velocities;
+    StreamingBuffer _stream;
+    GLintptr _offset;
+    // GPU path
+    ShaderManager _shader;
+    GLuint _ssbo[2]; ///< positions, velocities
+    GLuint _query[2];
+    unsigned _queryFrame[2];
+    // timings in ms, summed until report()
+    double _simTime, _uploadTime;
+    unsigned _simFrames, _uploadFrames;
+};
+
+#endif /* SIMULATION_H_ */
@@ -0,0 +1,424 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "sphere_bvh.h"
+#include "thread_pool.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+/// bits sorted per radix sort pass
+#define BVH_RADIX_BITS 10
+#define BVH_RADIX (1u << BVH_RADIX_BITS)
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+static inline int clz32(unsigned v)
+{
+#if defined(__GNUC__)
+  return __builtin_clz(v);
+#else
+  int n = 0;
+  while (!(v & 0x80000000u))
+  {
+    v <<= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+//-----------------------------------------------------------------------------
+// inserts two zero bits after each of the lower 10 bits
+//-----------------------------------------------------------------------------
+static inline unsigned expandBits(unsigned v)
+{
+  v = (v * 0x00010001u) & 0xFF0000FFu;
+  v = (v * 0x00000101u) & 0x0F00F00Fu;
+  v = (v * 0x00000011u) & 0xC30C30C3u;
+  v = (v * 0x00000005u) & 0x49249249u;
+  return v;
+}
+//-----------------------------------------------------------------------------
+// 30 bit Morton code of a point in [0,1]^3
+//-----------------------------------------------------------------------------
+static inline unsigned morton(const glm::vec3& p)
+{
+  unsigned x = (unsigned) std::min(std::max(p.x * 1024.0f, 0.0f), 1023.0f);
+  unsigned y = (unsigned) std::min(std::max(p.y * 1024.0f, 0.0f), 1023.0f);
+  unsigned z = (unsigned) std::min(std::max(p.z * 1024.0f, 0.0f), 1023.0f);
+  return (expandBits(x) << 2) | (expandBits(y) << 1) | expandBits(z);
+}
+//-----------------------------------------------------------------------------
+// length of the common prefix of the keys i and j, equal codes are
+// distinguished by index, -1 outside of [0,n)
+//-----------------------------------------------------------------------------
+static inline int commonPrefix(const unsigned* codes, int n, int i, int j)
+{
+  if (j < 0 || j >= n)
+    return -1;
+  if (codes[i] == codes[j])
+    return 32 + clz32((unsigned) (i ^ j));
+  return clz32(codes[i] ^ codes[j]);
+}
+//-----------------------------------------------------------------------------
+// stable LSD radix sort of keys (lower bits only) with values, every chunk
+// counts and scatters its own range
+//-----------------------------------------------------------------------------
+static void radixSort(std::vector<unsigned>& keys, std::vector<unsigned>& values,
+                      unsigned bits, ThreadPool& pool)
+{
+  const unsigned n = (unsigned) keys.size();
+  const unsigned chunks = std::max(1u, std::min(n / 4096, 4 * pool.size()));
+  const unsigned chunk = (n + chunks - 1) / chunks;
+  std::vector<unsigned> keys2(n), values2(n);
+  std::vector<unsigned> offsets(chunks * BVH_RADIX);
+
+  for (unsigned shift = 0; shift < bits; shift += BVH_RADIX_BITS)
+  {
+    pool.parallelFor(0, chunks, 1, [&](unsigned first, unsigned last) {
+      for (unsigned c = first; c < last; ++c)
+      {
+        unsigned* count = &offsets[c * BVH_RADIX];
+        std::fill(count, count + BVH_RADIX, 0u);
+        for (unsigned i = c * chunk; i < std::min(n, (c + 1) * chunk); ++i)
+          ++count[(keys[i] >> shift) & (BVH_RADIX - 1)];
+      }
+    });
+    // digit major, chunk minor keeps the sort stable
+    unsigned sum = 0;
+    for (unsigned d = 0; d < BVH_RADIX; ++d)
+      for (unsigned c = 0; c < chunks; ++c)
+      {
+        unsigned count = offsets[c * BVH_RADIX + d];
+        offsets[c * BVH_RADIX + d] = sum;
+        sum += count;
+      }
+    pool.parallelFor(0, chunks, 1, [&](unsigned first, unsigned last) {
+      for (unsigned c = first; c < last; ++c)
+      {
+        unsigned* offset = &offsets[c * BVH_RADIX];
+        for (unsigned i = c * chunk; i < std::min(n, (c + 1) * chunk); ++i)
+        {
+          unsigned pos = offset[(keys[i] >> shift) & (BVH_RADIX - 1)]++;
+          keys2[pos] = keys[i];
+          values2[pos] = values[i];
+        }
+      }
+    });
+    keys.swap(keys2);
+    values.swap(values2);
+  }
+}
+//-----------------------------------------------------------------------------
+// slab test, true if the ray enters the box before max_t
+//-----------------------------------------------------------------------------
+static inline bool rayBox(const glm::vec3& origin, const glm::vec3& inv_dir,
+                          const glm::vec3& lower, const glm::vec3& upper, float max_t)
+{
+  glm::vec3 t1 = (lower - origin) * inv_dir;
+  glm::vec3 t2 = (upper - origin) * inv_dir;
+  glm::vec3 tmin = glm::min(t1, t2);
+  glm::vec3 tmax = glm::max(t1, t2);
+  float enter = std::max(std::max(tmin.x, tmin.y), std::max(tmin.z, 0.0f));
+  float leave = std::min(std::min(tmax.x, tmax.y), tmax.z);
+  return enter <= leave && enter < max_t;
+}
+//-----------------------------------------------------------------------------
+// squared distance of a point to a box
+//-----------------------------------------------------------------------------
+static inline float boxDistance2(const glm::vec3& p, const glm::vec3& lower,
+                                 const glm::vec3& upper)
+{
+  glm::vec3 d = p - glm::clamp(p, lower, upper);
+  return glm::dot(d, d);
+}
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+SphereBVH::SphereBVH()
+  : _root(0)
+{
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void SphereBVH::build(const float* positions, unsigned pos_stride,
+                      const float* radii, unsigned radius_stride, unsigned count)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  ThreadPool& pool = ThreadPool::global();
+  _nodes.clear();
+  _spheres.resize(count);
+  _indices.resize(count);
+  _root = ~0;
+  if (count == 0)
+    return;
+
+  // bounding box of the centers, one partial box per chunk
+  const unsigned chunks = std::max(1u, std::min(count / 4096, 4 * pool.size()));
+  const unsigned chunk = (count + chunks - 1) / chunks;
+  std::vector<glm::vec3> lower(chunks, glm::vec3(FLT_MAX)), upper(chunks, glm::vec3(-FLT_MAX));
+  pool.parallelFor(0, chunks, 1, [&](unsigned first, unsigned last) {
+    for (unsigned c = first; c < last; ++c)
+      for (unsigned i = c * chunk; i < std::min(count, (c + 1) * chunk); ++i)
+      {
+        const float* p = positions + i * pos_stride;
+        lower[c] = glm::min(lower[c], glm::vec3(p[0], p[1], p[2]));
+        upper[c] = glm::max(upper[c], glm::vec3(p[0], p[1], p[2]));
+      }
+  });
+  glm::vec3 scene_lower = lower[0], scene_upper = upper[0];
+  for (unsigned c = 1; c < chunks; ++c)
+  {
+    scene_lower = glm::min(scene_lower, lower[c]);
+    scene_upper = glm::max(scene_upper, upper[c]);
+  }
+  const glm::vec3 scale = 1.0f / glm::max(scene_upper - scene_lower, glm::vec3(1e-20f));
+
+  std::vector<unsigned> codes(count), order(count);
+  pool.parallelFor(0, count, 0, [&](unsigned first, unsigned last) {
+    for (unsigned i = first; i < last; ++i)
+    {
+      const float* p = positions + i * pos_stride;
+      codes[i] = morton((glm::vec3(p[0], p[1], p[2]) - scene_lower) * scale);
+      order[i] = i;
+    }
+  });
+  radixSort(codes, order, 30, pool);
+
+  pool.parallelFor(0, count, 0, [&](unsigned first, unsigned last) {
+    for (unsigned i = first; i < last; ++i)
+    {
+      const float* p = positions + order[i] * pos_stride;
+      _spheres[i] = glm::vec4(p[0], p[1], p[2], radii[order[i] * radius_stride]);
+    }
+  });
+  _indices.swap(order);
+
+  if (count > 1)
+  {
+    // inner node i covers the range of keys starting or ending at i
+    const int n = (int) count;
+    const unsigned* key = &codes[0];
+    _nodes.resize(count - 1);
+    std::vector<int> parents(count - 1), leaf_parents(count);
+    parents[0] = -1;
+    pool.parallelFor(0, count - 1, 0, [&](unsigned first_node, unsigned last_node) {
+      for (int i = (int) first_node; i < (int) last_node; ++i)
+      {
+        int d = commonPrefix(key, n, i, i + 1) > commonPrefix(key, n, i, i - 1) ? 1 : -1;
+        int min_prefix = commonPrefix(key, n, i, i - d);
+        int max_length = 2;
+        while (commonPrefix(key, n, i, i + max_length * d) > min_prefix)
+          max_length *= 2;
+        int length = 0;
+        for (int t = max_length / 2; t >= 1; t /= 2)
+          if (commonPrefix(key, n, i, i + (length + t) * d) > min_prefix)
+            length += t;
+        int j = i + length * d;
+        int node_prefix = commonPrefix(key, n, i, j);
+        int first = std::min(i, j), last = std::max(i, j);
+
+        // highest position where the prefix grows
+        int split = first, step = last - first;
+        do
+        {
+          step = (step + 1) >> 1;
+          int s = split + step;
+          if (s < last && commonPrefix(key, n, first, s) > node_prefix)
+            split = s;
+        } while (step > 1);
+
+        Node& node = _nodes[i];
+        if (split == first)
+        {
+          node.left = ~split;
+          leaf_parents[split] = i;
+        }
+        else
+        {
+          node.left = split;
+          parents[split] = i;
+        }
+        if (split + 1 == last)
+        {
+          node.right = ~(split + 1);
+          leaf_parents[split + 1] = i;
+        }
+        else
+        {
+          node.right = split + 1;
+          parents[split + 1] = i;
+        }
+      }
+    });
+    computeBounds(parents, leaf_parents);
+    _root = 0;
+  }
+
+  std::chrono::duration<double, std::milli> t = std::chrono::steady_clock::now() - start;
+  printf("Sphere BVH: %u spheres, %u threads, %.1lf ms.\n", count, pool.size(), t.count());
+}
+//-----------------------------------------------------------------------------
+// each leaf walks up, the first child to arrive at a node stops there
+//-----------------------------------------------------------------------------
+void SphereBVH::computeBounds(const std::vector<int>& parents,
+                              const std::vector<int>& leaf_parents)
+{
+  ThreadPool& pool = ThreadPool::global();
+  const unsigned n = (unsigned) _nodes.size();
+  std::vector< std::atomic<int> > visits(n);
+  pool.parallelFor(0, n, 0, [&](unsigned first, unsigned last) {
+    for (unsigned i = first; i < last; ++i)
+      visits[i].store(0, std::memory_order_relaxed);
+  });
+  pool.parallelFor(0, n + 1, 0, [&](unsigned first, unsigned last) {
+    for (unsigned leaf = first; leaf < last; ++leaf)
+    {
+      int p = leaf_parents[leaf];
+      // acquire the bounds written by the sibling, release ours
+      while (p >= 0 && visits[p].fetch_add(1, std::memory_order_acq_rel) == 1)
+      {
+        Node& node = _nodes[p];
+        glm::vec3 lower, upper;
+        childBounds(node.left, &node.lower, &node.upper);
+        childBounds(node.right, &lower, &upper);
+        node.lower = glm::min(node.lower, lower);
+        node.upper = glm::max(node.upper, upper);
+        p = parents[p];
+      }
+    }
+  });
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void SphereBVH::childBounds(int child, glm::vec3* lower, glm::vec3* upper) const
+{
+  if (child < 0)
+  {
+    const glm::vec4& s = _spheres[~child];
+    *lower = glm::vec3(s) - s.w;
+    *upper = glm::vec3(s) + s.w;
+  }
+  else
+  {
+    *lower = _nodes[child].lower;
+    *upper = _nodes[child].upper;
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int SphereBVH::pick(const glm::vec3& origin, const glm::vec3& direction,
+                    float* distance) const
+{
+  if (_spheres.empty())
+    return -1;
+  const glm::vec3 inv_dir = 1.0f / direction;
+  float best = FLT_MAX;
+  int hit = -1;
+  int stack[BVH_STACK_SIZE];
+  int top = 0;
+  stack[top++] = _root;
+  while (top > 0)
+  {
+    int child = stack[--top];
+    if (child < 0)
+    {
+      const glm::vec4& s = _spheres[~child];
+      glm::vec3 oc = origin - glm::vec3(s);
+      float b = glm::dot(oc, direction);
+      float disc = b * b - glm::dot(oc, oc) + s.w * s.w;
+      if (disc < 0.0f)
+        continue;
+      float root = sqrtf(disc);
+      // far intersection if the origin is inside
+      float t = -b - root >= 0.0f ? -b - root : -b + root;
+      if (t >= 0.0f && t < best)
+      {
+        best = t;
+        hit = (int) _indices[~child];
+      }
+      continue;
+    }
+    const Node& node = _nodes[child];
+    if (rayBox(origin, inv_dir, node.lower, node.upper, best))
+    {
+      stack[top++] = node.left;
+      stack[top++] = node.right;
+    }
+  }
+  if (distance && hit >= 0)
+    *distance = best;
+  return hit;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void SphereBVH::queryBox(const glm::vec3& lower, const glm::vec3& upper,
+                         std::vector<unsigned>* result) const
+{
+  result->clear();
+  if (_spheres.empty())
+    return;
+  int stack[BVH_STACK_SIZE];
+  int top = 0;
+  stack[top++] = _root;
+  while (top > 0)
+  {
+    int child = stack[--top];
+    if (child < 0)
+    {
+      const glm::vec4& s = _spheres[~child];
+      if (boxDistance2(glm::vec3(s), lower, upper) <= s.w * s.w)
+        result->push_back(_indices[~child]);
+      continue;
+    }
+    const Node& node = _nodes[child];
+    if (glm::all(glm::lessThanEqual(node.lower, upper))
+        && glm::all(glm::lessThanEqual(lower, node.upper)))
+    {
+      stack[top++] = node.left;
+      stack[top++] = node.right;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void SphereBVH::querySphere(const glm::vec3& center, float radius,
+                            std::vector<unsigned>* result) const
+{
+  result->clear();
+  if (_spheres.empty())
+    return;
+  int stack[BVH_STACK_SIZE];
+  int top = 0;
+  stack[top++] = _root;
+  while (top > 0)
+  {
+    int child = stack[--top];
+    if (child < 0)
+    {
+      const glm::vec4& s = _spheres[~child];
+      glm::vec3 d = glm::vec3(s) - center;
+      if (glm::dot(d, d) <= (s.w + radius) * (s.w + radius))
+        result->push_back(_indices[~child]);
+      continue;
+    }
+    const Node& node = _nodes[child];
+    if (boxDistance2(center, node.lower, node.upper) <= radius * radius)
+    {
+      stack[top++] = node.left;
+      stack[top++] = node.right;
+    }
+  }
+}
@@ -0,0 +1,81 @@
+/*****************************************************************************/
+/**
+ * @file sphere_bvh.h
+ * @brief Bounding volume hierarchy over spheres for picking and range queries.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef SPHERE_BVH_H_
+#define SPHERE_BVH_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+
+/// maximum depth of the hierarchy (30 bit Morton codes plus 32 bit index)
+#define BVH_STACK_SIZE 128
+
+/**
+ * Linear BVH (Karras 2012) over spheres, built in parallel on the shared
+ * ThreadPool:
+ * - 30 bit Morton codes of the centers within their bounding box
+ * - parallel radix sort of the codes
+ * - every inner node is built independently from the sorted codes
+ *   (equal codes are split by sphere index)
+ * - node bounds are merged bottom-up, the second child to finish
+ *   continues with the parent
+ *
+ * Leaves hold one sphere each. Queries return the indices of the input
+ * order. Arrays are read with a stride given in floats as in
+ * computeAmbientOcclusion(), so interleaved buffers can be used directly.
+ */
+class SphereBVH
+{
+  public:
+    SphereBVH();
+    /**
+     * @param[in] positions sphere centers (x,y,z), pos_stride floats apart
+     * @param[in] radii sphere radii, radius_stride floats apart
+     * @param[in] count number of spheres
+     */
+    void build(const float* positions, unsigned pos_stride,
+               const float* radii, unsigned radius_stride, unsigned count);
+    unsigned size() const { return (unsigned) _indices.size(); }
+
+    /**
+     * Nearest sphere hit by a ray.
+     * @param direction normalized ray direction
+     * @param[out] distance ray parameter of the hit (may be NULL)
+     * @return index of the sphere or -1
+     */
+    int pick(const glm::vec3& origin, const glm::vec3& direction,
+             float* distance = NULL) const;
+    /// spheres intersecting the axis-aligned box [lower,upper]
+    void queryBox(const glm::vec3& lower, const glm::vec3& upper,
+                  std::vector<unsigned>* result) const;
+    /// spheres intersecting the sphere around center
+    void querySphere(const glm::vec3& center, float radius,
+                     std::vector<unsigned>* result) const;
+
+  private:
+    /// children >= 0 are nodes, leaves are stored as ~slot
+    struct Node
+    {
+      glm::vec3 lower;
+      int left;
+      glm::vec3 upper;
+      int right;
+    };
+    void computeBounds(const std::vector<int>& parents,
+                       const std::vector<int>& leaf_parents);
+    void childBounds(int child, glm::vec3* lower, glm::vec3* upper) const;
+
+  private:
+    std::vector<Node> _nodes;
+    /// center and radius in Morton order
+    std::vector<glm::vec4> _spheres;
+    /// input index of each slot
+    std::vector<unsigned> _indices;
+    int _root;
+};
+
+#endif /* SPHERE_BVH_H_ */
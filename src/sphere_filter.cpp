@@ -0,0 +1,156 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "sphere_filter.h"
+#include "tools.h"
+
+#include <float.h>
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+SphereFilter::SphereFilter()
+  : _count(0), _query(0), _typeMask(FILTER_ALL_TYPES), _dirty(true), _pending(false), _ms(0.0)
+{
+  _buffers[0] = _buffers[1] = _buffers[2] = 0;
+  _radius[0] = _scalar[0] = -FLT_MAX;
+  _radius[1] = _scalar[1] = FLT_MAX;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int SphereFilter::create(const std::vector<SphereAttributes>& attributes)
+{
+  cleanup();
+  if (!GLEW_ARB_compute_shader || !GLEW_ARB_shader_storage_buffer_object || !GLEW_ARB_draw_indirect)
+  {
+    printf("Sphere filter needs ARB_compute_shader, SSBOs and ARB_draw_indirect.\n");
+    return 1;
+  }
+  if (attributes.empty())
+    return 1;
+  glGenBuffers(3, _buffers);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, _buffers[0]);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, attributes.size() * sizeof(SphereAttributes),
+               &attributes[0], GL_STATIC_DRAW);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, _buffers[1]);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, attributes.size() * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, _buffers[2]);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, 5 * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  glGenQueries(1, &_query);
+  if (_shader.loadCompute("sphere_filter.comp") || _shader.link())
+  {
+    printf("Error occurred.\n");
+    return 1;
+  }
+  _count = (unsigned) attributes.size();
+  _dirty = true;
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void SphereFilter::setRadiusRange(float min, float max)
+{
+  _radius[0] = min;
+  _radius[1] = max;
+  _dirty = true;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void SphereFilter::setScalarRange(float min, float max)
+{
+  _scalar[0] = min;
+  _scalar[1] = max;
+  _dirty = true;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void SphereFilter::setTypeMask(GLuint mask)
+{
+  _typeMask = mask;
+  _dirty = true;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+bool SphereFilter::isActive() const
+{
+  return _typeMask != FILTER_ALL_TYPES || _radius[0] > -FLT_MAX || _radius[1] < FLT_MAX
+      || _scalar[0] > -FLT_MAX || _scalar[1] < FLT_MAX;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void SphereFilter::update()
+{
+  if (!_dirty || _count == 0)
+    return;
+  // count, instanceCount, firstIndex, baseVertex, baseInstance
+  const GLuint command[5] = { 0, 1, 0, 0, 0 };
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, _buffers[2]);
+  glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(command), command);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+  // the time of the previous run is dropped if it is still pending
+  glBeginQuery(GL_TIME_ELAPSED, _query);
+  _shader.bind();
+  _shader.setUniformVar("Count", (int) _count);
+  float ranges[4] = { _radius[0], _radius[1], _scalar[0], _scalar[1] };
+  _shader.setUniformVar("Ranges", ranges);
+  _shader.setUniformVar("TypeMask", (int) _typeMask);
+  for (GLuint b = 0; b < 3; ++b)
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, b, _buffers[b]);
+  glDispatchCompute((_count + FILTER_GROUP_SIZE - 1) / FILTER_GROUP_SIZE, 1, 1);
+  for (GLuint b = 0; b < 3; ++b)
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, b, 0);
+  _shader.unbind();
+  glEndQuery(GL_TIME_ELAPSED);
+  _pending = true;
+  _dirty = false;
+
+  // indices are read as element array, the count as indirect command
+  glMemoryBarrier(GL_ELEMENT_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void SphereFilter::report()
+{
+  if (_count == 0 || !isActive())
+    return;
+  if (_pending)
+  {
+    GLint available = 0;
+    glGetQueryObjectiv(_query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available)
+    {
+      GLuint64 ns = 0;
+      glGetQueryObjectui64v(_query, GL_QUERY_RESULT, &ns);
+      _ms = ns * 1e-6;
+      _pending = false;
+    }
+  }
+  printf("Filter: radius [%g, %g], scalar [%g, %g], types 0x%x, %u spheres in %.3f ms\n",
+         _radius[0], _radius[1], _scalar[0], _scalar[1], _typeMask, _count, _ms);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void SphereFilter::cleanup()
+{
+  if (_buffers[0])
+    glDeleteBuffers(3, _buffers);
+  _buffers[0] = _buffers[1] = _buffers[2] = 0;
+  if (_query)
+    glDeleteQueries(1, &_query);
+  _query = 0;
+  _count = 0;
+  _pending = false;
+}
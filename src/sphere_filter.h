@@ -0,0 +1,80 @@
+/*****************************************************************************/
+/**
+ * @file sphere_filter.h
+ * @brief GPU filtering of the spheres by attribute ranges and type masks.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef SPHERE_FILTER_H_
+#define SPHERE_FILTER_H_
+
+#include "gl_globals.h"
+#include "shader.h"
+
+#include <vector>
+
+/// work group size of sphere_filter.comp
+#define FILTER_GROUP_SIZE 256
+/// all types pass
+#define FILTER_ALL_TYPES 0xffffffffu
+
+/**
+ * Attributes of a sphere the filter tests, one std430 array element (12 bytes).
+ */
+struct SphereAttributes
+{
+  float radius;
+  float scalar;
+  GLuint type; ///< in [0, 32)
+};
+
+/**
+ * Filters the spheres on the GPU. The attributes of all spheres are resident
+ * in a shader storage buffer. When the filter changes, sphere_filter.comp
+ * tests every sphere against the radius and scalar ranges and the type mask,
+ * and compacts the indices of the passing spheres (one global atomic per work
+ * group). The number of indices is written to a DrawElementsIndirectCommand,
+ * so the renderer draws them with glDrawElementsIndirect() and no count is
+ * read back. Unchanged filters cost nothing per frame.
+ *
+ * Needs GL 4.3 compute shaders and shader storage buffers.
+ */
+class SphereFilter
+{
+  public:
+    SphereFilter();
+    /**
+     * Uploads the attributes, sphere i of the renderer is attributes[i].
+     * @retval 0 on success, 1 if not supported
+     */
+    int create(const std::vector<SphereAttributes>& attributes);
+    bool isCreated() const { return _count > 0; }
+    /// spheres with min <= radius <= max pass
+    void setRadiusRange(float min, float max);
+    /// spheres with min <= scalar <= max pass
+    void setScalarRange(float min, float max);
+    /// spheres of type t pass if bit t is set
+    void setTypeMask(GLuint mask);
+    /// false if every sphere passes
+    bool isActive() const;
+    /// runs the filter if it has changed since the last update()
+    void update();
+    /// sphere indices and the indirect command for the renderer
+    GLuint indexBuffer() const { return _buffers[1]; }
+    GLuint commandBuffer() const { return _buffers[2]; }
+    /// prints the filter and the GPU time of its last run
+    void report();
+    void cleanup();
+
+  private:
+    ShaderManager _shader;
+    unsigned _count;
+    GLuint _buffers[3]; ///< attributes, indices, indirect command
+    GLuint _query;
+    float _radius[2], _scalar[2];
+    GLuint _typeMask;
+    bool _dirty, _pending;
+    double _ms;
+};
+
+#endif /* SPHERE_FILTER_H_ */
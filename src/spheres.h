@@ -4,6 +4,15 @@
  * @brief Spheres rendering interface used for compile-time polymorphism.
  * @author Matthias Werner
  * @sa http://11235813tdd.blogspot.de/
+ * @date 2026/10/18: matchesHostSpheres() added.
+ * @date 2026/10/18: setScalars() and setScalarSource() added.
+ * @date 2026/10/18: supportsShadowPass() and bindShadowPass() added.
+ * @date 2026/10/18: setDrawIndirect() added.
+ * @date 2026/10/18: supportsColormap() added.
+ * @date 2026/10/18: supportsMultiView() added.
+ * @date 2026/10/18: isImpostor() added.
+ * @date 2026/10/18: setDefine(), variant(), setPositionSource() and
+ * setPositionBlend() added.
  * @date 2016/03/12: Initial commit.
  *****************************************************************************/
 
@@ -11,6 +20,7 @@
 #define SPHERES_H_
 
 #include "camera.h"
+#include "gl_globals.h"
 #include <assert.h>
 #include <glm/glm.hpp>
 #include <string>
@@ -41,11 +51,115 @@ class Spheres
       return static_cast<TSpheres*>(this)->recompile();
     }
 
+    /**
+     * Selects shader variant by preprocessor define (see ShaderManager).
+     * Takes effect in the next bind().
+     */
+    void setDefine(const char* name, int value){
+      static_cast<TSpheres*>(this)->setDefine(name, value);
+    }
+
+    const std::string& variant() const{
+      return static_cast<const TSpheres*>(this)->variant();
+    }
+
+    /// ray-cast impostors via sphere.frag, i.e. supports TRANSPARENCY
+    bool isImpostor() const{
+      return static_cast<const TSpheres*>(this)->isImpostor();
+    }
+
+    /// expands in sphere_geom.geom, i.e. supports the MULTIVIEW define
+    bool supportsMultiView() const{
+      return static_cast<const TSpheres*>(this)->supportsMultiView();
+    }
+
+    /// stores a scalar per sphere, i.e. supports the COLORMAP define
+    bool supportsColormap() const{
+      return static_cast<const TSpheres*>(this)->supportsColormap();
+    }
+
+    /**
+     * Draws the static spheres of the host sequence in main.cpp
+     * (generateSpheres()) in the same order, i.e. supports CPU picking.
+     */
+    bool matchesHostSpheres() const{
+      return static_cast<const TSpheres*>(this)->matchesHostSpheres();
+    }
+
+    /// has a layered depth-only program, i.e. supports the SHADOWS define
+    bool supportsShadowPass() const{
+      return static_cast<const TSpheres*>(this)->supportsShadowPass();
+    }
+
+    /**
+     * Streams sphere centers (x,y,z floats) from a buffer, e.g. for
+     * trajectory playback. Buffer 0 restores the static centers. With a
+     * next buffer, centers are blended by setPositionBlend().
+     * @retval 0 on success, 1 if not supported by the renderer
+     */
+    int setPositionSource(GLuint buffer, GLintptr offset,
+                          GLuint next_buffer = 0, GLintptr next_offset = 0){
+      assert(_created==1);
+      return static_cast<TSpheres*>(this)->setPositionSource(buffer, offset,
+                                                             next_buffer, next_offset);
+    }
+
+    /**
+     * Interpolation weight between the position source (0) and the next
+     * position source (1), evaluated on the GPU.
+     */
+    void setPositionBlend(float blend){
+      static_cast<TSpheres*>(this)->setPositionBlend(blend);
+    }
+
+    /**
+     * Replaces the scalars (COLORMAP), one float per sphere in the order of
+     * the generated spheres.
+     * @retval 0 on success, 1 if not supported by the renderer
+     */
+    int setScalars(const float* scalars){
+      assert(_created==1);
+      return static_cast<TSpheres*>(this)->setScalars(scalars);
+    }
+
+    /**
+     * Reads the scalars (floats) from a buffer, e.g. computed on the GPU.
+     * Buffer 0 restores the scalars of setScalars().
+     * @retval 0 on success, 1 if not supported by the renderer
+     */
+    int setScalarSource(GLuint buffer, GLintptr offset){
+      assert(_created==1);
+      return static_cast<TSpheres*>(this)->setScalarSource(buffer, offset);
+    }
+
+    /**
+     * Draws only the spheres listed in an index buffer (GLuint), as many as
+     * the DrawElementsIndirectCommand in the command buffer says, e.g. the
+     * output of SphereFilter. Buffer 0 draws all spheres again.
+     * @retval 0 on success, 1 if not supported by the renderer
+     */
+    int setDrawIndirect(GLuint indices, GLuint command){
+      assert(_created==1);
+      return static_cast<TSpheres*>(this)->setDrawIndirect(indices, command);
+    }
+
     void bind(const float* lightPos, const Camera& camera){
       assert(_created==1);
       static_cast<TSpheres*>(this)->bind(lightPos, camera);
     }
 
+    /**
+     * Binds the program drawing the spheres into the layers of a ShadowMap
+     * with the given number of cascades, draw by operator() and unbind().
+     * The program is separate from the variants selected by setDefine().
+     * @retval false if nothing is bound (program not linked yet or not
+     * supported), the shadow pass is skipped then
+     */
+    bool bindShadowPass(unsigned cascades){
+      assert(_created==1);
+      return static_cast<TSpheres*>(this)->bindShadowPass(cascades);
+    }
+
     void operator()(){
       assert(_created==1);
       static_cast<TSpheres*>(this)();
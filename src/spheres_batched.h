@@ -0,0 +1,556 @@
+/*****************************************************************************/
+/**
+ * @file spheres_batched.h
+ * @brief Implementation of batched sphere groups drawn by multi-draw-indirect.
+ * @date 2026/10/18: matchesHostSpheres() added.
+ * @date 2026/10/18: Scalars in their own buffer (setScalars, setScalarSource).
+ * @date 2026/10/18: Own program for the shadow pass (bindShadowPass).
+ * @date 2026/10/18: setDrawIndirect() added.
+ * @date 2026/10/18: Scalar attribute for the transfer function (COLORMAP).
+ * @date 2026/10/18: Cascaded shadow map pass (SHADOW_PASS, SHADOWS).
+ * @date 2026/10/18: Clustered point lights (LIGHTS).
+ * @date 2026/10/18: Layered multi-view rendering (MULTIVIEW).
+ * @date 2026/10/18: Sphere alpha from the radius for TRANSPARENCY.
+ * @date 2026/10/18: Rigid per-group transforms (quaternion, translation)
+ * updated each frame.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef SPHERES_BATCHED_H_
+#define SPHERES_BATCHED_H_
+
+#include "tools.h"
+#include "shader.h"
+#include "gl_globals.h"
+#include "spheres.h"
+#include "clustered_lights.h"
+#include "shadow_map.h"
+#include "transfer_function.h"
+#include "frame_uniforms.h"
+#include "multi_view.h"
+#include "ambient_occlusion.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/// number of independent sphere groups (capped by the number of spheres)
+#ifndef BATCH_NUM_GROUPS
+#define BATCH_NUM_GROUPS 4096
+#endif
+/// texels per group transform: rotation quaternion, translation + scale
+#define BATCH_TRANSFORM_TEXELS 2
+/// define to 0 to keep the groups at rest
+#ifndef BATCH_ANIMATE
+#define BATCH_ANIMATE 1
+#endif
+
+/**
+ * Sphere rendering of many independent groups (e.g. molecules, rigid bodies)
+ * with one draw call. All groups are packed into shared buffers, their
+ * spheres are stored in group-local space once. Each group (rigid cluster)
+ * has a transform (rotation quaternion, translation, uniform scale) in a
+ * small TBO, which is updated every frame by buffer orphaning, and a static
+ * material (color tint) TBO. The vertex shader composes the group transform
+ * before MVMatrix, so moving clusters costs O(groups) instead of O(spheres)
+ * upload bandwidth. Ambient occlusion is computed for the initial pose.
+ * One glMultiDrawArraysIndirect() draws all groups, the group is selected
+ * by gl_DrawIDARB (ARB_shader_draw_parameters) or by an instanced group id
+ * attribute fetched at baseInstance. Without ARB_multi_draw_indirect
+ * the groups are drawn one by one (the group id is set as constant attribute).
+ * Billboards are created by the geometry shader (sphere_geom.geom).
+ * Implements sphere rendering interface.
+ */
+template<unsigned TNumSpheres>
+class SpheresBatched : Spheres<SpheresBatched<TNumSpheres>, TNumSpheres>
+{
+  public:
+  SpheresBatched()
+      :_vertexBuffer(0),_vertexArray(0),_groupIdBuffer(0),_indirectBuffer(0),
+       _scalarBuffer(0),_transformTbo(0),_transformData(0),_materialTbo(0),_materialData(0),
+       _numGroups(0),_shadowCascades(0),_useIndirect(false),_useDrawID(false)
+      {}
+    const std::string getDescription() const {
+      return "Spheres Rendering: Batched groups by Multi-Draw-Indirect and Geometry Shader.";
+    }
+    int create(float radius_mean, float radius_var);
+    int recompile();
+    void setDefine(const char* name, int value) { _shader.setDefine(name, value); }
+    const std::string& variant() const { return _shader.variant(); }
+    bool isImpostor() const { return true; }
+    bool supportsMultiView() const { return true; }
+    bool supportsColormap() const { return true; }
+    /// group-local spheres under moving group transforms
+    bool matchesHostSpheres() const { return false; }
+    bool supportsShadowPass() const { return true; }
+    int setPositionSource(GLuint buffer, GLintptr offset,
+                          GLuint next_buffer = 0, GLintptr next_offset = 0) {
+      printf("Position streaming is not supported by this renderer.\n");
+      return 1;
+    }
+    void setPositionBlend(float blend) {}
+    /// uploads one scalar per sphere (COLORMAP) into the renderer's buffer
+    int setScalars(const float* scalars);
+    /**
+     * Reads the scalars (floats) from buffer at offset instead of the
+     * renderer's scalar buffer, buffer 0 switches back.
+     */
+    int setScalarSource(GLuint buffer, GLintptr offset);
+    int setDrawIndirect(GLuint indices, GLuint command) {
+      printf("Indirect drawing of filtered spheres is not supported by this renderer.\n");
+      return 1;
+    }
+    void bind(const float* lightPos, const Camera& camera);
+    bool bindShadowPass(unsigned cascades);
+    void operator()();
+    void unbind();
+    void cleanup();
+  private:
+    /// layout of GL_DRAW_INDIRECT_BUFFER entries
+    struct DrawArraysIndirectCommand
+    {
+      GLuint count;
+      GLuint instanceCount;
+      GLuint first;
+      GLuint baseInstance;
+    };
+    /// rigid motion of a group
+    struct GroupMotion
+    {
+      float rotation[4]; // initial orientation (x,y,z,w)
+      float axis[3];     // axis of spin
+      float speed;       // radians per second
+      float translation[4]; // translation, scale
+    };
+    int createBuffers(float radius_mean, float radius_var);
+    int loadShader();
+    int loadShadowShader(unsigned cascades);
+    /// moves the groups and binds their transform and material TBOs
+    void bindGroups();
+    void updateTransforms(float seconds);
+  private:
+    ShaderManager _shader;
+    /// SHADOW_PASS program, built on first use
+    ShaderManager _shadowShader;
+    GLuint _vertexBuffer, _vertexArray, _groupIdBuffer, _indirectBuffer;
+    GLuint _scalarBuffer;
+    GLuint _transformTbo, _transformData;
+    GLuint _materialTbo, _materialData;
+    unsigned _numGroups;
+    unsigned _shadowCascades;
+    bool _useIndirect, _useDrawID;
+    /// group ranges, used if multi-draw-indirect is not available
+    std::vector<DrawArraysIndirectCommand> _commands;
+    std::vector<GroupMotion> _motion;
+    /// host copy of the transform TBO
+    std::vector<GLfloat> _transforms;
+    std::chrono::steady_clock::time_point _start;
+};
+
+template<unsigned TNumSpheres>
+int SpheresBatched<TNumSpheres>::loadShader()
+{
+  if (_shader.isLoaded())
+      _shader.unload();
+  if (_shadowShader.isLoaded())
+      _shadowShader.unload();
+  _shadowCascades = 0;
+
+  _shader.setDefine("DRAW_ID", _useDrawID ? 1 : 0);
+  _shader.load("sphere_batched.vert", "sphere.frag", "sphere_geom.geom");
+
+  _shader.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+  _shader.setUniformBlockBinding(VIEW_UNIFORM_BLOCK, VIEW_UNIFORM_BINDING);
+  ClusteredLights::setBindings(_shader);
+  ShadowMap::setBindings(_shader);
+  TransferFunction::setBindings(_shader);
+  _shader.setSamplerUnit("GroupTransforms", 0); // texture slots
+  _shader.setSamplerUnit("GroupMaterials", 1);
+  int s = _shader.link();
+  if (s)
+  {
+    printf("Error occurred.\n");
+    return 1;
+  }
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+
+  return 0;
+}
+
+template<unsigned TNumSpheres>
+int SpheresBatched<TNumSpheres>::loadShadowShader(unsigned cascades)
+{
+  // not linked here, bindShadowPass() skips the pass until it is
+  _shadowShader.setDefine("SHADOW_PASS", (int) cascades);
+  _shadowShader.setDefine("DRAW_ID", _useDrawID ? 1 : 0);
+  if (_shadowShader.load("sphere_batched.vert", "sphere.frag", "sphere_geom.geom") != 0)
+    return 1;
+
+  _shadowShader.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+  ShadowMap::setBindings(_shadowShader);
+  _shadowShader.setSamplerUnit("GroupTransforms", 0); // texture slots
+  _shadowShader.setSamplerUnit("GroupMaterials", 1);
+  _shadowCascades = cascades;
+  return 0;
+}
+
+template<unsigned TNumSpheres>
+int SpheresBatched<TNumSpheres>::create(float radius_mean, float radius_var)
+{
+  glHint(GL_PERSPECTIVE_CORRECTION_HINT,GL_NICEST);
+  _useIndirect = GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance;
+  _useDrawID = _useIndirect && GLEW_ARB_shader_draw_parameters;
+  printf("Batched groups: %s, group id by %s.\n",
+         _useIndirect ? "glMultiDrawArraysIndirect" : "glDrawArrays per group",
+         _useDrawID ? "gl_DrawIDARB" : "instanced attribute");
+  int err = createBuffers(radius_mean, radius_var);
+  err |= loadShader();
+  return err;
+}
+
+
+template<unsigned TNumSpheres>
+int SpheresBatched<TNumSpheres>::recompile()
+{
+  // non-blocking, the current program is used until the new one is linked
+  if (_shadowShader.isLoaded())
+    _shadowShader.reload();
+  return _shader.reload();
+}
+
+template<unsigned TNumSpheres>
+void SpheresBatched<TNumSpheres>::bind(const float* lightPos, const Camera& camera)
+{
+  bindGroups();
+  _shader.bind();
+}
+template<unsigned TNumSpheres>
+bool SpheresBatched<TNumSpheres>::bindShadowPass(unsigned cascades)
+{
+  if (!_shadowShader.isLoaded())
+    loadShadowShader(cascades);
+  else if (cascades != _shadowCascades)
+  {
+    _shadowCascades = cascades;
+    _shadowShader.setDefine("SHADOW_PASS", (int) cascades);
+  }
+  _shadowShader.bind();
+  if (!_shadowShader.isCurrent())
+  {
+    _shadowShader.unbind();
+    return false;
+  }
+  bindGroups();
+  return true;
+}
+template<unsigned TNumSpheres>
+void SpheresBatched<TNumSpheres>::bindGroups()
+{
+#if BATCH_ANIMATE
+  std::chrono::duration<float> t = std::chrono::steady_clock::now() - _start;
+  updateTransforms(t.count());
+#endif
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_BUFFER, _materialTbo);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_BUFFER, _transformTbo);
+}
+template<unsigned TNumSpheres>
+void SpheresBatched<TNumSpheres>::operator()()
+{
+  glBindVertexArray(_vertexArray);
+  if (_useIndirect)
+  {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _indirectBuffer);
+    glMultiDrawArraysIndirect(GL_POINTS, 0, _numGroups, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  }
+  else
+  {
+    // attribute 4 is disabled, so its current value is used as group id
+    for (unsigned g = 0; g < _numGroups; ++g)
+    {
+      glVertexAttribI1ui(4, g);
+      glDrawArrays(GL_POINTS, _commands[g].first, _commands[g].count);
+    }
+  }
+  glBindVertexArray(0);
+}
+
+template<unsigned TNumSpheres>
+int SpheresBatched<TNumSpheres>::setScalars(const float* scalars)
+{
+  if (!_scalarBuffer)
+    glGenBuffers(1, &_scalarBuffer);
+  // same buffer object, so the vertex array keeps pointing to it
+  upload_buffer(_scalarBuffer, scalars, TNumSpheres, GL_ARRAY_BUFFER, GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+
+template<unsigned TNumSpheres>
+int SpheresBatched<TNumSpheres>::setScalarSource(GLuint buffer, GLintptr offset)
+{
+  glBindVertexArray(_vertexArray);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer ? buffer : _scalarBuffer);
+  glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, 4, (GLvoid*)(buffer ? offset : 0));
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+
+template<unsigned TNumSpheres>
+void SpheresBatched<TNumSpheres>::unbind()
+{
+  _shader.unbind();
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+template<unsigned TNumSpheres>
+void SpheresBatched<TNumSpheres>::updateTransforms(float seconds)
+{
+  for (unsigned g = 0; g < _numGroups; ++g)
+  {
+    const GroupMotion &m = _motion[g];
+    // spin quaternion times initial orientation
+    const float h = 0.5f * m.speed * seconds;
+    const float sh = sinf(h);
+    const float a[4] = { m.axis[0]*sh, m.axis[1]*sh, m.axis[2]*sh, cosf(h) };
+    const float *b = m.rotation;
+    GLfloat *q = &_transforms[4 * BATCH_TRANSFORM_TEXELS * g];
+    q[0] = a[3]*b[0] + a[0]*b[3] + a[1]*b[2] - a[2]*b[1];
+    q[1] = a[3]*b[1] - a[0]*b[2] + a[1]*b[3] + a[2]*b[0];
+    q[2] = a[3]*b[2] + a[0]*b[1] - a[1]*b[0] + a[2]*b[3];
+    q[3] = a[3]*b[3] - a[0]*b[0] - a[1]*b[1] - a[2]*b[2];
+    for (int c = 0; c < 4; ++c)
+      q[4+c] = m.translation[c];
+  }
+  // orphan the old storage, so we do not wait for draws still reading it
+  const GLsizeiptr size = _transforms.size() * sizeof(GLfloat);
+  glBindBuffer(GL_TEXTURE_BUFFER, _transformData);
+  glBufferData(GL_TEXTURE_BUFFER, size, NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_TEXTURE_BUFFER, 0, size, &_transforms[0]);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+
+template<unsigned TNumSpheres>
+int SpheresBatched<TNumSpheres>::createBuffers(float radius_mean, float radius_var)
+{
+  srand(2013);
+  _numGroups = BATCH_NUM_GROUPS < TNumSpheres ? BATCH_NUM_GROUPS : TNumSpheres;
+
+  ///// GROUPS: sizes vary around the mean, the last group takes the rest
+  _commands.resize(_numGroups);
+  std::vector<float> weights(_numGroups);
+  float weight_sum = 0.0f;
+  for (unsigned g = 0; g < _numGroups; ++g)
+  {
+    weights[g] = mrand(0.25f, 1.75f);
+    weight_sum += weights[g];
+  }
+  unsigned first = 0;
+  for (unsigned g = 0; g < _numGroups; ++g)
+  {
+    unsigned count = (unsigned) (weights[g] / weight_sum * TNumSpheres);
+    if (g == _numGroups - 1 || first + count > TNumSpheres)
+      count = TNumSpheres - first;
+    _commands[g].count = count;
+    _commands[g].instanceCount = 1;
+    _commands[g].first = first;
+    _commands[g].baseInstance = g; // selects the instanced group id
+    first += count;
+  }
+
+  ///// GROUPS: orientation, spin, translation, scale and material (tint)
+  _motion.resize(_numGroups);
+  std::vector<GLfloat> materials(4 * _numGroups);
+  for (unsigned g = 0; g < _numGroups; ++g)
+  {
+    GroupMotion &m = _motion[g];
+    float q[4] = { mrand(-1.f, 1.f), mrand(-1.f, 1.f), mrand(-1.f, 1.f), mrand(-1.f, 1.f) };
+    float qlen = sqrtf(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+    if (qlen < 1e-6f)
+    {
+      q[0] = q[1] = q[2] = 0.0f; q[3] = qlen = 1.0f;
+    }
+    for (int c = 0; c < 4; ++c)
+      m.rotation[c] = q[c] / qlen;
+    float axis[3] = { mrand(-1.f, 1.f), mrand(-1.f, 1.f), mrand(-1.f, 1.f) };
+    float alen = sqrtf(axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2]);
+    if (alen < 1e-6f)
+    {
+      axis[0] = axis[1] = 0.0f; axis[2] = alen = 1.0f;
+    }
+    for (int c = 0; c < 3; ++c)
+      m.axis[c] = axis[c] / alen;
+    m.speed = mrand(-1.f, 1.f);
+    m.translation[0] = mrand(-1.f, 1.f);
+    m.translation[1] = mrand(-1.f, 1.f);
+    m.translation[2] = mrand(-1.f, 1.f);
+    m.translation[3] = mrand(0.05f, 0.2f); // group extent (scale)
+
+    materials[4*g+0] = mrand(0.5f, 1.0f); // Red tint
+    materials[4*g+1] = mrand(0.5f, 1.0f); // Green tint
+    materials[4*g+2] = mrand(0.5f, 1.0f); // Blue tint
+    materials[4*g+3] = 1.0f;
+  }
+
+  ///// VERTEX (group-local space)
+  GLfloat *h_data = new GLfloat[12 * TNumSpheres];
+  std::vector<float> world(4 * TNumSpheres); // x,y,z,radius for AO
+  std::vector<GLfloat> scalars(TNumSpheres);
+  for (unsigned g = 0; g < _numGroups; ++g)
+  {
+    const GroupMotion &m = _motion[g];
+    const float x = m.rotation[0], y = m.rotation[1], z = m.rotation[2], w = m.rotation[3];
+    const float s = m.translation[3];
+    // initial pose as column-major matrix (rotation * scale)
+    const float r[9] = {
+      s*(1.f-2.f*(y*y+z*z)), s*(2.f*(x*y+w*z)),     s*(2.f*(x*z-w*y)),
+      s*(2.f*(x*y-w*z)),     s*(1.f-2.f*(x*x+z*z)), s*(2.f*(y*z+w*x)),
+      s*(2.f*(x*z+w*y)),     s*(2.f*(y*z-w*x)),     s*(1.f-2.f*(x*x+y*y)) };
+    for (unsigned k = _commands[g].first; k < _commands[g].first + _commands[g].count; ++k)
+    {
+      GLfloat *v = h_data + 12 * k;
+      v[0] = mrand(-1.f, 1.f); // vertex.x
+      v[1] = mrand(-1.f, 1.f); // vertex.y
+      v[2] = mrand(-1.f, 1.f); // vertex.z
+      v[3] = 1.0f; // vertex.w
+
+      v[4] = mrand(0.f, 1.0f); // Red
+      v[5] = mrand(0.f, 1.0f); // Green
+      v[6] = mrand(0.f, 1.0f); // Blue
+
+      // same world-space radius distribution as the other renderers
+      float radius = radius_var * rand() / RAND_MAX + radius_mean;
+      v[8] = radius / s;
+      v[7] = sphereAlpha(radius, radius_mean, radius_var); // Alpha
+
+      for (int c = 0; c < 3; ++c)
+        world[4*k+c] = r[c]*v[0] + r[3+c]*v[1] + r[6+c]*v[2] + m.translation[c];
+      world[4*k+3] = radius;
+      scalars[k] = sphereScalar(world[4*k], world[4*k+1], world[4*k+2]);
+    }
+  }
+  computeAmbientOcclusion(&world[0], 4, &world[3], 4, h_data+9, 12, TNumSpheres);
+
+  ///
+  if(!_vertexBuffer)
+    glGenBuffers(1, &_vertexBuffer);
+  upload_buffer(_vertexBuffer, h_data, 12 * TNumSpheres, GL_ARRAY_BUFFER, GL_STATIC_DRAW);
+  delete[] h_data;
+  if (setScalars(&scalars[0]) != 0)
+    return 1;
+
+  glGenBuffers(1, &_materialData);
+  upload_buffer(_materialData, &materials[0], 4 * _numGroups, GL_TEXTURE_BUFFER, GL_STATIC_DRAW);
+  glGenTextures(1, &_materialTbo);
+  glBindTexture(GL_TEXTURE_BUFFER, _materialTbo);
+  glTexBufferEXT(GL_TEXTURE_BUFFER, GL_RGBA32F, _materialData);
+
+  _transforms.resize(4 * BATCH_TRANSFORM_TEXELS * _numGroups);
+  glGenBuffers(1, &_transformData);
+  glGenTextures(1, &_transformTbo);
+  updateTransforms(0.0f);
+  glBindTexture(GL_TEXTURE_BUFFER, _transformTbo);
+  glTexBufferEXT(GL_TEXTURE_BUFFER, GL_RGBA32F, _transformData);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+  _start = std::chrono::steady_clock::now();
+
+  printf("Batched groups: %u groups, transform update %u bytes per frame (%u bytes for all centers).\n",
+         _numGroups, (unsigned) (_transforms.size() * sizeof(GLfloat)),
+         (unsigned) (3 * sizeof(GLfloat) * TNumSpheres));
+
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+
+  ///// DRAW COMMANDS and instanced group ids
+  if (_useIndirect)
+  {
+    glGenBuffers(1, &_indirectBuffer);
+    upload_buffer(_indirectBuffer, &_commands[0], _numGroups, GL_DRAW_INDIRECT_BUFFER, GL_STATIC_DRAW);
+
+    std::vector<GLuint> group_ids(_numGroups);
+    for (unsigned g = 0; g < _numGroups; ++g)
+      group_ids[g] = g;
+    glGenBuffers(1, &_groupIdBuffer);
+    upload_buffer(_groupIdBuffer, &group_ids[0], _numGroups, GL_ARRAY_BUFFER, GL_STATIC_DRAW);
+  }
+
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  // ------------
+  // create vertex array buffer
+  if(!_vertexArray)
+    glGenVertexArrays(1, &_vertexArray);
+
+  glBindVertexArray(_vertexArray);
+  glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+  glEnableVertexAttribArray(0); // pos
+  glEnableVertexAttribArray(1); // color
+  glEnableVertexAttribArray(2); // radius
+  glEnableVertexAttribArray(3); // ambient occlusion
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 12*4, 0);
+  glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 12*4, (GLvoid*)16);
+  glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 12*4, (GLvoid*)32);
+  glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 12*4, (GLvoid*)36);
+  glBindBuffer(GL_ARRAY_BUFFER, _scalarBuffer);
+  glEnableVertexAttribArray(5); // scalar (COLORMAP)
+  glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, 4, 0);
+  if (_useIndirect)
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, _groupIdBuffer);
+    glEnableVertexAttribArray(4); // group id, one per draw (baseInstance)
+    glVertexAttribIPointer(4, 1, GL_UNSIGNED_INT, 0, 0);
+    glVertexAttribDivisor(4, 1);
+  }
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+
+template<unsigned TNumSpheres>
+void SpheresBatched<TNumSpheres>::cleanup()
+{
+  glDeleteVertexArrays(1, &_vertexArray);
+  _vertexArray = 0;
+
+  glDeleteBuffers(1, &_vertexBuffer);
+  _vertexBuffer = 0;
+
+  glDeleteBuffers(1, &_scalarBuffer);
+  _scalarBuffer = 0;
+
+  glDeleteBuffers(1, &_groupIdBuffer);
+  _groupIdBuffer = 0;
+
+  glDeleteBuffers(1, &_indirectBuffer);
+  _indirectBuffer = 0;
+
+  glDeleteBuffers(1, &_transformData);
+  _transformData = 0;
+  glDeleteTextures(1, &_transformTbo);
+  _transformTbo = 0;
+
+  glDeleteBuffers(1, &_materialData);
+  _materialData = 0;
+  glDeleteTextures(1, &_materialTbo);
+  _materialTbo = 0;
+}
+
+
+#endif /* SPHERES_BATCHED_H_ */
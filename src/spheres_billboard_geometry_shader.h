@@ -5,6 +5,18 @@
  * shader.
  * @author Matthias Werner
  * @sa http://11235813tdd.blogspot.de/
+ * @date 2026/10/18: matchesHostSpheres() added.
+ * @date 2026/10/18: Scalars in their own buffer (setScalars, setScalarSource).
+ * @date 2026/10/18: Own program for the shadow pass (bindShadowPass).
+ * @date 2026/10/18: Filtered spheres by indirect draw (setDrawIndirect).
+ * @date 2026/10/18: Scalar attribute for the transfer function (COLORMAP).
+ * @date 2026/10/18: Cascaded shadow map pass (SHADOW_PASS, SHADOWS).
+ * @date 2026/10/18: Clustered point lights (LIGHTS).
+ * @date 2026/10/18: Layered multi-view rendering (MULTIVIEW).
+ * @date 2026/10/18: Sphere alpha from the radius for TRANSPARENCY.
+ * @date 2026/10/18: Interpolation between two streamed position frames.
+ * @date 2026/10/18: Sphere centers can be streamed (setPositionSource).
+ * @date 2026/10/18: Precomputed ambient occlusion attribute.
  * @date 2016/03/12: Initial commit.
  *****************************************************************************/
 #ifndef SPHERE_BILLBOARD_GEOMETRY_SHADER_H_
@@ -14,6 +26,12 @@
 #include "shader.h"
 #include "gl_globals.h"
 #include "spheres.h"
+#include "clustered_lights.h"
+#include "shadow_map.h"
+#include "transfer_function.h"
+#include "frame_uniforms.h"
+#include "multi_view.h"
+#include "ambient_occlusion.h"
 
 #include <stdlib.h>
 #include <string>
@@ -28,24 +46,58 @@ class SpheresBillboardGeometryShader : Spheres<SpheresBillboardGeometryShader<TN
 {
   public:
   SpheresBillboardGeometryShader()
-      :_vertexBuffer(0),_vertexArray(0),_indexBuffer(0)
+      :_vertexBuffer(0),_vertexArray(0),_indexBuffer(0),_scalarBuffer(0),
+       _drawCommand(0),_shadowCascades(0),_blend(0.0f),_interpolate(false)
       {}
     const std::string getDescription() const {
       return "Spheres Rendering: Billboard using Geometry Shader only.";
     }
     int create(float radius_mean, float radius_var);
     int recompile();
+    void setDefine(const char* name, int value) { _shader.setDefine(name, value); }
+    const std::string& variant() const { return _shader.variant(); }
+    bool isImpostor() const { return true; }
+    bool supportsMultiView() const { return true; }
+    bool supportsColormap() const { return true; }
+    bool matchesHostSpheres() const { return true; }
+    bool supportsShadowPass() const { return true; }
+    /**
+     * Reads sphere centers (x,y,z floats) from buffer at offset instead of
+     * the static vertex buffer, buffer 0 switches back. If next_buffer is
+     * given, centers are interpolated on the GPU (see setPositionBlend()).
+     */
+    int setPositionSource(GLuint buffer, GLintptr offset,
+                          GLuint next_buffer = 0, GLintptr next_offset = 0);
+    void setPositionBlend(float blend) { _blend = blend; }
+    /// uploads one scalar per sphere (COLORMAP) into the renderer's buffer
+    int setScalars(const float* scalars);
+    /**
+     * Reads the scalars (floats) from buffer at offset instead of the
+     * renderer's scalar buffer, buffer 0 switches back.
+     */
+    int setScalarSource(GLuint buffer, GLintptr offset);
+    /// draws the spheres of an index buffer by an indirect command, 0 all
+    int setDrawIndirect(GLuint indices, GLuint command);
     void bind(const float* lightPos, const Camera& camera);
+    bool bindShadowPass(unsigned cascades);
     void operator()();
     void unbind();
     void cleanup();
   private:
     int createBuffers(float radius_mean, float radius_var);
     int loadShader();
+    int loadShadowShader(unsigned cascades);
     void createSphereGeom( int rings=10, int sectors=10 );
   private:
     ShaderManager _shader;
+    /// SHADOW_PASS program, built on first use
+    ShaderManager _shadowShader;
     GLuint _vertexBuffer, _vertexArray, _indexBuffer;
+    GLuint _scalarBuffer;
+    GLuint _drawCommand;
+    unsigned _shadowCascades;
+    float _blend;
+    bool _interpolate;
 };
 
 template<unsigned TNumSpheres>
@@ -53,9 +105,17 @@ int SpheresBillboardGeometryShader<TNumSpheres>::loadShader()
 {
   if (_shader.isLoaded())
       _shader.unload();
+  if (_shadowShader.isLoaded())
+      _shadowShader.unload();
+  _shadowCascades = 0;
 
   _shader.load("sphere_geom.vert", "sphere.frag", "sphere_geom.geom");
 
+  _shader.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+  _shader.setUniformBlockBinding(VIEW_UNIFORM_BLOCK, VIEW_UNIFORM_BINDING);
+  ClusteredLights::setBindings(_shader);
+  ShadowMap::setBindings(_shader);
+  TransferFunction::setBindings(_shader);
   int s = _shader.link();
   if (s)
   {
@@ -68,6 +128,21 @@ int SpheresBillboardGeometryShader<TNumSpheres>::loadShader()
   return 0;
 }
 
+template<unsigned TNumSpheres>
+int SpheresBillboardGeometryShader<TNumSpheres>::loadShadowShader(unsigned cascades)
+{
+  // not linked here, bindShadowPass() skips the pass until it is
+  _shadowShader.setDefine("SHADOW_PASS", (int) cascades);
+  _shadowShader.setDefine("INTERPOLATE", _interpolate ? 1 : 0);
+  if (_shadowShader.load("sphere_geom.vert", "sphere.frag", "sphere_geom.geom") != 0)
+    return 1;
+
+  _shadowShader.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+  ShadowMap::setBindings(_shadowShader);
+  _shadowCascades = cascades;
+  return 0;
+}
+
 template<unsigned TNumSpheres>
 int SpheresBillboardGeometryShader<TNumSpheres>::create(float radius_mean, float radius_var)
 {
@@ -81,23 +156,134 @@ int SpheresBillboardGeometryShader<TNumSpheres>::create(float radius_mean, float
 template<unsigned TNumSpheres>
 int SpheresBillboardGeometryShader<TNumSpheres>::recompile()
 {
-  return loadShader();
+  // non-blocking, the current program is used until the new one is linked
+  if (_shadowShader.isLoaded())
+    _shadowShader.reload();
+  return _shader.reload();
 }
 
 template<unsigned TNumSpheres>
 void SpheresBillboardGeometryShader<TNumSpheres>::bind(const float* lightPos, const Camera& camera)
 {
   _shader.bind();
-  _shader.setUniformVar("lightPos", lightPos);
-  _shader.setUniformMat4("MVMatrix", (float*)camera.modelview());
-  _shader.setUniformMat4("PMatrix", (float*)camera.projection());
+  if (_interpolate)
+    _shader.setUniformVar("PositionBlend", _blend);
+}
+template<unsigned TNumSpheres>
+bool SpheresBillboardGeometryShader<TNumSpheres>::bindShadowPass(unsigned cascades)
+{
+  if (!_shadowShader.isLoaded())
+    loadShadowShader(cascades);
+  else if (cascades != _shadowCascades)
+  {
+    _shadowCascades = cascades;
+    _shadowShader.setDefine("SHADOW_PASS", (int) cascades);
+  }
+  _shadowShader.bind();
+  if (!_shadowShader.isCurrent())
+  {
+    _shadowShader.unbind();
+    return false;
+  }
+  if (_interpolate)
+    _shadowShader.setUniformVar("PositionBlend", _blend);
+  return true;
 }
 template<unsigned TNumSpheres>
 void SpheresBillboardGeometryShader<TNumSpheres>::operator()()
 {
   glBindVertexArray(_vertexArray);
-  glDrawArrays(GL_POINTS, 0, TNumSpheres);
+  if (_drawCommand)
+  {
+    // count written on the GPU, e.g. by SphereFilter
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _drawCommand);
+    glDrawElementsIndirect(GL_POINTS, GL_UNSIGNED_INT, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  }
+  else
+  {
+    glDrawArrays(GL_POINTS, 0, TNumSpheres);
+  }
+  glBindVertexArray(0);
+}
+
+template<unsigned TNumSpheres>
+int SpheresBillboardGeometryShader<TNumSpheres>::setDrawIndirect(GLuint indices, GLuint command)
+{
+  // the element buffer is state of the vertex array
+  glBindVertexArray(_vertexArray);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, command ? indices : 0);
   glBindVertexArray(0);
+  _drawCommand = command;
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+
+template<unsigned TNumSpheres>
+int SpheresBillboardGeometryShader<TNumSpheres>::setPositionSource(GLuint buffer, GLintptr offset,
+                                     GLuint next_buffer, GLintptr next_offset)
+{
+  glBindVertexArray(_vertexArray);
+  if (buffer)
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3*4, (GLvoid*)offset);
+  }
+  else
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 12*4, 0);
+  }
+  bool interpolate = buffer && next_buffer;
+  if (interpolate)
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, next_buffer);
+    glEnableVertexAttribArray(4); // next pos
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 3*4, (GLvoid*)next_offset);
+  }
+  else
+  {
+    glDisableVertexAttribArray(4);
+  }
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  if (interpolate != _interpolate)
+  {
+    _interpolate = interpolate;
+    _shader.setDefine("INTERPOLATE", interpolate ? 1 : 0);
+    if (_shadowShader.isLoaded())
+      _shadowShader.setDefine("INTERPOLATE", interpolate ? 1 : 0);
+  }
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+
+template<unsigned TNumSpheres>
+int SpheresBillboardGeometryShader<TNumSpheres>::setScalars(const float* scalars)
+{
+  if (!_scalarBuffer)
+    glGenBuffers(1, &_scalarBuffer);
+  // same buffer object, so the vertex array keeps pointing to it
+  upload_buffer(_scalarBuffer, scalars, TNumSpheres, GL_ARRAY_BUFFER, GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+
+template<unsigned TNumSpheres>
+int SpheresBillboardGeometryShader<TNumSpheres>::setScalarSource(GLuint buffer, GLintptr offset)
+{
+  glBindVertexArray(_vertexArray);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer ? buffer : _scalarBuffer);
+  glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, 4, (GLvoid*)(buffer ? offset : 0));
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
 }
 
 template<unsigned TNumSpheres>
@@ -112,6 +298,7 @@ int SpheresBillboardGeometryShader<TNumSpheres>::createBuffers(float radius_mean
 {
   srand(2013);
   GLfloat *h_data = new GLfloat[12 * TNumSpheres];
+  std::vector<GLfloat> scalars(TNumSpheres);
   const float a = -1.f, b = 1.f;
   ///// VERTEX
   for (unsigned int i = 0; i < (TNumSpheres * 12); i = i + 12)
@@ -124,10 +311,12 @@ int SpheresBillboardGeometryShader<TNumSpheres>::createBuffers(float radius_mean
     h_data[i + 4] = mrand(0.f, 1.0f); // Red
     h_data[i + 5] = mrand(0.f, 1.0f); // Green
     h_data[i + 6] = mrand(0.f, 1.0f); // Blue
-    h_data[i + 7] = 1.0f; // Alpha
 
     h_data[i + 8] = radius_var * rand() / RAND_MAX + radius_mean;
+    h_data[i + 7] = sphereAlpha(h_data[i + 8], radius_mean, radius_var); // Alpha
+    scalars[i / 12] = sphereScalar(h_data[i], h_data[i + 1], h_data[i + 2]);
   }
+  computeAmbientOcclusion(h_data, 12, h_data+8, 12, h_data+9, 12, TNumSpheres);
   ///
   if(!_vertexBuffer)
     glGenBuffers(1, &_vertexBuffer);
@@ -135,6 +324,8 @@ int SpheresBillboardGeometryShader<TNumSpheres>::createBuffers(float radius_mean
   upload_buffer(_vertexBuffer, h_data, 12 * TNumSpheres, GL_ARRAY_BUFFER, GL_STATIC_DRAW);
 
   delete[] h_data;
+  if (setScalars(&scalars[0]) != 0)
+    return 1;
 
   if (CHECK_GLERROR() != GL_NO_ERROR)
     return 1;
@@ -149,9 +340,14 @@ int SpheresBillboardGeometryShader<TNumSpheres>::createBuffers(float radius_mean
   glEnableVertexAttribArray(0); // pos
   glEnableVertexAttribArray(1); // color
   glEnableVertexAttribArray(2); // radius
+  glEnableVertexAttribArray(3); // ambient occlusion
   glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 12*4, 0);
   glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 12*4, (GLvoid*)16);
   glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 12*4, (GLvoid*)32);
+  glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 12*4, (GLvoid*)36);
+  glBindBuffer(GL_ARRAY_BUFFER, _scalarBuffer);
+  glEnableVertexAttribArray(5); // scalar (COLORMAP)
+  glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, 4, 0);
   glBindVertexArray(0);
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 
@@ -168,6 +364,9 @@ void SpheresBillboardGeometryShader<TNumSpheres>::cleanup()
 
   glDeleteBuffers(1, &_vertexBuffer);
   _vertexBuffer = 0;
+
+  glDeleteBuffers(1, &_scalarBuffer);
+  _scalarBuffer = 0;
 }
 
 
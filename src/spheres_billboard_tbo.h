@@ -4,6 +4,19 @@
  * @brief Implementation of sphere rendering by billboards stored as TBOs.
  * @author Matthias Werner
  * @sa http://11235813tdd.blogspot.de/
+ * @date 2026/10/18: Sphere alpha of the 2-texel layouts computed in the shader.
+ * @date 2026/10/18: matchesHostSpheres() added.
+ * @date 2026/10/18: setScalars() and setScalarSource() added.
+ * @date 2026/10/18: supportsShadowPass() added.
+ * @date 2026/10/18: Quantized 16-bit layout (SPHERES_TBO_QUANTIZED).
+ * @date 2026/10/18: setDrawIndirect() added.
+ * @date 2026/10/18: supportsColormap() added.
+ * @date 2026/10/18: Clustered point lights (LIGHTS).
+ * @date 2026/10/18: supportsMultiView() added.
+ * @date 2026/10/18: Sphere alpha from the radius for TRANSPARENCY.
+ * @date 2026/10/18: Streamed and interpolated sphere centers.
+ * @date 2026/10/18: Compact 2-texel layout (SPHERES_TBO_COMPACT).
+ * @date 2026/10/18: Precomputed ambient occlusion attribute.
  * @date 2016/03/12: Initial commit.
  *****************************************************************************/
 
@@ -14,8 +27,12 @@
 #include "shader.h"
 #include "gl_globals.h"
 #include "spheres.h"
+#include "clustered_lights.h"
+#include "frame_uniforms.h"
+#include "ambient_occlusion.h"
 
 #include <stdlib.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -28,13 +45,51 @@ class SpheresBillboardTBO : Spheres<SpheresBillboardTBO<TNumSpheres>, TNumSphere
 {
   public:
   SpheresBillboardTBO()
-      :_vertexBuffer(0),_vertexArray(0),_indexBuffer(0),_tbo(0),_tboData(0)
-      {}
+      :_vertexBuffer(0),_vertexArray(0),_indexBuffer(0),_tbo(0),_tboData(0),
+       _blend(0.0f),_streamPositions(false),_interpolate(false)
+      {
+        _positionTbo[0] = _positionTbo[1] = 0;
+        for (int c = 0; c < 4; ++c)
+        {
+          _quantizeOrigin[c] = 0.0f;
+          _quantizeScale[c] = 1.0f;
+          _alphaRadius[c] = 0.0f;
+        }
+      }
     const std::string getDescription() const {
       return "Spheres Rendering: Billboard and Texture Buffer Object.";
     }
     int create(float radius_mean, float radius_var);
     int recompile();
+    void setDefine(const char* name, int value) { _shader.setDefine(name, value); }
+    const std::string& variant() const { return _shader.variant(); }
+    bool isImpostor() const { return true; }
+    bool supportsMultiView() const { return false; }
+    bool supportsColormap() const { return false; }
+    bool matchesHostSpheres() const { return true; }
+    bool supportsShadowPass() const { return false; }
+    bool bindShadowPass(unsigned cascades) { return false; }
+    /**
+     * Reads sphere centers (x,y,z floats) from buffer at offset instead of
+     * the sphere TBO (needs ARB_texture_buffer_range and RGB32F texture
+     * buffers), buffer 0 switches back. If next_buffer is given, centers
+     * are interpolated on the GPU (see setPositionBlend()).
+     */
+    int setPositionSource(GLuint buffer, GLintptr offset,
+                          GLuint next_buffer = 0, GLintptr next_offset = 0);
+    void setPositionBlend(float blend) { _blend = blend; }
+    int setScalars(const float* scalars) {
+      printf("Scalars are not supported by this renderer.\n");
+      return 1;
+    }
+    int setScalarSource(GLuint buffer, GLintptr offset) {
+      printf("Scalars are not supported by this renderer.\n");
+      return 1;
+    }
+    int setDrawIndirect(GLuint indices, GLuint command) {
+      printf("Indirect drawing of filtered spheres is not supported by this renderer.\n");
+      return 1;
+    }
     void bind(const float* lightPos, const Camera& camera);
     void operator()();
     void unbind();
@@ -47,6 +102,13 @@ class SpheresBillboardTBO : Spheres<SpheresBillboardTBO<TNumSpheres>, TNumSphere
     ShaderManager _shader;
     GLuint _vertexBuffer, _vertexArray, _indexBuffer;
     GLuint _tbo, _tboData;
+    GLuint _positionTbo[2]; ///< streamed centers (current, next)
+    float _blend;
+    bool _streamPositions, _interpolate;
+    /// decoding of the quantized layout: origin + t * scale (x,y,z,radius)
+    float _quantizeOrigin[4], _quantizeScale[4];
+    /// sphereAlpha() of the 2-texel layouts: radius mean, 1/variance (0: opaque)
+    float _alphaRadius[4];
 };
 
 template<unsigned TNumSpheres>
@@ -55,8 +117,18 @@ int SpheresBillboardTBO<TNumSpheres>::loadShader()
   if (_shader.isLoaded())
       _shader.unload();
 
+#if defined(SPHERES_TBO_COMPACT)
+  _shader.setDefine("SPHERE_COMPACT", 1);
+#elif defined(SPHERES_TBO_QUANTIZED)
+  _shader.setDefine("SPHERE_QUANTIZED", 1);
+#endif
   _shader.load("sphere.vert", "sphere.frag");
 
+  _shader.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+  ClusteredLights::setBindings(_shader);
+  _shader.setSamplerUnit("SphereParams", 0); // texture slots
+  _shader.setSamplerUnit("Positions", 1);
+  _shader.setSamplerUnit("NextPositions", 2);
   int s = _shader.link();
   if (s)
   {
@@ -73,6 +145,8 @@ template<unsigned TNumSpheres>
 int SpheresBillboardTBO<TNumSpheres>::create(float radius_mean, float radius_var)
 {
   glHint(GL_PERSPECTIVE_CORRECTION_HINT,GL_NICEST);
+  _alphaRadius[0] = radius_mean;
+  _alphaRadius[1] = radius_var > 0.0f ? 1.0f / radius_var : 0.0f;
   int err = createBuffers(radius_mean, radius_var);
   err |= loadShader();
   return err;
@@ -82,18 +156,32 @@ int SpheresBillboardTBO<TNumSpheres>::create(float radius_mean, float radius_var
 template<unsigned TNumSpheres>
 int SpheresBillboardTBO<TNumSpheres>::recompile()
 {
-  return loadShader();
+  // non-blocking, the current program is used until the new one is linked
+  return _shader.reload();
 }
 
 template<unsigned TNumSpheres>
 void SpheresBillboardTBO<TNumSpheres>::bind(const float* lightPos, const Camera& camera)
 {
+  if (_streamPositions)
+  {
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_BUFFER, _positionTbo[1]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, _positionTbo[0]);
+    glActiveTexture(GL_TEXTURE0);
+  }
   glBindTexture(GL_TEXTURE_BUFFER, _tbo);
   _shader.bind();
-  _shader.setUniformVar("lightPos", lightPos);
-  _shader.setUniformMat4("MVMatrix", (float*)camera.modelview());
-  _shader.setUniformMat4("PMatrix", (float*)camera.projection());
-  _shader.setUniformVar("SphereParams", 0); // texture slot
+#if defined(SPHERES_TBO_COMPACT) || defined(SPHERES_TBO_QUANTIZED)
+  _shader.setUniformVar("AlphaRadius", _alphaRadius);
+#endif
+#ifdef SPHERES_TBO_QUANTIZED
+  _shader.setUniformVar("QuantizeOrigin", _quantizeOrigin);
+  _shader.setUniformVar("QuantizeScale", _quantizeScale);
+#endif
+  if (_interpolate)
+    _shader.setUniformVar("PositionBlend", _blend);
 }
 template<unsigned TNumSpheres>
 void SpheresBillboardTBO<TNumSpheres>::operator()()
@@ -107,9 +195,57 @@ template<unsigned TNumSpheres>
 void SpheresBillboardTBO<TNumSpheres>::unbind()
 {
   _shader.unbind();
+  if (_streamPositions)
+  {
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+  }
   glBindTexture(GL_TEXTURE_BUFFER, 0);
 }
 
+template<unsigned TNumSpheres>
+int SpheresBillboardTBO<TNumSpheres>::setPositionSource(GLuint buffer, GLintptr offset,
+                                     GLuint next_buffer, GLintptr next_offset)
+{
+  if (buffer && !(GLEW_ARB_texture_buffer_range && GLEW_ARB_texture_buffer_object_rgb32))
+  {
+    printf("Position streaming needs ARB_texture_buffer_range and RGB32F texture buffers.\n");
+    return 1;
+  }
+  const GLsizeiptr size = 3 * sizeof(GLfloat) * TNumSpheres;
+  if (buffer)
+  {
+    if (!_positionTbo[0])
+      glGenTextures(2, _positionTbo);
+    glBindTexture(GL_TEXTURE_BUFFER, _positionTbo[0]);
+    glTexBufferRange(GL_TEXTURE_BUFFER, GL_RGB32F, buffer, offset, size);
+    if (next_buffer)
+    {
+      glBindTexture(GL_TEXTURE_BUFFER, _positionTbo[1]);
+      glTexBufferRange(GL_TEXTURE_BUFFER, GL_RGB32F, next_buffer, next_offset, size);
+    }
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+  }
+  bool stream = buffer != 0;
+  bool interpolate = buffer && next_buffer;
+  if (stream != _streamPositions)
+  {
+    _streamPositions = stream;
+    _shader.setDefine("STREAM_POSITIONS", stream ? 1 : 0);
+  }
+  if (interpolate != _interpolate)
+  {
+    _interpolate = interpolate;
+    _shader.setDefine("INTERPOLATE", interpolate ? 1 : 0);
+  }
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+
 
 template<unsigned TNumSpheres>
 int SpheresBillboardTBO<TNumSpheres>::createBuffers(float radius_mean, float radius_var)
@@ -128,16 +264,64 @@ int SpheresBillboardTBO<TNumSpheres>::createBuffers(float radius_mean, float rad
       h_data[i + 4] = mrand(0.f, 1.0f); // Red
       h_data[i + 5] = mrand(0.f, 1.0f); // Green
       h_data[i + 6] = mrand(0.f, 1.0f); // Blue
-      h_data[i + 7] = 1.0f; // Alpha
 
       h_data[i + 8] = radius_var * rand() / RAND_MAX + radius_mean;
+      h_data[i + 7] = sphereAlpha(h_data[i + 8], radius_mean, radius_var); // Alpha
+    }
+    computeAmbientOcclusion(h_data, 12, h_data+8, 12, h_data+9, 12, TNumSpheres);
+#ifdef SPHERES_TBO_COMPACT
+    // repack in place to 2 texels: (x,y,z,radius), (r,g,b,ao)
+    for (unsigned int i = 0; i < TNumSpheres; ++i)
+    {
+      const GLfloat *src = h_data + 12*i;
+      GLfloat packed[8] = { src[0], src[1], src[2], src[8],
+                            src[4], src[5], src[6], src[9] };
+      std::copy(packed, packed+8, h_data + 8*i);
+    }
+    const unsigned int floats_per_sphere = 8;
+#elif defined(SPHERES_TBO_QUANTIZED)
+    // 2 unsigned normalized 16-bit texels (16 bytes per sphere), decoded by
+    // texelFetch: (x,y,z,radius) relative to their bounds, (r,g,b,ao)
+    for (int c = 0; c < 4; ++c)
+    {
+      const unsigned int k = c < 3 ? c : 8;
+      float lo = h_data[k], hi = h_data[k];
+      for (unsigned int i = 1; i < TNumSpheres; ++i)
+      {
+        lo = std::min(lo, h_data[12*i + k]);
+        hi = std::max(hi, h_data[12*i + k]);
+      }
+      _quantizeOrigin[c] = lo;
+      _quantizeScale[c] = hi - lo;
+    }
+    std::vector<GLushort> quantized(8 * TNumSpheres);
+    for (unsigned int i = 0; i < TNumSpheres; ++i)
+    {
+      const GLfloat *src = h_data + 12*i;
+      const GLfloat values[8] = { src[0], src[1], src[2], src[8],
+                                  src[4], src[5], src[6], src[9] };
+      for (int c = 0; c < 8; ++c)
+      {
+        float t = values[c];
+        if (c < 4)
+          t = _quantizeScale[c] > 0.0f ? (t - _quantizeOrigin[c]) / _quantizeScale[c] : 0.0f;
+        quantized[8*i + c] = (GLushort) (65535.0f * std::min(std::max(t, 0.0f), 1.0f) + 0.5f);
+      }
     }
+#else
+    const unsigned int floats_per_sphere = 12;
+#endif
     ///
     glGenBuffers(1, &_tboData);
-    upload_buffer(_tboData, h_data, 12*TNumSpheres, GL_TEXTURE_BUFFER, GL_STATIC_DRAW);
     glGenTextures(1, &_tbo);
     glBindTexture(GL_TEXTURE_BUFFER, _tbo);
+#ifdef SPHERES_TBO_QUANTIZED
+    upload_buffer(_tboData, &quantized[0], 8*TNumSpheres, GL_TEXTURE_BUFFER, GL_STATIC_DRAW);
+    glTexBufferEXT(GL_TEXTURE_BUFFER, GL_RGBA16, _tboData);
+#else
+    upload_buffer(_tboData, h_data, floats_per_sphere*TNumSpheres, GL_TEXTURE_BUFFER, GL_STATIC_DRAW);
     glTexBufferEXT(GL_TEXTURE_BUFFER, GL_RGBA32F, _tboData);
+#endif
     glBindBuffer(GL_TEXTURE_BUFFER, 0);
 
     delete[] h_data;
@@ -227,6 +411,9 @@ void SpheresBillboardTBO<TNumSpheres>::cleanup()
 
   glDeleteBuffers(1, &_indexBuffer);
   _indexBuffer = 0;
+
+  glDeleteTextures(2, _positionTbo);
+  _positionTbo[0] = _positionTbo[1] = 0;
 }
 
 
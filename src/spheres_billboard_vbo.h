@@ -4,6 +4,15 @@
  * @brief Implementation of sphere rendering by billboards stored as VBOs.
  * @author Matthias Werner
  * @sa http://11235813tdd.blogspot.de/
+ * @date 2026/10/18: matchesHostSpheres() added.
+ * @date 2026/10/18: setScalars() and setScalarSource() added.
+ * @date 2026/10/18: supportsShadowPass() added.
+ * @date 2026/10/18: setDrawIndirect() added.
+ * @date 2026/10/18: supportsColormap() added.
+ * @date 2026/10/18: Clustered point lights (LIGHTS).
+ * @date 2026/10/18: supportsMultiView() added.
+ * @date 2026/10/18: Sphere alpha from the radius for TRANSPARENCY.
+ * @date 2026/10/18: Precomputed ambient occlusion attribute.
  * @date 2016/03/12: Initial commit.
  *****************************************************************************/
 #ifndef SPHERES_BILLBOARD_VBO_H_
@@ -13,6 +22,9 @@
 #include "shader.h"
 #include "gl_globals.h"
 #include "spheres.h"
+#include "clustered_lights.h"
+#include "frame_uniforms.h"
+#include "ambient_occlusion.h"
 
 #include <stdlib.h>
 #include <string>
@@ -34,6 +46,33 @@ class SpheresBillboardVBO : Spheres<SpheresBillboardVBO<TNumSpheres>, TNumSphere
     }
     int create(float radius_mean, float radius_var);
     int recompile();
+    void setDefine(const char* name, int value) { _shader.setDefine(name, value); }
+    const std::string& variant() const { return _shader.variant(); }
+    bool isImpostor() const { return true; }
+    bool supportsMultiView() const { return false; }
+    bool supportsColormap() const { return false; }
+    /// positions, colors and radii are generated in separate loops
+    bool matchesHostSpheres() const { return false; }
+    bool supportsShadowPass() const { return false; }
+    bool bindShadowPass(unsigned cascades) { return false; }
+    int setPositionSource(GLuint buffer, GLintptr offset,
+                          GLuint next_buffer = 0, GLintptr next_offset = 0) {
+      printf("Position streaming is not supported by this renderer.\n");
+      return 1;
+    }
+    void setPositionBlend(float blend) {}
+    int setScalars(const float* scalars) {
+      printf("Scalars are not supported by this renderer.\n");
+      return 1;
+    }
+    int setScalarSource(GLuint buffer, GLintptr offset) {
+      printf("Scalars are not supported by this renderer.\n");
+      return 1;
+    }
+    int setDrawIndirect(GLuint indices, GLuint command) {
+      printf("Indirect drawing of filtered spheres is not supported by this renderer.\n");
+      return 1;
+    }
     void bind(const float* lightPos, const Camera& camera);
     void operator()();
     void unbind();
@@ -53,8 +92,10 @@ int SpheresBillboardVBO<TNumSpheres>::loadShader()
   if (_shader.isLoaded())
       _shader.unload();
 
-  _shader.load("sphere_elem.vert", "sphere_elem.frag");
+  _shader.load("sphere_elem.vert", "sphere.frag");
 
+  _shader.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+  ClusteredLights::setBindings(_shader);
   int s = _shader.link();
   if (s)
   {
@@ -80,16 +121,14 @@ int SpheresBillboardVBO<TNumSpheres>::create(float radius_mean, float radius_var
 template<unsigned TNumSpheres>
 int SpheresBillboardVBO<TNumSpheres>::recompile()
 {
-  return loadShader();
+  // non-blocking, the current program is used until the new one is linked
+  return _shader.reload();
 }
 
 template<unsigned TNumSpheres>
 void SpheresBillboardVBO<TNumSpheres>::bind(const float* lightPos, const Camera& camera)
 {
   _shader.bind();
-  _shader.setUniformVar("lightPos", lightPos);
-  _shader.setUniformMat4("MVMatrix", (float*)camera.modelview());
-  _shader.setUniformMat4("PMatrix", (float*)camera.projection());
 }
 template<unsigned TNumSpheres>
 void SpheresBillboardVBO<TNumSpheres>::operator()()
@@ -110,11 +149,11 @@ template<unsigned TNumSpheres>
 int SpheresBillboardVBO<TNumSpheres>::createBuffers(float radius_mean, float radius_var)
 {
   srand(2013);
-  GLfloat *h_data = new GLfloat[44 * TNumSpheres];
+  GLfloat *h_data = new GLfloat[48 * TNumSpheres];
   const float a = -1.f, b = 1.f;
 
   ///// VERTEX
-  // data for each vertex (Pos1-4, Color1-4, Radius1-4, TexCoord1-4)
+  // data for each vertex (Pos1-4, Color1-4, Radius1-4, TexCoord1-4, AO1-4)
   unsigned int i = 0;
   while(i < 16*(TNumSpheres))
   {
@@ -151,6 +190,13 @@ int SpheresBillboardVBO<TNumSpheres>::createBuffers(float radius_mean, float rad
 
     i+=4;
   }
+  // alpha of the 4 color copies from the radius
+  for (unsigned int k = 0; k < TNumSpheres; ++k)
+  {
+    float alpha = sphereAlpha(h_data[32*TNumSpheres + 4*k], radius_mean, radius_var);
+    for (unsigned int c = 0; c < 4; ++c)
+      h_data[16*TNumSpheres + 16*k + 4*c + 3] = alpha;
+  }
   while(i < 44*(TNumSpheres))
   {
     h_data[i+0] = -1.0f;
@@ -167,11 +213,20 @@ int SpheresBillboardVBO<TNumSpheres>::createBuffers(float radius_mean, float rad
 
     i+=8;
   }
+  computeAmbientOcclusion(h_data, 16, h_data + 32*TNumSpheres, 4, h_data + i, 4, TNumSpheres);
+  while(i < 48*(TNumSpheres))
+  {
+    h_data[i+1]=h_data[i];
+    h_data[i+2]=h_data[i];
+    h_data[i+3]=h_data[i];
+
+    i+=4;
+  }
   ///
   if(!_vertexBuffer)
     glGenBuffers(1, &_vertexBuffer);
 
-  upload_buffer(_vertexBuffer, h_data, 44 * TNumSpheres, GL_ARRAY_BUFFER, GL_STATIC_DRAW);
+  upload_buffer(_vertexBuffer, h_data, 48 * TNumSpheres, GL_ARRAY_BUFFER, GL_STATIC_DRAW);
 
   delete[] h_data;
   h_data = 0;
@@ -209,10 +264,12 @@ int SpheresBillboardVBO<TNumSpheres>::createBuffers(float radius_mean, float rad
   glEnableVertexAttribArray(1); // color
   glEnableVertexAttribArray(2); // radius
   glEnableVertexAttribArray(3); // texcoord
+  glEnableVertexAttribArray(4); // ambient occlusion
   glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
   glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 0, (GLvoid*)(16*sizeof(GLfloat)*TNumSpheres));
   glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 0, (GLvoid*)(32*sizeof(GLfloat)*TNumSpheres));
   glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid*)(36*sizeof(GLfloat)*TNumSpheres));
+  glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, 0, (GLvoid*)(44*sizeof(GLfloat)*TNumSpheres));
   glBindVertexArray(0);
   glBindBuffer(GL_ARRAY_BUFFER, 0);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -4,6 +4,14 @@
  * @brief Implementation of sphere rendering by instancing sphere geometry.
  * @author Matthias Werner
  * @sa http://11235813tdd.blogspot.de/
+ * @date 2026/10/18: matchesHostSpheres() added.
+ * @date 2026/10/18: setScalars() and setScalarSource() added.
+ * @date 2026/10/18: supportsShadowPass() added.
+ * @date 2026/10/18: setDrawIndirect() added.
+ * @date 2026/10/18: supportsColormap() added.
+ * @date 2026/10/18: supportsMultiView() added.
+ * @date 2026/10/18: isImpostor() added.
+ * @date 2026/10/18: Precomputed ambient occlusion attribute.
  * @date 2016/03/12: Initial commit.
  *****************************************************************************/
 
@@ -15,6 +23,8 @@
 #include "shader.h"
 #include "gl_globals.h"
 #include "spheres.h"
+#include "frame_uniforms.h"
+#include "ambient_occlusion.h"
 
 #include <stdlib.h>
 #include <string>
@@ -36,6 +46,32 @@ class SpheresInstancing : Spheres<SpheresInstancing<TNumSpheres>, TNumSpheres>
     }
     int create(float radius_mean, float radius_var);
     int recompile();
+    void setDefine(const char* name, int value) { _shader.setDefine(name, value); }
+    const std::string& variant() const { return _shader.variant(); }
+    bool isImpostor() const { return false; }
+    bool supportsMultiView() const { return false; }
+    bool supportsColormap() const { return false; }
+    bool matchesHostSpheres() const { return true; }
+    bool supportsShadowPass() const { return false; }
+    bool bindShadowPass(unsigned cascades) { return false; }
+    int setPositionSource(GLuint buffer, GLintptr offset,
+                          GLuint next_buffer = 0, GLintptr next_offset = 0) {
+      printf("Position streaming is not supported by this renderer.\n");
+      return 1;
+    }
+    void setPositionBlend(float blend) {}
+    int setScalars(const float* scalars) {
+      printf("Scalars are not supported by this renderer.\n");
+      return 1;
+    }
+    int setScalarSource(GLuint buffer, GLintptr offset) {
+      printf("Scalars are not supported by this renderer.\n");
+      return 1;
+    }
+    int setDrawIndirect(GLuint indices, GLuint command) {
+      printf("Indirect drawing of filtered spheres is not supported by this renderer.\n");
+      return 1;
+    }
     void bind(const float* lightPos, const Camera& camera);
     void operator()();
     void unbind();
@@ -59,6 +95,8 @@ int SpheresInstancing<TNumSpheres>::loadShader()
 
   _shader.load("sphere_instanced.vert", "sphere_instanced.frag");
 
+  _shader.setUniformBlockBinding(FRAME_UNIFORM_BLOCK, FRAME_UNIFORM_BINDING);
+  _shader.setSamplerUnit("tboParams", 0);
   int s = _shader.link();
   if (s)
   {
@@ -84,7 +122,8 @@ int SpheresInstancing<TNumSpheres>::create(float radius_mean, float radius_var)
 template<unsigned TNumSpheres>
 int SpheresInstancing<TNumSpheres>::recompile()
 {
-  return loadShader();
+  // non-blocking, the current program is used until the new one is linked
+  return _shader.reload();
 }
 
 template<unsigned TNumSpheres>
@@ -93,9 +132,6 @@ void SpheresInstancing<TNumSpheres>::bind(const float* lightPos, const Camera& c
   glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_BUFFER_EXT, _tboParams);
   _shader.bind();
-  _shader.setUniformVar("tboParams", 0);
-  _shader.setUniformVar("lightPos", lightPos);
-  _shader.setUniformMat4("MVPMatrix", (float*)camera.mvpmatrix());
 }
 template<unsigned TNumSpheres>
 void SpheresInstancing<TNumSpheres>::operator()()
@@ -122,10 +158,10 @@ template<unsigned TNumSpheres>
 int SpheresInstancing<TNumSpheres>::createBuffers(float radius_mean, float radius_var)
 {
   srand(2013);
-  GLfloat *h_data = new GLfloat[9 * TNumSpheres];
+  GLfloat *h_data = new GLfloat[10 * TNumSpheres];
   const float a = -1.f, b = 1.f;
   ///// VERTEX
-  for (unsigned int i = 0; i < (9*TNumSpheres); i = i + 9)
+  for (unsigned int i = 0; i < (10*TNumSpheres); i = i + 10)
   {
     h_data[i] = mrand(a, b); // vertex.x
     h_data[i + 1] = mrand(a, b); // vertex.y
@@ -139,9 +175,10 @@ int SpheresInstancing<TNumSpheres>::createBuffers(float radius_mean, float radiu
 
     h_data[i + 8] = radius_var * rand() / RAND_MAX + radius_mean;
   }
+  computeAmbientOcclusion(h_data, 10, h_data+8, 10, h_data+9, 10, TNumSpheres);
   ///
   glGenBuffers(1, &_vertexBuffer);
-  upload_buffer(_vertexBuffer, h_data, 9 * TNumSpheres, GL_ARRAY_BUFFER, GL_STATIC_DRAW);
+  upload_buffer(_vertexBuffer, h_data, 10 * TNumSpheres, GL_ARRAY_BUFFER, GL_STATIC_DRAW);
   createTBO(&_tboParams, _vertexBuffer, GL_R32F, GL_TEXTURE0);
 
   delete[] h_data;
@@ -0,0 +1,356 @@
+/*****************************************************************************/
+/**
+ * Command line tool to create and inspect data files for the sphere
+ * renderers.
+ *
+ * @date 2026/10/18: Chunk files for out-of-core rendering.
+ * @date 2026/10/18: BVH construction and query benchmark.
+ * @date 2026/10/18: Thread pool scaling benchmark.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "chunk_file.h"
+#include "sphere_bvh.h"
+#include "thread_pool.h"
+#include "tools.h"
+#include "trajectory.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#define DEFAULT_SPHERES 100000
+#define DEFAULT_FRAMES 600
+/// random walk step per frame
+#define TRAJECTORY_STEP 0.002f
+/// elements of the thread pool benchmark loops
+#define POOL_BENCHMARK_SIZE (1u << 24)
+/// repetitions per thread count, the fastest counts
+#define POOL_BENCHMARK_RUNS 5
+/// radii as in the renderers
+#define RADIUS_MEAN 0.005f
+#define RADIUS_VAR 0.06f
+/// rays and range queries of the BVH benchmark
+#define BVH_BENCHMARK_QUERIES 100000
+/// spheres per grid cell of the chunk writer (on average)
+#define CHUNK_GRID_SPHERES (4 * CHUNK_SPHERES)
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void print_usage()
+{
+  printf("Usage:\n"
+      " spheres_shader_tool trajectory <file> [spheres] [frames] [keyframe interval]\n"
+      "\t writes a random walk trajectory (defaults: %u spheres, %u frames, keyframe every %u)\n"
+      " spheres_shader_tool info <file>\n"
+      "\t decodes all frames of a trajectory and reports the throughput\n"
+      " spheres_shader_tool pool [max threads]\n"
+      "\t measures thread pool scaling from 1 to all hardware threads\n"
+      " spheres_shader_tool bvh [spheres]\n"
+      "\t builds the picking BVH over the renderer's spheres and times queries\n"
+      " spheres_shader_tool chunks <file> [spheres]\n"
+      "\t writes spheres as in the renderers (any count) as chunk file for option -c\n",
+      DEFAULT_SPHERES, DEFAULT_FRAMES, TRAJECTORY_KEYFRAME_INTERVAL);
+}
+//-----------------------------------------------------------------------------
+// random walk inside [-1,1]^3, first frame as in the renderers
+//-----------------------------------------------------------------------------
+int writeTrajectory(const char* filename, unsigned spheres, unsigned frames,
+                    unsigned keyframe_interval)
+{
+  TrajectoryWriter writer;
+  if (writer.open(filename, spheres, keyframe_interval))
+    return 1;
+  srand(2013);
+  std::vector<float> positions(3 * spheres);
+  for (unsigned i = 0; i < 3 * spheres; ++i)
+    positions[i] = mrand(-1.f, 1.f);
+
+  for (unsigned f = 0; f < frames; ++f)
+  {
+    if (f > 0)
+    {
+      for (unsigned i = 0; i < 3 * spheres; ++i)
+      {
+        float p = positions[i] + mrand(-TRAJECTORY_STEP, TRAJECTORY_STEP);
+        positions[i] = p > 1.f ? 2.f - p : (p < -1.f ? -2.f - p : p);
+      }
+    }
+    if (writer.append(&positions[0]))
+      return 1;
+    if (f % 100 == 0)
+      printf("Frame %u/%u\r", f, frames);
+    fflush(stdout);
+  }
+  if (writer.close())
+    return 1;
+  printf("Written '%s': %u spheres, %u frames.\n", filename, spheres, frames);
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int infoTrajectory(const char* filename)
+{
+  TrajectoryReader reader;
+  if (reader.open(filename))
+    return 1;
+  std::vector<float> positions(3 * reader.numSpheres());
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (unsigned f = 0; f < reader.numFrames(); ++f)
+    if (reader.decode(f, &positions[0]))
+      return 1;
+  std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+  printf("'%s': %u spheres, %u frames, decoded at %.1lf frames/s.\n",
+         filename, reader.numSpheres(), reader.numFrames(),
+         reader.numFrames() / t.count());
+  return 0;
+}
+//-----------------------------------------------------------------------------
+// spheres as in the renderers, streamed through the chunk writer with bounded
+// memory (ambient occlusion is not precomputed)
+//-----------------------------------------------------------------------------
+int writeChunks(const char* filename, unsigned long long spheres)
+{
+  const float lower[3] = { -1.f, -1.f, -1.f }, upper[3] = { 1.f, 1.f, 1.f };
+  unsigned grid = (unsigned) ceil(cbrt((double) spheres / CHUNK_GRID_SPHERES));
+  ChunkWriter writer;
+  if (writer.open(filename, lower, upper, std::max(1u, grid)))
+    return 1;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  srand(2013);
+  for (unsigned long long i = 0; i < spheres; ++i)
+  {
+    ChunkSphere sphere;
+    sphere.x = mrand(-1.f, 1.f);
+    sphere.y = mrand(-1.f, 1.f);
+    sphere.z = mrand(-1.f, 1.f);
+    sphere.r = mrand(0.f, 1.f);
+    sphere.g = mrand(0.f, 1.f);
+    sphere.b = mrand(0.f, 1.f);
+    sphere.radius = RADIUS_VAR * rand() / RAND_MAX + RADIUS_MEAN;
+    sphere.ao = 1.0f;
+    if (writer.append(sphere))
+      return 1;
+  }
+  if (writer.close())
+    return 1;
+  std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+
+  ChunkReader reader;
+  if (reader.open(filename))
+    return 1;
+  unsigned long long total = 0;
+  for (unsigned c = 0; c < reader.numChunks(); ++c)
+    total += reader.chunk(c).count;
+  if (total != spheres || reader.numSpheres() != spheres)
+  {
+    printf("'%s': chunks hold %llu of %llu spheres.\n", filename, total, spheres);
+    return 1;
+  }
+  printf("Written '%s': %llu spheres in %u chunks (%u^3 grid) in %.1lf s.\n",
+         filename, spheres, reader.numChunks(), std::max(1u, grid), t.count());
+  return 0;
+}
+//-----------------------------------------------------------------------------
+// fastest of POOL_BENCHMARK_RUNS runs in ms
+//-----------------------------------------------------------------------------
+template<typename F>
+static double bestTime(F run)
+{
+  double best = 1e30;
+  for (unsigned r = 0; r < POOL_BENCHMARK_RUNS; ++r)
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double, std::milli> t = std::chrono::steady_clock::now() - start;
+    best = std::min(best, t.count());
+  }
+  return best;
+}
+//-----------------------------------------------------------------------------
+// compute bound loop, memory bound loop and a task graph of dependent
+// layers, each with 1 to max_threads threads
+//-----------------------------------------------------------------------------
+int benchmarkPool(unsigned max_threads)
+{
+  const unsigned n = POOL_BENCHMARK_SIZE;
+  std::vector<float> in(n), out(n);
+  for (unsigned i = 0; i < n; ++i)
+    in[i] = mrand(0.f, 1.f);
+  float* src = &in[0];
+  float* dst = &out[0];
+
+  // every iteration is expensive, little memory traffic
+  std::function<void(unsigned, unsigned)> compute = [=](unsigned first, unsigned last) {
+    for (unsigned i = first; i < last; i += 16)
+    {
+      float x = src[i];
+      for (unsigned k = 0; k < 32; ++k)
+        x = sqrtf(x * x + 0.5f) * 0.7f;
+      dst[i] = x;
+    }
+  };
+  // streams through 128 MB, bandwidth bound
+  std::function<void(unsigned, unsigned)> stream = [=](unsigned first, unsigned last) {
+    for (unsigned i = first; i < last; ++i)
+      dst[i] = src[i] * 2.0f + 1.0f;
+  };
+
+  printf("threads   compute (ms)      memory (ms)       task graph (ms)\n");
+  double base[3] = { 0.0, 0.0, 0.0 };
+  for (unsigned threads = 1; threads <= max_threads; ++threads)
+  {
+    ThreadPool pool(threads);
+    double t[3];
+    t[0] = bestTime([&]{ pool.parallelFor(0, n, 0, compute); });
+    t[1] = bestTime([&]{ pool.parallelFor(0, n, 0, stream); });
+
+    // 8 layers, each task depends on two neighbours of the previous layer
+    const unsigned width = 4 * threads, layers = 8;
+    const unsigned slice = n / (width * layers);
+    TaskGraph graph;
+    for (unsigned l = 0; l < layers; ++l)
+      for (unsigned k = 0; k < width; ++k)
+      {
+        unsigned first = (l * width + k) * slice;
+        TaskGraph::Task task = graph.add([=]{ compute(first, first + slice); });
+        if (l > 0)
+        {
+          graph.precede((l - 1) * width + k, task);
+          graph.precede((l - 1) * width + (k + 1) % width, task);
+        }
+      }
+    t[2] = bestTime([&]{ graph.run(pool); });
+
+    if (threads == 1)
+      std::copy(t, t + 3, base);
+    printf("%7u", threads);
+    for (unsigned b = 0; b < 3; ++b)
+      printf("   %8.2lf (%4.1lfx)", t[b], base[b] / t[b]);
+    printf("\n");
+  }
+  return 0;
+}
+//-----------------------------------------------------------------------------
+// BVH over the spheres of the renderers (extended to any count), queries
+// are checked against brute force on a subset
+//-----------------------------------------------------------------------------
+int benchmarkBVH(unsigned spheres)
+{
+  srand(2013);
+  std::vector<float> data(4 * spheres);
+  for (unsigned i = 0; i < spheres; ++i)
+  {
+    data[4 * i] = mrand(-1.f, 1.f);
+    data[4 * i + 1] = mrand(-1.f, 1.f);
+    data[4 * i + 2] = mrand(-1.f, 1.f);
+    mrand(0.f, 1.f); mrand(0.f, 1.f); mrand(0.f, 1.f); // color
+    data[4 * i + 3] = RADIUS_VAR * rand() / RAND_MAX + RADIUS_MEAN;
+  }
+  SphereBVH bvh;
+  // second build runs with warm pool and allocations
+  bvh.build(&data[0], 4, &data[3], 4, spheres);
+  bvh.build(&data[0], 4, &data[3], 4, spheres);
+
+  // rays from a sphere around the scene through random points inside
+  std::vector<glm::vec3> origins(BVH_BENCHMARK_QUERIES), directions(BVH_BENCHMARK_QUERIES);
+  for (unsigned q = 0; q < BVH_BENCHMARK_QUERIES; ++q)
+  {
+    glm::vec3 o(mrand(-1.f, 1.f), mrand(-1.f, 1.f), mrand(-1.f, 1.f));
+    origins[q] = 3.0f * glm::normalize(o);
+    glm::vec3 target(mrand(-1.f, 1.f), mrand(-1.f, 1.f), mrand(-1.f, 1.f));
+    directions[q] = glm::normalize(target - origins[q]);
+  }
+  std::vector<int> hits(BVH_BENCHMARK_QUERIES);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (unsigned q = 0; q < BVH_BENCHMARK_QUERIES; ++q)
+    hits[q] = bvh.pick(origins[q], directions[q]);
+  std::chrono::duration<double, std::micro> t_pick = std::chrono::steady_clock::now() - start;
+
+  std::vector<unsigned> result;
+  size_t found = 0;
+  start = std::chrono::steady_clock::now();
+  for (unsigned q = 0; q < BVH_BENCHMARK_QUERIES; ++q)
+  {
+    glm::vec3 c(mrand(-1.f, 1.f), mrand(-1.f, 1.f), mrand(-1.f, 1.f));
+    bvh.querySphere(c, 0.05f, &result);
+    found += result.size();
+  }
+  std::chrono::duration<double, std::micro> t_range = std::chrono::steady_clock::now() - start;
+  printf("Pick: %.3lf us/ray, sphere query (r=0.05): %.3lf us, %.1lf spheres avg.\n",
+         t_pick.count() / BVH_BENCHMARK_QUERIES, t_range.count() / BVH_BENCHMARK_QUERIES,
+         (double) found / BVH_BENCHMARK_QUERIES);
+
+  // brute force reference
+  unsigned errors = 0;
+  for (unsigned q = 0; q < 100; ++q)
+  {
+    float best = 1e30f;
+    int hit = -1;
+    for (unsigned i = 0; i < spheres; ++i)
+    {
+      glm::vec3 oc = origins[q] - glm::vec3(data[4 * i], data[4 * i + 1], data[4 * i + 2]);
+      float b = glm::dot(oc, directions[q]);
+      float disc = b * b - glm::dot(oc, oc) + data[4 * i + 3] * data[4 * i + 3];
+      if (disc >= 0.0f && -b - sqrtf(disc) >= 0.0f && -b - sqrtf(disc) < best)
+      {
+        best = -b - sqrtf(disc);
+        hit = (int) i;
+      }
+    }
+    if (hit != hits[q])
+      ++errors;
+  }
+  glm::vec3 lower(-0.2f, -0.1f, 0.0f), upper(0.1f, 0.2f, 0.3f);
+  bvh.queryBox(lower, upper, &result);
+  size_t box_count = 0;
+  for (unsigned i = 0; i < spheres; ++i)
+  {
+    glm::vec3 c(data[4 * i], data[4 * i + 1], data[4 * i + 2]);
+    glm::vec3 d = c - glm::clamp(c, lower, upper);
+    if (glm::dot(d, d) <= data[4 * i + 3] * data[4 * i + 3])
+      ++box_count;
+  }
+  if (box_count != result.size())
+    ++errors;
+  printf("Check against brute force: %s.\n", errors ? "FAILED" : "ok");
+  return errors ? 1 : 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  if (argc >= 3 && strcmp(argv[1], "trajectory") == 0)
+  {
+    unsigned spheres = argc > 3 ? (unsigned) atoi(argv[3]) : DEFAULT_SPHERES;
+    unsigned frames = argc > 4 ? (unsigned) atoi(argv[4]) : DEFAULT_FRAMES;
+    unsigned keyframes = argc > 5 ? (unsigned) atoi(argv[5]) : TRAJECTORY_KEYFRAME_INTERVAL;
+    return writeTrajectory(argv[2], spheres, frames, keyframes) ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+  if (argc >= 3 && strcmp(argv[1], "info") == 0)
+    return infoTrajectory(argv[2]) ? EXIT_FAILURE : EXIT_SUCCESS;
+  if (argc >= 2 && strcmp(argv[1], "pool") == 0)
+  {
+    unsigned threads = argc > 2 ? (unsigned) atoi(argv[2])
+                                : std::max(1u, std::thread::hardware_concurrency());
+    return benchmarkPool(std::max(1u, threads)) ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+  if (argc >= 2 && strcmp(argv[1], "bvh") == 0)
+  {
+    unsigned spheres = argc > 2 ? (unsigned) atoi(argv[2]) : DEFAULT_SPHERES;
+    return benchmarkBVH(std::max(1u, spheres)) ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+  if (argc >= 3 && strcmp(argv[1], "chunks") == 0)
+  {
+    unsigned long long spheres = argc > 3 ? strtoull(argv[3], NULL, 10) : DEFAULT_SPHERES;
+    return writeChunks(argv[2], std::max(1ull, spheres)) ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+  print_usage();
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,118 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Regions aligned for texture buffer ranges.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "streaming_buffer.h"
+
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+StreamingBuffer::StreamingBuffer()
+  : _buffer(0), _regionSize(0), _mapped(NULL), _region(0)
+{
+}
+StreamingBuffer::~StreamingBuffer()
+{
+  // GL objects are released by cleanup() while the context exists
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int StreamingBuffer::create(GLsizeiptr region_size)
+{
+  cleanup();
+  // regions may be bound as texture buffer ranges, which need aligned offsets
+  GLint alignment = 256;
+  if (GLEW_ARB_texture_buffer_range)
+    glGetIntegerv(GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  alignment = alignment > 0 ? alignment : 1;
+  _regionSize = (region_size + alignment - 1) / alignment * alignment;
+  _region = 0;
+  glGenBuffers(1, &_buffer);
+  glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+  if (GLEW_ARB_buffer_storage)
+  {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_ARRAY_BUFFER, STREAMING_BUFFER_REGIONS * _regionSize, NULL, flags);
+    _mapped = (unsigned char*) glMapBufferRange(GL_ARRAY_BUFFER, 0,
+                                                STREAMING_BUFFER_REGIONS * _regionSize, flags);
+    if (_mapped == NULL)
+    {
+      fprintf(stderr, "Could not map streaming buffer.\n");
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+      return 1;
+    }
+    _fences.assign(STREAMING_BUFFER_REGIONS, (GLsync) 0);
+  }
+  else
+  {
+    glBufferData(GL_ARRAY_BUFFER, _regionSize, NULL, GL_STREAM_DRAW);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  printf("Streaming buffer: %.1lf MB, %s.\n", _regionSize / 1048576.0,
+         _mapped ? "persistently mapped" : "orphaning");
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+GLintptr StreamingBuffer::upload(const void* data, GLsizeiptr size)
+{
+  if (size > _regionSize)
+    size = _regionSize;
+  if (_mapped)
+  {
+    _region = (_region + 1) % STREAMING_BUFFER_REGIONS;
+    // wait until the GPU has finished reading this region
+    if (_fences[_region])
+    {
+      glClientWaitSync(_fences[_region], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+      glDeleteSync(_fences[_region]);
+      _fences[_region] = 0;
+    }
+    GLintptr offset = _region * _regionSize;
+    memcpy(_mapped + offset, data, size);
+    return offset;
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+  glBufferData(GL_ARRAY_BUFFER, _regionSize, NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void StreamingBuffer::fence()
+{
+  if (!_mapped)
+    return;
+  if (_fences[_region])
+    glDeleteSync(_fences[_region]);
+  _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void StreamingBuffer::cleanup()
+{
+  for (size_t i = 0; i < _fences.size(); ++i)
+    if (_fences[i])
+      glDeleteSync(_fences[i]);
+  _fences.clear();
+  if (_mapped)
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    _mapped = NULL;
+  }
+  if (_buffer)
+    glDeleteBuffers(1, &_buffer);
+  _buffer = 0;
+}
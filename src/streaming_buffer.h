@@ -0,0 +1,55 @@
+/*****************************************************************************/
+/**
+ * @file streaming_buffer.h
+ * @brief Buffer for per-frame uploads (persistent mapping or orphaning).
+ * @date 2026/10/18: Regions aligned for texture buffer ranges.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef STREAMING_BUFFER_H_
+#define STREAMING_BUFFER_H_
+
+#include "gl_globals.h"
+
+#include <vector>
+
+/// regions of a persistently mapped buffer in flight
+#define STREAMING_BUFFER_REGIONS 3
+
+/**
+ * Uploads a block of data every frame without stalling on draws which still
+ * read the previous data.
+ * With ARB_buffer_storage the buffer is mapped persistently and split into
+ * regions, which are written round-robin and guarded by fences. Otherwise
+ * the storage is orphaned (glBufferData with NULL) before glBufferSubData.
+ */
+class StreamingBuffer
+{
+  public:
+    StreamingBuffer();
+    ~StreamingBuffer();
+    /**
+     * @param region_size largest upload in bytes
+     * @retval 0 on success
+     */
+    int create(GLsizeiptr region_size);
+    /**
+     * Copies data into the next region.
+     * @retval byte offset of the data in the buffer
+     */
+    GLintptr upload(const void* data, GLsizeiptr size);
+    /// to be called after the draws which read the last upload
+    void fence();
+    GLuint id() const { return _buffer; }
+    bool isPersistent() const { return _mapped != NULL; }
+    void cleanup();
+
+  private:
+    GLuint _buffer;
+    GLsizeiptr _regionSize;
+    unsigned char* _mapped;
+    unsigned _region;
+    std::vector<GLsync> _fences;
+};
+
+#endif /* STREAMING_BUFFER_H_ */
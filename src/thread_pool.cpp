@@ -0,0 +1,247 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "thread_pool.h"
+
+#include <algorithm>
+
+/// pool and queue index of the current worker thread
+static thread_local ThreadPool* t_pool = NULL;
+static thread_local unsigned t_index = 0;
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ThreadPool::ThreadPool(unsigned threads)
+  : _queued(0), _quit(false)
+{
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  _queues.resize(threads);
+  for (unsigned i = 0; i < threads; ++i)
+    _queues[i] = new Queue;
+  for (unsigned i = 1; i < threads; ++i)
+    _workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(_sleepMutex);
+    _quit = true;
+  }
+  _wake.notify_all();
+  for (size_t i = 0; i < _workers.size(); ++i)
+    _workers[i].join();
+  for (size_t i = 0; i < _queues.size(); ++i)
+  {
+    for (size_t k = 0; k < _queues[i]->tasks.size(); ++k)
+      delete _queues[i]->tasks[k];
+    delete _queues[i];
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ThreadPool& ThreadPool::global()
+{
+  static ThreadPool pool;
+  return pool;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ThreadPool::submit(const std::function<void()>& fn, std::atomic<int>* counter)
+{
+  Task* task = new Task;
+  task->fn = fn;
+  task->counter = counter;
+  // workers keep their own tasks local, others share queue 0
+  Queue* queue = _queues[t_pool == this ? t_index : 0];
+  {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->tasks.push_back(task);
+  }
+  ++_queued;
+  {
+    // pairs with the predicate check of sleeping workers (no lost wakeup)
+    std::lock_guard<std::mutex> lock(_sleepMutex);
+  }
+  _wake.notify_one();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+ThreadPool::Task* ThreadPool::findTask(int index)
+{
+  Task* task = NULL;
+  const unsigned n = (unsigned) _queues.size();
+  // own tasks first (newest), then the oldest tasks of the others
+  {
+    Queue* own = _queues[index];
+    std::lock_guard<std::mutex> lock(own->mutex);
+    if (!own->tasks.empty())
+    {
+      task = own->tasks.back();
+      own->tasks.pop_back();
+    }
+  }
+  for (unsigned k = 1; task == NULL && k < n; ++k)
+  {
+    Queue* victim = _queues[(index + k) % n];
+    std::lock_guard<std::mutex> lock(victim->mutex);
+    if (!victim->tasks.empty())
+    {
+      task = victim->tasks.front();
+      victim->tasks.pop_front();
+    }
+  }
+  if (task)
+    --_queued;
+  return task;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ThreadPool::execute(Task* task)
+{
+  task->fn();
+  if (task->counter)
+    --(*task->counter);
+  delete task;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ThreadPool::workerLoop(unsigned index)
+{
+  t_pool = this;
+  t_index = index;
+  for (;;)
+  {
+    Task* task = findTask(index);
+    if (task)
+    {
+      execute(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(_sleepMutex);
+    _wake.wait(lock, [this]{ return _quit || _queued > 0; });
+    if (_quit)
+      return;
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ThreadPool::wait(const std::atomic<int>& counter)
+{
+  const int index = t_pool == this ? (int) t_index : 0;
+  while (counter > 0)
+  {
+    Task* task = findTask(index);
+    if (task)
+      execute(task);
+    else
+      std::this_thread::yield();
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void ThreadPool::parallelFor(unsigned first, unsigned last, unsigned grain,
+                             const std::function<void(unsigned, unsigned)>& body)
+{
+  if (first >= last)
+    return;
+  const unsigned n = last - first;
+  if (grain == 0)
+    grain = std::max(1u, n / (4 * size()));
+  const unsigned chunks = (n + grain - 1) / grain;
+  if (chunks <= 1 || size() == 1)
+  {
+    body(first, last);
+    return;
+  }
+  std::atomic<int> counter(chunks - 1);
+  for (unsigned c = 1; c < chunks; ++c)
+  {
+    unsigned b = first + c * grain;
+    unsigned e = std::min(last, b + grain);
+    submit([&body, b, e]{ body(b, e); }, &counter);
+  }
+  body(first, std::min(last, first + grain));
+  wait(counter);
+}
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+TaskGraph::TaskGraph()
+  : _unfinished(0), _pool(NULL)
+{
+}
+TaskGraph::~TaskGraph()
+{
+  wait();
+  for (size_t i = 0; i < _nodes.size(); ++i)
+    delete _nodes[i];
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+TaskGraph::Task TaskGraph::add(const std::function<void()>& fn)
+{
+  Node* node = new Node;
+  node->fn = fn;
+  node->predecessors = 0;
+  node->pending = 0;
+  _nodes.push_back(node);
+  return (Task) (_nodes.size() - 1);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TaskGraph::precede(Task before, Task after)
+{
+  _nodes[before]->successors.push_back(after);
+  ++_nodes[after]->predecessors;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TaskGraph::start(ThreadPool& pool)
+{
+  wait();
+  _pool = &pool;
+  _unfinished = (int) _nodes.size();
+  for (size_t i = 0; i < _nodes.size(); ++i)
+    _nodes[i]->pending = _nodes[i]->predecessors;
+  for (size_t i = 0; i < _nodes.size(); ++i)
+    if (_nodes[i]->predecessors == 0)
+      schedule((Task) i);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TaskGraph::wait()
+{
+  if (_pool)
+    _pool->wait(_unfinished);
+}
+//-----------------------------------------------------------------------------
+// successors are queued before the task counts as finished
+//-----------------------------------------------------------------------------
+void TaskGraph::schedule(Task task)
+{
+  _pool->submit([this, task]{
+    Node* node = _nodes[task];
+    node->fn();
+    for (size_t s = 0; s < node->successors.size(); ++s)
+      if (--_nodes[node->successors[s]]->pending == 0)
+        schedule(node->successors[s]);
+  }, &_unfinished);
+}
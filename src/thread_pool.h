@@ -0,0 +1,115 @@
+/*****************************************************************************/
+/**
+ * @file thread_pool.h
+ * @brief Work-stealing thread pool with parallel-for and task graphs.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Work-stealing thread pool.
+ *
+ * Every worker owns a deque: it pushes and pops its own tasks at the back
+ * (LIFO, cache friendly), idle workers steal from the front of the other
+ * deques. Tasks submitted from other threads go to a shared queue.
+ * A thread waiting for tasks (parallelFor(), TaskGraph::wait()) executes
+ * pending tasks instead of blocking, so a pool of size n uses n-1 workers
+ * plus the calling thread.
+ */
+class ThreadPool
+{
+  public:
+    /**
+     * @param threads number of threads working on a parallelFor() including
+     *        the caller, 0 for all hardware threads
+     */
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+    /// pool with all hardware threads, shared by the application
+    static ThreadPool& global();
+    unsigned size() const { return (unsigned) _workers.size() + 1; }
+
+    /// queues a task, the counter (if any) is decremented when it is done
+    void submit(const std::function<void()>& fn, std::atomic<int>* counter = NULL);
+    /// runs pending tasks until counter is 0
+    void wait(const std::atomic<int>& counter);
+    /**
+     * Calls body(first, last) on subranges of [first,last) in parallel and
+     * returns when all are done.
+     * @param grain minimum subrange length, 0 chooses 4 chunks per thread
+     */
+    void parallelFor(unsigned first, unsigned last, unsigned grain,
+                     const std::function<void(unsigned, unsigned)>& body);
+
+  private:
+    struct Task
+    {
+      std::function<void()> fn;
+      std::atomic<int>* counter;
+    };
+    struct Queue
+    {
+      std::mutex mutex;
+      std::deque<Task*> tasks;
+    };
+    void workerLoop(unsigned index);
+    /// pops own work or steals, NULL if all queues are empty
+    Task* findTask(int index);
+    void execute(Task* task);
+
+  private:
+    std::vector<std::thread> _workers;
+    /// queue 0 takes tasks from threads outside the pool, 1..n are workers
+    std::vector<Queue*> _queues;
+    std::atomic<int> _queued;
+    std::mutex _sleepMutex;
+    std::condition_variable _wake;
+    bool _quit;
+};
+
+/**
+ * Tasks with dependencies. A task is queued once all its predecessors have
+ * finished. The graph can be started, overlapped with other work on the
+ * calling thread (e.g. GL calls), and waited for. Start it again to rerun.
+ */
+class TaskGraph
+{
+  public:
+    typedef unsigned Task;
+    TaskGraph();
+    ~TaskGraph();
+    Task add(const std::function<void()>& fn);
+    /// after does not start before before has finished
+    void precede(Task before, Task after);
+    void start(ThreadPool& pool);
+    void wait();
+    void run(ThreadPool& pool) { start(pool); wait(); }
+    unsigned size() const { return (unsigned) _nodes.size(); }
+
+  private:
+    struct Node
+    {
+      std::function<void()> fn;
+      std::vector<Task> successors;
+      int predecessors;
+      std::atomic<int> pending;
+    };
+    void schedule(Task task);
+
+  private:
+    std::vector<Node*> _nodes;
+    std::atomic<int> _unfinished;
+    ThreadPool* _pool;
+};
+
+#endif /* THREAD_POOL_H_ */
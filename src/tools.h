@@ -4,6 +4,9 @@
  * @brief Some functions such as time measurement and output stuff.
  * @author Matthias Werner
  * @sa http://11235813tdd.blogspot.de/
+ * @date 2026/10/18: sphereType() added.
+ * @date 2026/10/18: sphereScalar() added.
+ * @date 2026/10/18: sphereAlpha() added.
  * @date 2016/03/12: mrand() added.
  * @date 2013/04/26: Release.
  * @date 2013/04/02: Initial commit.
@@ -13,6 +16,7 @@
 #ifndef TOOLS_H_
 #define TOOLS_H_
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -57,4 +61,43 @@ inline float mrand(float a, float b)
   return (b - a) * r + a;
 }
 
+/**
+ * Opacity of a sphere for the TRANSPARENCY mode: the large spheres are the
+ * most translucent so they do not hide the small ones behind them.
+ * @param radius in [radius_mean, radius_mean+radius_var]
+ * @return alpha in [0.2,1]
+ */
+inline float sphereAlpha(float radius, float radius_mean, float radius_var)
+{
+  if (radius_var <= 0.0f)
+    return 1.0f;
+  return 1.0f - 0.8f * (radius - radius_mean) / radius_var;
+}
+
+/**
+ * Scalar attribute of the generated spheres for the transfer function, like
+ * a temperature falling off from the center of the volume.
+ * @return distance of the center from the origin, in [0, sqrt(3)] for [-1,1]^3
+ */
+inline float sphereScalar(float x, float y, float z)
+{
+  return sqrtf(x * x + y * y + z * z);
+}
+
+/// sphere types as a power of two, at most 32 (bits of the filter type mask)
+#define SPHERE_TYPE_BITS 3
+/// number of sphere types
+#define SPHERE_TYPES (1 << SPHERE_TYPE_BITS)
+static_assert(SPHERE_TYPE_BITS >= 1 && SPHERE_TYPE_BITS <= 5, "1 to 32 sphere types");
+/**
+ * Type of a generated sphere for filtering, a hash of its index so the
+ * random sequence of the generators is not changed.
+ * @return type in [0, SPHERE_TYPES)
+ */
+inline unsigned sphereType(unsigned index)
+{
+  // the top bits of the multiplicative hash are mixed best
+  return (index * 2654435761u) >> (32 - SPHERE_TYPE_BITS);
+}
+
 #endif
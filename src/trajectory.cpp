@@ -0,0 +1,339 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Quantization step per block, decode errors stop playback.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "trajectory.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#define TRAJECTORY_VERSION 2
+#define TRAJECTORY_DELTA_MAX 32767.0f
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+#define fseek64 _fseeki64
+#define ftell64 _ftelli64
+#else
+#define fseek64 fseeko
+#define ftell64 ftello
+#endif
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+TrajectoryWriter::TrajectoryWriter()
+  : _file(NULL)
+{
+  memset(&_header, 0, sizeof(_header));
+}
+TrajectoryWriter::~TrajectoryWriter()
+{
+  close();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int TrajectoryWriter::open(const char* filename, unsigned num_spheres,
+                           unsigned keyframe_interval)
+{
+  close();
+  _file = fopen(filename, "wb");
+  if (_file == NULL)
+  {
+    printf("Cannot open '%s' for writing.\n", filename);
+    return 1;
+  }
+  memset(&_header, 0, sizeof(_header));
+  memcpy(_header.magic, "SPTR", 4);
+  _header.version = TRAJECTORY_VERSION;
+  _header.num_spheres = num_spheres;
+  _header.keyframe_interval = std::max(1u, keyframe_interval);
+  _header.block_size = TRAJECTORY_BLOCK_SIZE;
+  _offsets.clear();
+  _last.assign(3 * num_spheres, 0.0f);
+  _steps.resize((num_spheres + TRAJECTORY_BLOCK_SIZE - 1) / TRAJECTORY_BLOCK_SIZE);
+  _deltas.resize(3 * num_spheres);
+  // header is completed by close()
+  if (fwrite(&_header, sizeof(_header), 1, _file) != 1)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int TrajectoryWriter::append(const float* positions)
+{
+  if (_file == NULL)
+    return 1;
+  const unsigned n = 3 * _header.num_spheres;
+  _offsets.push_back((unsigned long long) ftell64(_file));
+
+  if (_header.num_frames % _header.keyframe_interval == 0)
+  {
+    if (fwrite(positions, sizeof(float), n, _file) != n)
+      return 1;
+    std::copy(positions, positions + n, _last.begin());
+  }
+  else
+  {
+    const unsigned block = 3 * _header.block_size;
+    for (unsigned k = 0; k < _steps.size(); ++k)
+    {
+      const unsigned first = k * block, last = std::min(first + block, n);
+      float max_delta = 0.0f;
+      for (unsigned i = first; i < last; ++i)
+        max_delta = std::max(max_delta, fabsf(positions[i] - _last[i]));
+      const float step = max_delta > 0.0f ? max_delta / TRAJECTORY_DELTA_MAX : 1.0f;
+      for (unsigned i = first; i < last; ++i)
+      {
+        float d = floorf((positions[i] - _last[i]) / step + 0.5f);
+        d = std::min(std::max(d, -TRAJECTORY_DELTA_MAX), TRAJECTORY_DELTA_MAX);
+        _deltas[i] = (short) d;
+        _last[i] += _deltas[i] * step; // same as the decoder
+      }
+      _steps[k] = step;
+    }
+    if (fwrite(&_steps[0], sizeof(float), _steps.size(), _file) != _steps.size()
+        || fwrite(&_deltas[0], sizeof(short), n, _file) != n)
+      return 1;
+  }
+  ++_header.num_frames;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int TrajectoryWriter::close()
+{
+  if (_file == NULL)
+    return 0;
+  int err = 0;
+  _header.table_offset = (unsigned long long) ftell64(_file);
+  if (!_offsets.empty()
+      && fwrite(&_offsets[0], sizeof(unsigned long long), _offsets.size(), _file) != _offsets.size())
+    err = 1;
+  if (fseek64(_file, 0, SEEK_SET) != 0
+      || fwrite(&_header, sizeof(_header), 1, _file) != 1)
+    err = 1;
+  fclose(_file);
+  _file = NULL;
+  if (err)
+    printf("Error writing trajectory.\n");
+  return err;
+}
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+TrajectoryReader::TrajectoryReader()
+  : _file(NULL), _decoded(-1)
+{
+  memset(&_header, 0, sizeof(_header));
+}
+TrajectoryReader::~TrajectoryReader()
+{
+  close();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int TrajectoryReader::open(const char* filename)
+{
+  close();
+  _file = fopen(filename, "rb");
+  if (_file == NULL)
+  {
+    printf("Cannot open trajectory '%s'.\n", filename);
+    return 1;
+  }
+  if (fread(&_header, sizeof(_header), 1, _file) != 1
+      || memcmp(_header.magic, "SPTR", 4) != 0
+      || _header.version != TRAJECTORY_VERSION || _header.block_size == 0
+      || _header.num_spheres == 0 || _header.num_frames == 0 || _header.keyframe_interval == 0)
+  {
+    printf("'%s' is not a valid trajectory file.\n", filename);
+    close();
+    return 1;
+  }
+  _offsets.resize(_header.num_frames);
+  if (fseek64(_file, (long long) _header.table_offset, SEEK_SET) != 0
+      || fread(&_offsets[0], sizeof(unsigned long long), _offsets.size(), _file) != _offsets.size())
+  {
+    printf("'%s': frame table is truncated.\n", filename);
+    close();
+    return 1;
+  }
+  _current.resize(3 * _header.num_spheres);
+  _steps.resize((_header.num_spheres + _header.block_size - 1) / _header.block_size);
+  _deltas.resize(3 * _header.num_spheres);
+  _decoded = -1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TrajectoryReader::close()
+{
+  if (_file)
+    fclose(_file);
+  _file = NULL;
+  _decoded = -1;
+}
+//-----------------------------------------------------------------------------
+// decodes frame into _current, which has to hold frame-1 for delta frames
+//-----------------------------------------------------------------------------
+int TrajectoryReader::readFrame(unsigned frame)
+{
+  const unsigned n = 3 * _header.num_spheres;
+  if (fseek64(_file, (long long) _offsets[frame], SEEK_SET) != 0)
+    return 1;
+  if (frame % _header.keyframe_interval == 0)
+  {
+    if (fread(&_current[0], sizeof(float), n, _file) != n)
+      return 1;
+  }
+  else
+  {
+    if (fread(&_steps[0], sizeof(float), _steps.size(), _file) != _steps.size()
+        || fread(&_deltas[0], sizeof(short), n, _file) != n)
+      return 1;
+    const unsigned block = 3 * _header.block_size;
+    for (unsigned i = 0; i < n; ++i)
+      _current[i] += _deltas[i] * _steps[i / block];
+  }
+  _decoded = (int) frame;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int TrajectoryReader::decode(unsigned frame, float* positions)
+{
+  if (_file == NULL || frame >= _header.num_frames)
+    return 1;
+  unsigned next = frame - frame % _header.keyframe_interval;
+  // continue from the current frame if no keyframe lies in between
+  if (_decoded >= (int) next && _decoded <= (int) frame)
+    next = (unsigned) _decoded + 1;
+  for (; next <= frame; ++next)
+  {
+    if (readFrame(next))
+    {
+      printf("Error reading trajectory frame %u.\n", next);
+      _decoded = -1;
+      return 1;
+    }
+  }
+  std::copy(_current.begin(), _current.end(), positions);
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+TrajectoryPlayer::TrajectoryPlayer()
+  : _head(0), _count(0), _stalls(0), _quit(false), _failed(false)
+{
+}
+TrajectoryPlayer::~TrajectoryPlayer()
+{
+  close();
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int TrajectoryPlayer::open(const char* filename, unsigned prefetch)
+{
+  close();
+  if (_reader.open(filename))
+    return 1;
+  prefetch = std::max(2u, prefetch);
+  _slots.assign(prefetch, std::vector<float>(3 * _reader.numSpheres()));
+  _slotFrame.assign(prefetch, 0);
+  _head = _count = _stalls = 0;
+  _quit = false;
+  _failed = false;
+  _thread = std::thread(&TrajectoryPlayer::decodeLoop, this);
+  printf("Trajectory '%s': %u spheres, %u frames, %u frames prefetched.\n",
+         filename, _reader.numSpheres(), _reader.numFrames(), prefetch);
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TrajectoryPlayer::close()
+{
+  if (!_thread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _quit = true;
+  }
+  _cond.notify_all();
+  _thread.join();
+  _reader.close();
+  _failed = false;
+}
+//-----------------------------------------------------------------------------
+// decoder thread, fills the slots behind the consumer, loops the trajectory
+//-----------------------------------------------------------------------------
+void TrajectoryPlayer::decodeLoop()
+{
+  const unsigned size = (unsigned) _slots.size();
+  unsigned frame = 0;
+  for (;;)
+  {
+    unsigned tail;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _cond.wait(lock, [this, size]{ return _quit || _count < size; });
+      if (_quit)
+        return;
+      tail = (_head + _count) % size;
+    }
+    // the slot is not visible to the consumer until _count is increased
+    if (_reader.decode(frame, &_slots[tail][0]))
+    {
+      _failed = true;
+      return;
+    }
+    _slotFrame[tail] = frame;
+    frame = (frame + 1) % _reader.numFrames();
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      ++_count;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+const float* TrajectoryPlayer::acquire(unsigned* frame)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_count == 0)
+  {
+    if (!_failed)
+      ++_stalls;
+    return NULL;
+  }
+  if (frame)
+    *frame = _slotFrame[_head];
+  return &_slots[_head][0];
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TrajectoryPlayer::release()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_count == 0)
+      return;
+    _head = (_head + 1) % _slots.size();
+    --_count;
+  }
+  _cond.notify_one();
+}
@@ -0,0 +1,168 @@
+/*****************************************************************************/
+/**
+ * @file trajectory.h
+ * @brief Trajectory container with keyframes and quantized deltas, and a
+ * background decoder for playback.
+ * @date 2026/10/18: Quantization step per block, decode errors stop playback.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef TRAJECTORY_H_
+#define TRAJECTORY_H_
+
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// number of frames decoded ahead of playback
+#ifndef TRAJECTORY_PREFETCH
+#define TRAJECTORY_PREFETCH 4
+#endif
+#define TRAJECTORY_KEYFRAME_INTERVAL 32
+/// spheres sharing a quantization step in delta frames
+#define TRAJECTORY_BLOCK_SIZE 1024
+
+/**
+ * File layout (little endian):
+ *  header   TrajectoryHeader
+ *  frames   keyframe: float x,y,z per sphere
+ *           delta:    float step per block of block_size spheres,
+ *                     int16 dx,dy,dz per sphere
+ *  table    uint64 file offset per frame (at header.table_offset)
+ * Every keyframe_interval-th frame is a keyframe. Deltas refer to the
+ * previous decoded frame (the writer quantizes against its own
+ * reconstruction, so errors do not accumulate), position = previous + d*step.
+ * The step of a block follows its largest delta, so a single fast sphere
+ * does not coarsen the deltas of all others.
+ */
+struct TrajectoryHeader
+{
+  char magic[4]; // "SPTR"
+  unsigned version;
+  unsigned num_spheres;
+  unsigned num_frames;
+  unsigned keyframe_interval;
+  unsigned block_size;
+  unsigned long long table_offset;
+};
+
+/**
+ * Writes trajectory files frame by frame.
+ */
+class TrajectoryWriter
+{
+  public:
+    TrajectoryWriter();
+    ~TrajectoryWriter();
+    /**
+     * @param filename output file
+     * @param num_spheres spheres per frame
+     * @param keyframe_interval distance of keyframes in frames
+     * @retval 0 on success
+     */
+    int open(const char* filename, unsigned num_spheres,
+             unsigned keyframe_interval = TRAJECTORY_KEYFRAME_INTERVAL);
+    /**
+     * @param positions x,y,z per sphere
+     * @retval 0 on success
+     */
+    int append(const float* positions);
+    /// writes the frame table and completes the header
+    int close();
+
+  private:
+    FILE* _file;
+    TrajectoryHeader _header;
+    std::vector<unsigned long long> _offsets;
+    std::vector<float> _last; ///< reconstruction of the previous frame
+    std::vector<float> _steps;
+    std::vector<short> _deltas;
+};
+
+/**
+ * Decodes frames of a trajectory file (sequential access is cheapest,
+ * otherwise decoding starts at the preceding keyframe).
+ */
+class TrajectoryReader
+{
+  public:
+    TrajectoryReader();
+    ~TrajectoryReader();
+    int open(const char* filename);
+    void close();
+    /**
+     * @param frame frame index
+     * @param[out] positions x,y,z per sphere
+     * @retval 0 on success
+     */
+    int decode(unsigned frame, float* positions);
+    unsigned numSpheres() const { return _header.num_spheres; }
+    unsigned numFrames() const { return _header.num_frames; }
+
+  private:
+    int readFrame(unsigned frame);
+
+  private:
+    FILE* _file;
+    TrajectoryHeader _header;
+    std::vector<unsigned long long> _offsets;
+    std::vector<float> _current; ///< last decoded frame
+    std::vector<float> _steps;
+    std::vector<short> _deltas;
+    int _decoded; ///< index of _current, -1 if none
+};
+
+/**
+ * Plays a trajectory in a loop. A background thread decodes up to
+ * TRAJECTORY_PREFETCH frames ahead into a ring of staging buffers,
+ * the render loop takes them with acquire()/release() without blocking.
+ */
+class TrajectoryPlayer
+{
+  public:
+    TrajectoryPlayer();
+    ~TrajectoryPlayer();
+    /**
+     * @param filename trajectory file
+     * @param prefetch size of the frame ring
+     * @retval 0 on success
+     */
+    int open(const char* filename, unsigned prefetch = TRAJECTORY_PREFETCH);
+    void close();
+    /// false once decoding has failed, close() the player then
+    bool isOpen() const { return _thread.joinable() && !_failed; }
+    /// true if the decoder has stopped on a read error
+    bool hasFailed() const { return _failed; }
+    /**
+     * @param[out] frame index of the returned frame (optional)
+     * @return positions (x,y,z per sphere) of the next frame, NULL if the
+     *         decoder has not finished it yet or has failed
+     */
+    const float* acquire(unsigned* frame = NULL);
+    /// returns the acquired frame to the decoder
+    void release();
+    unsigned numSpheres() const { return _reader.numSpheres(); }
+    unsigned numFrames() const { return _reader.numFrames(); }
+    /// number of acquire() calls which found no decoded frame
+    unsigned stalls() const { return _stalls; }
+
+  private:
+    void decodeLoop();
+
+  private:
+    TrajectoryReader _reader;
+    std::vector<std::vector<float> > _slots;
+    std::vector<unsigned> _slotFrame;
+    unsigned _head, _count;
+    unsigned _stalls;
+    bool _quit;
+    std::atomic<bool> _failed;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::thread _thread;
+};
+
+#endif /* TRAJECTORY_H_ */
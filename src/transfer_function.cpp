@@ -0,0 +1,164 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "transfer_function.h"
+
+#include <algorithm>
+#include <cmath>
+
+/// control points of the built-in tables
+static const struct
+{
+  const char* name;
+  unsigned count;
+  float colors[11][3];
+} colormapPresets[] = {
+  { "viridis", 11, { { 0.267f, 0.005f, 0.329f }, { 0.283f, 0.141f, 0.458f },
+                     { 0.254f, 0.265f, 0.530f }, { 0.207f, 0.372f, 0.553f },
+                     { 0.164f, 0.471f, 0.558f }, { 0.128f, 0.567f, 0.551f },
+                     { 0.135f, 0.659f, 0.518f }, { 0.267f, 0.749f, 0.441f },
+                     { 0.478f, 0.821f, 0.318f }, { 0.741f, 0.873f, 0.150f },
+                     { 0.993f, 0.906f, 0.144f } } },
+  // Moreland, Diverging Color Maps for Scientific Visualization, 2009
+  { "cool to warm", 3, { { 0.230f, 0.299f, 0.754f }, { 0.865f, 0.865f, 0.865f },
+                         { 0.706f, 0.016f, 0.150f } } },
+  { "rainbow", 5, { { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 1.0f }, { 0.0f, 1.0f, 0.0f },
+                    { 1.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } } },
+  { "grayscale", 2, { { 0.1f, 0.1f, 0.1f }, { 1.0f, 1.0f, 1.0f } } }
+};
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+TransferFunction::TransferFunction()
+  : _buffer(0), _texture(0), _preset(0), _min(0.0f), _max(1.0f)
+{
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int TransferFunction::create()
+{
+  glGenBuffers(1, &_buffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(ColormapData), NULL, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, COLORMAP_UNIFORM_BINDING, _buffer);
+
+  glGenTextures(1, &_texture);
+  glBindTexture(GL_TEXTURE_1D, _texture);
+  glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA8, COLORMAP_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+  glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_1D, 0);
+
+  setPreset(0);
+  setRange(_min, _max);
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TransferFunction::setBindings(ShaderManager& shader)
+{
+  shader.setUniformBlockBinding(COLORMAP_UNIFORM_BLOCK, COLORMAP_UNIFORM_BINDING);
+  shader.setSamplerUnit("Colormap", COLORMAP_TEXTURE_UNIT);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+unsigned TransferFunction::presets()
+{
+  return sizeof(colormapPresets) / sizeof(colormapPresets[0]);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+const char* TransferFunction::presetName(unsigned preset)
+{
+  return preset < presets() ? colormapPresets[preset].name : "";
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TransferFunction::setPreset(unsigned preset)
+{
+  _preset = std::min(preset, presets() - 1);
+  std::vector<glm::vec3> colors(colormapPresets[_preset].count);
+  for (size_t i = 0; i < colors.size(); ++i)
+  {
+    const float* c = colormapPresets[_preset].colors[i];
+    colors[i] = glm::vec3(c[0], c[1], c[2]);
+  }
+  setTable(colors);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TransferFunction::setTable(const std::vector<glm::vec3>& colors)
+{
+  if (colors.empty())
+    return;
+  std::vector<GLubyte> texels(4 * COLORMAP_SIZE);
+  for (unsigned t = 0; t < COLORMAP_SIZE; ++t)
+  {
+    // piecewise linear between the control points
+    const float x = (float) t / (COLORMAP_SIZE - 1) * (colors.size() - 1);
+    const size_t i = std::min((size_t) x, colors.size() - 1);
+    const size_t j = std::min(i + 1, colors.size() - 1);
+    const float f = x - (float) i;
+    const glm::vec3 color = colors[i] * (1.0f - f) + colors[j] * f;
+    for (int c = 0; c < 3; ++c)
+      texels[4 * t + c] = (GLubyte) std::floor(255.0f * std::min(std::max(color[c], 0.0f), 1.0f) + 0.5f);
+    texels[4 * t + 3] = 255;
+  }
+  glBindTexture(GL_TEXTURE_1D, _texture);
+  glTexSubImage1D(GL_TEXTURE_1D, 0, 0, COLORMAP_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, &texels[0]);
+  glBindTexture(GL_TEXTURE_1D, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TransferFunction::setRange(float min, float max)
+{
+  _min = min;
+  _max = max;
+  ColormapData data;
+  // scalar to [0,1], then to the texel centers of the first and last texel
+  data.range = glm::vec4(_min, _max != _min ? 1.0f / (_max - _min) : 0.0f,
+                         (COLORMAP_SIZE - 1.0f) / COLORMAP_SIZE, 0.5f / COLORMAP_SIZE);
+  glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ColormapData), &data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TransferFunction::bind()
+{
+  glActiveTexture(GL_TEXTURE0 + COLORMAP_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_1D, _texture);
+  glActiveTexture(GL_TEXTURE0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TransferFunction::unbind()
+{
+  glActiveTexture(GL_TEXTURE0 + COLORMAP_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_1D, 0);
+  glActiveTexture(GL_TEXTURE0);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void TransferFunction::cleanup()
+{
+  glDeleteTextures(1, &_texture);
+  glDeleteBuffers(1, &_buffer);
+  _texture = _buffer = 0;
+}
@@ -0,0 +1,72 @@
+/*****************************************************************************/
+/**
+ * @file transfer_function.h
+ * @brief Colors of a per-sphere scalar from a 1D transfer function texture.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef TRANSFER_FUNCTION_H_
+#define TRANSFER_FUNCTION_H_
+
+#include "gl_globals.h"
+#include "shader.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+/// name of the uniform block in the shaders
+#define COLORMAP_UNIFORM_BLOCK "ColormapData"
+/// uniform buffer binding point of the ColormapData block
+#define COLORMAP_UNIFORM_BINDING 4
+/// texture unit of the transfer function (sampler1D)
+#define COLORMAP_TEXTURE_UNIT 8
+/// texels of the transfer function
+#define COLORMAP_SIZE 256
+
+/// memory layout of the ColormapData uniform block (std140) in shader/common.glsl
+struct ColormapData
+{
+  glm::vec4 range;
+};
+
+/**
+ * Transfer function of the per-sphere scalar attribute. With the shader
+ * define COLORMAP=1, the vertex shaders of the renderers that store a scalar
+ * (location 5) replace the sphere color by the texel of the normalized
+ * scalar, the sphere alpha is kept.
+ *
+ * The color table is a COLORMAP_SIZE texel GL_TEXTURE_1D (1 KB), the scalar
+ * range is a 16 byte uniform block. Neither touches the sphere buffers, so
+ * recoloring by another range or table costs no re-upload.
+ */
+class TransferFunction
+{
+  public:
+    TransferFunction();
+    int create();
+    /// sets the uniform block and the texture unit of a shader
+    static void setBindings(ShaderManager& shader);
+    /// number of built-in tables
+    static unsigned presets();
+    static const char* presetName(unsigned preset);
+    /// uploads a built-in table
+    void setPreset(unsigned preset);
+    unsigned preset() const { return _preset; }
+    /// uploads a table, control points are spread evenly over the range
+    void setTable(const std::vector<glm::vec3>& colors);
+    /// scalars at the first and the last texel, values outside are clamped
+    void setRange(float min, float max);
+    float rangeMin() const { return _min; }
+    float rangeMax() const { return _max; }
+    /// binds the table to COLORMAP_TEXTURE_UNIT
+    void bind();
+    void unbind();
+    void cleanup();
+
+  private:
+    GLuint _buffer, _texture;
+    unsigned _preset;
+    float _min, _max;
+};
+
+#endif /* TRANSFER_FUNCTION_H_ */
@@ -0,0 +1,129 @@
+/*****************************************************************************/
+/**
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+#include "weighted_oit.h"
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+WeightedOIT::WeightedOIT()
+  : _vertexArray(0), _previous(0)
+{
+  _frames[0] = _frames[1] = 0;
+  _sum[0] = _sum[1] = 0.0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int WeightedOIT::create()
+{
+  if (!GLEW_ARB_draw_buffers_blend)
+  {
+    printf("Transparency needs ARB_draw_buffers_blend.\n");
+    return 1;
+  }
+  // full screen triangle from gl_VertexID
+  glGenVertexArrays(1, &_vertexArray);
+  _shader.load("upscale.vert", "oit_composite.frag");
+  _shader.setSamplerUnit("Accum", 0);
+  _shader.setSamplerUnit("Revealage", 1);
+  if (_shader.link())
+  {
+    printf("Error occurred.\n");
+    return 1;
+  }
+  if (CHECK_GLERROR() != GL_NO_ERROR)
+    return 1;
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+int WeightedOIT::bind(int width, int height)
+{
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &_previous);
+  if (_target.id() == 0)
+  {
+    std::vector<GLenum> formats;
+    formats.push_back(GL_RGBA16F);
+    formats.push_back(GL_R8);
+    if (_target.create(width, height, formats, false) != 0)
+      return 1;
+  }
+  else if (_target.resize(width, height) != 0)
+    return 1;
+  _target.bind();
+  const GLfloat accum[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+  const GLfloat revealage[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+  glClearBufferfv(GL_COLOR, 0, accum);
+  glClearBufferfv(GL_COLOR, 1, revealage);
+
+  glDisable(GL_DEPTH_TEST);
+  glDepthMask(GL_FALSE);
+  glEnable(GL_BLEND);
+  glBlendFunciARB(0, GL_ONE, GL_ONE);
+  glBlendFunciARB(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+  return 0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void WeightedOIT::composite()
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, _previous);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, _target.texture(0));
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, _target.texture(1));
+  _shader.bind();
+  glBindVertexArray(_vertexArray);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+  glBindVertexArray(0);
+  _shader.unbind();
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glDisable(GL_BLEND);
+  glDepthMask(GL_TRUE);
+  glEnable(GL_DEPTH_TEST);
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void WeightedOIT::record(bool transparent, double frame_ms)
+{
+  if (frame_ms < 0.0)
+    return;
+  ++_frames[transparent];
+  _sum[transparent] += frame_ms;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void WeightedOIT::report()
+{
+  if (_frames[1] == 0)
+    return;
+  double transparent = _sum[1] / _frames[1];
+  if (_frames[0] > 0)
+  {
+    double opaque = _sum[0] / _frames[0];
+    printf("Transparency: %.3f ms (%u frames), opaque %.3f ms (%u frames), x%.2f\n",
+           transparent, _frames[1], opaque, _frames[0], transparent / opaque);
+  }
+  else
+    printf("Transparency: %.3f ms (%u frames), no opaque frames\n", transparent, _frames[1]);
+  _frames[0] = _frames[1] = 0;
+  _sum[0] = _sum[1] = 0.0;
+}
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+void WeightedOIT::cleanup()
+{
+  _target.cleanup();
+  glDeleteVertexArrays(1, &_vertexArray);
+  _vertexArray = 0;
+}
@@ -0,0 +1,56 @@
+/*****************************************************************************/
+/**
+ * @file weighted_oit.h
+ * @brief Weighted blended order-independent transparency.
+ * @sa McGuire, Bavoil: Weighted Blended Order-Independent Transparency, JCGT 2013.
+ * @date 2026/10/18: Initial commit.
+ *****************************************************************************/
+
+#ifndef WEIGHTED_OIT_H_
+#define WEIGHTED_OIT_H_
+
+#include "gl_globals.h"
+#include "framebuffer.h"
+#include "shader.h"
+
+/**
+ * Translucent spheres without sorting. With the shader define TRANSPARENCY=1
+ * sphere.frag writes its depth weighted, premultiplied color to an RGBA16F
+ * accumulation target (additive blending) and its opacity to an R8
+ * revealage target (multiplied by 1 - alpha). The opacity is derived from
+ * the sphere alpha and the analytic thickness at the fragment.
+ * composite() resolves the weighted average over the previously bound
+ * framebuffer in a full screen pass.
+ *
+ * Needs ARB_draw_buffers_blend (GL 4.0) for the per-target blend functions.
+ * Frame times of transparent and opaque frames are kept for comparison.
+ */
+class WeightedOIT
+{
+  public:
+    WeightedOIT();
+    /// @retval 0 on success, 1 if not supported
+    int create();
+    bool isCreated() const { return _vertexArray != 0; }
+    /// binds the accumulation targets, sets blending, no depth test and writes
+    int bind(int width, int height);
+    /// blends the resolved layers over the framebuffer bound before bind()
+    void composite();
+    int recompile() { return _shader.reload(); }
+    /// adds the GPU time of a transparent or opaque frame
+    void record(bool transparent, double frame_ms);
+    /// prints and resets the statistics if there were transparent frames
+    void report();
+    void cleanup();
+
+  private:
+    Framebuffer _target;
+    ShaderManager _shader;
+    GLuint _vertexArray;
+    GLint _previous;
+    // statistics since the last report(), [0] opaque, [1] transparent
+    unsigned _frames[2];
+    double _sum[2];
+};
+
+#endif /* WEIGHTED_OIT_H_ */